@@ -8,11 +8,13 @@
 #include "Bots/ShooterAIController.h"
 #include "Bots/ShooterBot.h"
 #include "Pickups/ShooterPickup_Ammo.h"
+#include "Pickups/ShooterPickupIndex.h"
 #include "Weapons/ShooterWeapon_Instant.h"
 
 UBTTask_FindPickup::UBTTask_FindPickup(const FObjectInitializer& ObjectInitializer) 
 	: Super(ObjectInitializer)
 {
+	bUsePathCost = false;
 }
 
 EBTNodeResult::Type UBTTask_FindPickup::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
@@ -24,29 +26,19 @@ EBTNodeResult::Type UBTTask_FindPickup::ExecuteTask(UBehaviorTreeComponent& Owne
 		return EBTNodeResult::Failed;
 	}
 
-	AShooterGameMode* GameMode = MyBot->GetWorld()->GetAuthGameMode<AShooterGameMode>();
-	if (GameMode == NULL)
+	UShooterPickupIndex* PickupIndex = MyBot->GetWorld()->GetSubsystem<UShooterPickupIndex>();
+	if (PickupIndex == NULL)
 	{
 		return EBTNodeResult::Failed;
 	}
 
-	const FVector MyLoc = MyBot->GetActorLocation();
-	AShooterPickup_Ammo* BestPickup = NULL;
-	float BestDistSq = MAX_FLT;
+	FShooterPickupQuery Query;
+	Query.PickupClass = AShooterPickup_Ammo::StaticClass();
+	Query.WeaponClass = AShooterWeapon_Instant::StaticClass();
+	Query.Pawn = MyBot;
+	Query.bUsePathCost = bUsePathCost;
 
-	for (int32 i = 0; i < GameMode->LevelPickups.Num(); ++i)
-	{
-		AShooterPickup_Ammo* AmmoPickup = Cast<AShooterPickup_Ammo>(GameMode->LevelPickups[i]);
-		if (AmmoPickup && AmmoPickup->IsForWeapon(AShooterWeapon_Instant::StaticClass()) && AmmoPickup->CanBePickedUp(MyBot))
-		{
-			const float DistSq = (AmmoPickup->GetActorLocation() - MyLoc).SizeSquared();
-			if (BestDistSq == -1 || DistSq < BestDistSq)
-			{
-				BestDistSq = DistSq;
-				BestPickup = AmmoPickup;
-			}
-		}
-	}
+	AShooterPickup* BestPickup = PickupIndex->FindNearest(MyBot->GetActorLocation(), Query);
 
 	if (BestPickup)
 	{
@@ -6,7 +6,7 @@
 #include "BehaviorTree/BehaviorTreeComponent.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyAllTypes.h"
-#include "NavigationSystem.h"
+#include "Bots/ShooterNavQueryService.h"
 
 
 UBTTask_FindPointNearEnemy::UBTTask_FindPointNearEnemy(const FObjectInitializer& ObjectInitializer) 
@@ -17,7 +17,8 @@ UBTTask_FindPointNearEnemy::UBTTask_FindPointNearEnemy(const FObjectInitializer&
 EBTNodeResult::Type UBTTask_FindPointNearEnemy::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
 {
 	AShooterAIController* MyController = Cast<AShooterAIController>(OwnerComp.GetAIOwner());
-	if (MyController == NULL)
+	UShooterNavQueryService* NavQueries = OwnerComp.GetWorld()->GetSubsystem<UShooterNavQueryService>();
+	if (MyController == NULL || NavQueries == NULL)
 	{
 		return EBTNodeResult::Failed;
 	}
@@ -28,14 +29,54 @@ EBTNodeResult::Type UBTTask_FindPointNearEnemy::ExecuteTask(UBehaviorTreeCompone
 	{
 		const float SearchRadius = 200.0f;
 		const FVector SearchOrigin = Enemy->GetActorLocation() + 600.0f * (MyBot->GetActorLocation() - Enemy->GetActorLocation()).GetSafeNormal();
+
+		UBlackboardComponent* MyBlackboard = OwnerComp.GetBlackboardComponent();
+		const FBlackboard::FKey KeyID = BlackboardKey.GetSelectedKeyID();
+		FBTFindPointNearEnemyMemory* MyMemory = CastInstanceNodeMemory<FBTFindPointNearEnemyMemory>(NodeMemory);
+
+		// Keep moving toward the previous goal while the query is pending, if there is one and it was picked for this enemy.
+		// A goal near the last enemy is no use once the enemy changed: wait for the new one.
+		const bool bLatent = !MyBlackboard->IsVectorValueSet(KeyID) || MyMemory->GoalEnemy.Get() != Enemy;
+		MyMemory->GoalEnemy = Enemy;
+
+		FShooterNavQueryDone OnDone = FShooterNavQueryDone::CreateWeakLambda(&OwnerComp, [this, &OwnerComp, KeyID, bLatent](bool bSuccess, const FVector& Loc)
+		{
+			if (bSuccess)
+			{
+				OwnerComp.GetBlackboardComponent()->SetValue<UBlackboardKeyType_Vector>(KeyID, Loc);
+			}
+			else if (bLatent)
+			{
+				// Don't let a goal picked for another enemy pass as this one's next time
+				OwnerComp.GetBlackboardComponent()->ClearValue(KeyID);
+			}
+
+			if (bLatent)
+			{
+				FinishLatentTask(OwnerComp, bSuccess ? EBTNodeResult::Succeeded : EBTNodeResult::Failed);
+			}
+		});
+
 		FVector Loc(0);
-		UNavigationSystemV1::K2_GetRandomReachablePointInRadius(MyController, SearchOrigin, Loc, SearchRadius);
-		if (Loc != FVector::ZeroVector)
+		if (NavQueries->RequestRandomReachablePoint(MyController, Enemy, SearchOrigin, SearchRadius, Loc, OnDone))
 		{
-			OwnerComp.GetBlackboardComponent()->SetValue<UBlackboardKeyType_Vector>(BlackboardKey.GetSelectedKeyID(), Loc);
+			MyBlackboard->SetValue<UBlackboardKeyType_Vector>(KeyID, Loc);
 			return EBTNodeResult::Succeeded;
 		}
+
+		return bLatent ? EBTNodeResult::InProgress : EBTNodeResult::Succeeded;
 	}
 
 	return EBTNodeResult::Failed;
 }
+
+EBTNodeResult::Type UBTTask_FindPointNearEnemy::AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	UShooterNavQueryService* NavQueries = OwnerComp.GetWorld()->GetSubsystem<UShooterNavQueryService>();
+	if (NavQueries)
+	{
+		NavQueries->CancelRequest(OwnerComp.GetAIOwner());
+	}
+
+	return Super::AbortTask(OwnerComp, NodeMemory);
+}
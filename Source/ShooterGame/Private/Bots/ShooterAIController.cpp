@@ -10,14 +10,64 @@
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
 #include "Weapons/ShooterWeapon.h"
+#include "Player/ShooterCharacterSpatialIndex.h"
+#include "Bots/ShooterLineOfSightService.h"
+#include "Bots/ShooterBehaviorTreeComponent.h"
+
+static int32 ShooterBotLODEnable = 1;
+static FAutoConsoleVariableRef CVarShooterBotLODEnable(
+	TEXT("ShooterGame.AI.LOD.Enable"),
+	ShooterBotLODEnable,
+	TEXT("Lowers the update rate of bots far from human players. 0: all bots run at full rate."),
+	ECVF_Default);
+
+static float ShooterBotLODReducedDistance = 3000.f;
+static FAutoConsoleVariableRef CVarShooterBotLODReducedDistance(
+	TEXT("ShooterGame.AI.LOD.ReducedDistance"),
+	ShooterBotLODReducedDistance,
+	TEXT("Bots further than this from every human player use the reduced AI LOD."),
+	ECVF_Default);
+
+static float ShooterBotLODMinimalDistance = 8000.f;
+static FAutoConsoleVariableRef CVarShooterBotLODMinimalDistance(
+	TEXT("ShooterGame.AI.LOD.MinimalDistance"),
+	ShooterBotLODMinimalDistance,
+	TEXT("Bots further than this from every human player use the minimal AI LOD."),
+	ECVF_Default);
+
+static float ShooterBotLODReducedInterval = 0.1f;
+static FAutoConsoleVariableRef CVarShooterBotLODReducedInterval(
+	TEXT("ShooterGame.AI.LOD.ReducedInterval"),
+	ShooterBotLODReducedInterval,
+	TEXT("Seconds between behavior tree and control rotation updates at the reduced AI LOD."),
+	ECVF_Default);
+
+static float ShooterBotLODMinimalInterval = 0.3f;
+static FAutoConsoleVariableRef CVarShooterBotLODMinimalInterval(
+	TEXT("ShooterGame.AI.LOD.MinimalInterval"),
+	ShooterBotLODMinimalInterval,
+	TEXT("Seconds between behavior tree and control rotation updates at the minimal AI LOD."),
+	ECVF_Default);
+
+static float ShooterBotLODUpdateInterval = 0.5f;
+static FAutoConsoleVariableRef CVarShooterBotLODUpdateInterval(
+	TEXT("ShooterGame.AI.LOD.UpdateInterval"),
+	ShooterBotLODUpdateInterval,
+	TEXT("Seconds between AI LOD updates of each bot."),
+	ECVF_Default);
 
 AShooterAIController::AShooterAIController(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
  	BlackboardComp = ObjectInitializer.CreateDefaultSubobject<UBlackboardComponent>(this, TEXT("BlackBoardComp"));
  	
-	BrainComponent = BehaviorComp = ObjectInitializer.CreateDefaultSubobject<UBehaviorTreeComponent>(this, TEXT("BehaviorComp"));	
+	BrainComponent = BehaviorComp = ObjectInitializer.CreateDefaultSubobject<UShooterBehaviorTreeComponent>(this, TEXT("BehaviorComp"));	
 
 	bWantsPlayerState = true;
+
+	LOD = EShooterBotLOD::Full;
+	ControlRotationInterval = 0.f;
+	ControlRotationDeltaTime = 0.f;
+	ThinkFrame = 0;
 }
 
 void AShooterAIController::OnPossess(APawn* InPawn)
@@ -39,6 +89,10 @@ void AShooterAIController::OnPossess(APawn* InPawn)
 
 		BehaviorComp->StartTree(*(Bot->BotBehavior));
 	}
+
+	// Random first delay so the bots don't all update their LOD in the same frame
+	const float LODUpdateInterval = FMath::Max(ShooterBotLODUpdateInterval, 0.1f);
+	GetWorldTimerManager().SetTimer(TimerHandle_UpdateLOD, this, &AShooterAIController::UpdateLOD, LODUpdateInterval, true, FMath::FRand() * LODUpdateInterval);
 }
 
 void AShooterAIController::OnUnPossess()
@@ -46,6 +100,12 @@ void AShooterAIController::OnUnPossess()
 	Super::OnUnPossess();
 
 	BehaviorComp->StopTree();
+
+	GetWorldTimerManager().ClearTimer(TimerHandle_UpdateLOD);
+
+	// The next pawn starts at full LOD until its first UpdateLOD
+	SetLOD(EShooterBotLOD::Full);
+	ControlRotationDeltaTime = 0.f;
 }
 
 void AShooterAIController::BeginInactiveState()
@@ -64,34 +124,67 @@ void AShooterAIController::Respawn()
 	GetWorld()->GetAuthGameMode()->RestartPlayer(this);
 }
 
-void AShooterAIController::FindClosestEnemy()
+FShooterCharacterQuery AShooterAIController::GetEnemyQuery()
+{
+	FShooterCharacterQuery Query;
+	Query.IgnoreActor = GetPawn();
+	Query.Filter = [this](const AShooterCharacter* TestPawn) { return TestPawn->IsEnemyFor(this); };
+
+	// In team games the whole own team partition can be skipped
+	const AShooterGameState* MyGameState = GetWorld()->GetGameState<AShooterGameState>();
+	const AShooterPlayerState* MyPlayerState = Cast<AShooterPlayerState>(PlayerState);
+	if (MyGameState && MyGameState->NumTeams > 1 && MyPlayerState)
+	{
+		Query.ExcludeTeam = MyPlayerState->GetTeamNum();
+	}
+
+	return Query;
+}
+
+bool AShooterAIController::GetClosestEnemies(int32 MaxEnemies, TArray<AShooterCharacter*>& OutEnemies)
 {
+	OutEnemies.Reset();
+
 	APawn* MyBot = GetPawn();
 	if (MyBot == NULL)
 	{
-		return;
+		return false;
 	}
 
-	const FVector MyLoc = MyBot->GetActorLocation();
-	float BestDistSq = MAX_FLT;
-	AShooterCharacter* BestPawn = NULL;
-
-	for (AShooterCharacter* TestPawn : TActorRange<AShooterCharacter>(GetWorld()))
+	// Think results are at most a frame old, depending on whether the game mode ticked before us
+	if (ThinkFrame + 1 >= GFrameCounter)
 	{
-		if (TestPawn->IsAlive() && TestPawn->IsEnemyFor(this))
+		for (const TWeakObjectPtr<AShooterCharacter>& Enemy : ThinkEnemies)
 		{
-			const float DistSq = (TestPawn->GetActorLocation() - MyLoc).SizeSquared();
-			if (DistSq < BestDistSq)
+			AShooterCharacter* EnemyChar = Enemy.Get();
+			if (EnemyChar && EnemyChar->IsAlive())
 			{
-				BestDistSq = DistSq;
-				BestPawn = TestPawn;
+				OutEnemies.Add(EnemyChar);
+				if (OutEnemies.Num() >= MaxEnemies)
+				{
+					break;
+				}
 			}
 		}
+		return true;
 	}
 
-	if (BestPawn)
+	UShooterCharacterSpatialIndex* CharacterIndex = GetWorld()->GetSubsystem<UShooterCharacterSpatialIndex>();
+	if (CharacterIndex)
+	{
+		CharacterIndex->FindNearest(MyBot->GetActorLocation(), MaxEnemies, GetEnemyQuery(), OutEnemies);
+	}
+	return false;
+}
+
+void AShooterAIController::FindClosestEnemy()
+{
+	TArray<AShooterCharacter*> Enemies;
+	GetClosestEnemies(1, Enemies);
+
+	if (Enemies.Num() > 0)
 	{
-		SetEnemy(BestPawn);
+		SetEnemy(Enemies[0]);
 	}
 }
 
@@ -99,85 +192,43 @@ bool AShooterAIController::FindClosestEnemyWithLOS(AShooterCharacter* ExcludeEne
 {
 	bool bGotEnemy = false;
 	APawn* MyBot = GetPawn();
-	if (MyBot != NULL)
+	UShooterLineOfSightService* LineOfSight = GetWorld()->GetSubsystem<UShooterLineOfSightService>();
+	if (MyBot != NULL && LineOfSight != NULL)
 	{
-		const FVector MyLoc = MyBot->GetActorLocation();
-		float BestDistSq = MAX_FLT;
-		AShooterCharacter* BestPawn = NULL;
+		// Enemies come closest first, so the first one we can see is the closest one with LOS.
+		// LOS comes from the shared async cache, enemies we have no result for yet get traced in the next frames.
+		TArray<AShooterCharacter*> Enemies;
+		const bool bFromThink = GetClosestEnemies(MAX_int32, Enemies);
 
-		for (AShooterCharacter* TestPawn : TActorRange<AShooterCharacter>(GetWorld()))
+		for (AShooterCharacter* TestPawn : Enemies)
 		{
-			if (TestPawn != ExcludeEnemy && TestPawn->IsAlive() && TestPawn->IsEnemyFor(this))
+			if (TestPawn != ExcludeEnemy && LineOfSight->GetLineOfSight(MyBot, TestPawn) == EShooterLineOfSight::Visible)
 			{
-				if (HasWeaponLOSToEnemy(TestPawn, true) == true)
-				{
-					const float DistSq = (TestPawn->GetActorLocation() - MyLoc).SizeSquared();
-					if (DistSq < BestDistSq)
-					{
-						BestDistSq = DistSq;
-						BestPawn = TestPawn;
-					}
-				}
+				SetEnemy(TestPawn);
+				bGotEnemy = true;
+				break;
 			}
 		}
-		if (BestPawn)
-		{
-			SetEnemy(BestPawn);
-			bGotEnemy = true;
-		}
-	}
-	return bGotEnemy;
-}
 
-bool AShooterAIController::HasWeaponLOSToEnemy(AActor* InEnemyActor, const bool bAnyEnemy) const
-{
-	
-	AShooterBot* MyBot = Cast<AShooterBot>(GetPawn());
-
-	bool bHasLOS = false;
-	// Perform trace to retrieve hit info
-	FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(AIWeaponLosTrace), true, GetPawn());
-
-	TraceParams.bReturnPhysicalMaterial = true;	
-	FVector StartLocation = MyBot->GetActorLocation();	
-	StartLocation.Z += GetPawn()->BaseEyeHeight; //look from eyes
-	
-	FHitResult Hit(ForceInit);
-	const FVector EndLocation = InEnemyActor->GetActorLocation();
-	GetWorld()->LineTraceSingleByChannel(Hit, StartLocation, EndLocation, COLLISION_WEAPON, TraceParams);
-	if (Hit.bBlockingHit == true)
-	{
-		// Theres a blocking hit - check if its our enemy actor
-		AActor* HitActor = Hit.GetActor();
-		if (Hit.GetActor() != NULL)
+		// The think pass only keeps the closest few enemies. When none of them is visible, the rest may still be: check them all in the character index.
+		UShooterCharacterSpatialIndex* CharacterIndex = GetWorld()->GetSubsystem<UShooterCharacterSpatialIndex>();
+		if (!bGotEnemy && bFromThink && CharacterIndex)
 		{
-			if (HitActor == InEnemyActor)
-			{
-				bHasLOS = true;
-			}
-			else if (bAnyEnemy == true)
+			TArray<AShooterCharacter*> AllEnemies;
+			CharacterIndex->FindNearest(MyBot->GetActorLocation(), MAX_int32, GetEnemyQuery(), AllEnemies);
+
+			for (AShooterCharacter* TestPawn : AllEnemies)
 			{
-				// Its not our actor, maybe its still an enemy ?
-				ACharacter* HitChar = Cast<ACharacter>(HitActor);
-				if (HitChar != NULL)
+				if (TestPawn != ExcludeEnemy && !Enemies.Contains(TestPawn) && LineOfSight->GetLineOfSight(MyBot, TestPawn) == EShooterLineOfSight::Visible)
 				{
-					AShooterPlayerState* HitPlayerState = Cast<AShooterPlayerState>(HitChar->GetPlayerState());
-					AShooterPlayerState* MyPlayerState = Cast<AShooterPlayerState>(PlayerState);
-					if ((HitPlayerState != NULL) && (MyPlayerState != NULL))
-					{
-						if (HitPlayerState->GetTeamNum() != MyPlayerState->GetTeamNum())
-						{
-							bHasLOS = true;
-						}
-					}
+					SetEnemy(TestPawn);
+					bGotEnemy = true;
+					break;
 				}
 			}
 		}
 	}
-
-	
-
-	return bHasLOS;
+	return bGotEnemy;
 }
 
 void AShooterAIController::ShootEnemy()
@@ -211,13 +262,36 @@ void AShooterAIController::ShootEnemy()
 
 void AShooterAIController::CheckAmmo(const class AShooterWeapon* CurrentWeapon)
 {
-	if (CurrentWeapon && BlackboardComp)
+	if (CurrentWeapon)
 	{
-		const int32 Ammo = CurrentWeapon->GetCurrentAmmo();
-		const int32 MaxAmmo = CurrentWeapon->GetMaxAmmo();
-		const float Ratio = (float) Ammo / (float) MaxAmmo;
+		SetNeedAmmo(IsLowOnAmmo(CurrentWeapon->GetCurrentAmmo(), CurrentWeapon->GetMaxAmmo()));
+	}
+}
+
+bool AShooterAIController::IsLowOnAmmo(int32 Ammo, int32 MaxAmmo)
+{
+	const float Ratio = (float) Ammo / (float) MaxAmmo;
+	return Ratio <= 0.1f;
+}
 
-		BlackboardComp->SetValue<UBlackboardKeyType_Bool>(NeedAmmoKeyID, (Ratio <= 0.1f));
+void AShooterAIController::SetNeedAmmo(bool bNeedAmmo)
+{
+	if (BlackboardComp)
+	{
+		BlackboardComp->SetValue<UBlackboardKeyType_Bool>(NeedAmmoKeyID, bNeedAmmo);
+	}
+}
+
+void AShooterAIController::SetThinkEnemies(TArray<TWeakObjectPtr<AShooterCharacter>>&& Enemies)
+{
+	ThinkEnemies = MoveTemp(Enemies);
+	ThinkFrame = GFrameCounter;
+
+	// Don't keep chasing a dead enemy until the behavior tree searches again
+	AShooterCharacter* CurrentEnemy = GetEnemy();
+	if (CurrentEnemy && !CurrentEnemy->IsAlive())
+	{
+		SetEnemy(ThinkEnemies.Num() > 0 ? ThinkEnemies[0].Get() : NULL);
 	}
 }
 
@@ -241,8 +315,110 @@ class AShooterCharacter* AShooterAIController::GetEnemy() const
 }
 
 
+void AShooterAIController::UpdateLOD()
+{
+	QUICK_SCOPE_CYCLE_COUNTER(AShooterAIController_UpdateLOD);
+
+	EShooterBotLOD::Type NewLOD = EShooterBotLOD::Full;
+
+	APawn* MyBot = GetPawn();
+	if (ShooterBotLODEnable && MyBot && !IsInCombat())
+	{
+		const float ViewerDistSq = GetClosestViewerDistSquared(MyBot->GetActorLocation());
+		if (ViewerDistSq > FMath::Square(ShooterBotLODMinimalDistance))
+		{
+			NewLOD = EShooterBotLOD::Minimal;
+		}
+		else if (ViewerDistSq > FMath::Square(ShooterBotLODReducedDistance))
+		{
+			NewLOD = EShooterBotLOD::Reduced;
+		}
+	}
+
+	SetLOD(NewLOD);
+}
+
+void AShooterAIController::SetLOD(EShooterBotLOD::Type NewLOD)
+{
+	LOD = NewLOD;
+
+	const float Interval = (LOD == EShooterBotLOD::Minimal) ? ShooterBotLODMinimalInterval : (LOD == EShooterBotLOD::Reduced) ? ShooterBotLODReducedInterval : 0.f;
+	ControlRotationInterval = Interval;
+	if (UShooterBehaviorTreeComponent* ShooterBehaviorComp = Cast<UShooterBehaviorTreeComponent>(BehaviorComp))
+	{
+		ShooterBehaviorComp->SetLODTickInterval(Interval);
+	}
+}
+
+bool AShooterAIController::IsInCombat() const
+{
+	AShooterBot* MyBot = Cast<AShooterBot>(GetPawn());
+	if (MyBot == NULL)
+	{
+		return false;
+	}
+
+	if (MyBot->IsFiring())
+	{
+		return true;
+	}
+
+	AShooterCharacter* Enemy = GetEnemy();
+	UShooterLineOfSightService* LineOfSight = GetWorld()->GetSubsystem<UShooterLineOfSightService>();
+	return Enemy && Enemy->IsAlive() && LineOfSight && LineOfSight->GetLineOfSight(MyBot, Enemy) == EShooterLineOfSight::Visible;
+}
+
+float AShooterAIController::GetClosestViewerDistSquared(const FVector& Location) const
+{
+	float BestDistSq = MAX_FLT;
+	bool bFoundViewer = false;
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+		if (PC == NULL || (PC->PlayerState && PC->PlayerState->IsABot()))
+		{
+			continue;
+		}
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+		BestDistSq = FMath::Min(BestDistSq, FVector::DistSquared(ViewLocation, Location));
+		bFoundViewer = true;
+	}
+
+	// Nobody is watching (bots only match, soak, a server waiting for players). Measure to the closest other living character instead,
+	// so bots that are about to run into each other fight at full LOD and the rest of the map still drops to the lower ones.
+	if (!bFoundViewer)
+	{
+		if (UShooterCharacterSpatialIndex* CharacterIndex = GetWorld()->GetSubsystem<UShooterCharacterSpatialIndex>())
+		{
+			FShooterCharacterQuery Query;
+			Query.IgnoreActor = GetPawn();
+
+			if (AShooterCharacter* Closest = CharacterIndex->FindNearest(Location, Query))
+			{
+				BestDistSq = FVector::DistSquared(Closest->GetActorLocation(), Location);
+			}
+		}
+	}
+
+	return BestDistSq;
+}
+
 void AShooterAIController::UpdateControlRotation(float DeltaTime, bool bUpdatePawn)
 {
+	// Far away bots turn less often, by the whole skipped time at once
+	ControlRotationDeltaTime += DeltaTime;
+	if (ControlRotationDeltaTime < ControlRotationInterval)
+	{
+		return;
+	}
+	DeltaTime = ControlRotationDeltaTime;
+	ControlRotationDeltaTime = 0.f;
+
 	// Look toward focus
 	FVector FocalPoint = GetFocalPoint();
 	if( !FocalPoint.IsZero() && GetPawn())
@@ -273,6 +449,7 @@ void AShooterAIController::GameHasEnded(AActor* EndGameFocus, bool bIsWinner)
 
 	// Cancel the repsawn timer
 	GetWorldTimerManager().ClearTimer(TimerHandle_Respawn);
+	GetWorldTimerManager().ClearTimer(TimerHandle_UpdateLOD);
 
 	// Clear any enemy
 	SetEnemy(NULL);
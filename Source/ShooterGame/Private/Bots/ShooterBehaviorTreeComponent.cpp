@@ -0,0 +1,19 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Bots/ShooterBehaviorTreeComponent.h"
+
+void UShooterBehaviorTreeComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	LODDeltaTime += DeltaTime;
+	if (LODDeltaTime < LODTickInterval)
+	{
+		return;
+	}
+
+	// The tree sees all the skipped time at once, so timers and waits still end on time
+	const float TreeDeltaTime = LODDeltaTime;
+	LODDeltaTime = 0.f;
+
+	Super::TickComponent(TreeDeltaTime, TickType, ThisTickFunction);
+}
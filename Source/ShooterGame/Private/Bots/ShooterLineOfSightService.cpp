@@ -0,0 +1,214 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Bots/ShooterLineOfSightService.h"
+#include "Online/ShooterPlayerState.h"
+
+static int32 ShooterLOSTracesPerFrame = 16;
+static FAutoConsoleVariableRef CVarShooterLOSTracesPerFrame(
+	TEXT("ShooterGame.LOS.TracesPerFrame"),
+	ShooterLOSTracesPerFrame,
+	TEXT("Max async line of sight traces the bot LOS service issues per frame."),
+	ECVF_Default);
+
+static float ShooterLOSMaxAge = 0.25f;
+static FAutoConsoleVariableRef CVarShooterLOSMaxAge(
+	TEXT("ShooterGame.LOS.MaxAge"),
+	ShooterLOSMaxAge,
+	TEXT("Seconds a line of sight result is used before it is traced again."),
+	ECVF_Default);
+
+/** Location targets are cached per 50uu cell */
+static const float LOSLocationQuantization = 50.f;
+
+EShooterLineOfSight::Type UShooterLineOfSightService::GetLineOfSight(APawn* Observer, AActor* Target)
+{
+	if (Observer == nullptr || Target == nullptr)
+	{
+		return EShooterLineOfSight::Blocked;
+	}
+
+	FRequest Request;
+	Request.Key.Observer = Observer;
+	Request.Key.Target = Target;
+	Request.Key.Location = FIntVector::ZeroValue;
+	Request.Observer = Observer;
+	Request.Target = Target;
+	Request.TargetLocation = Target->GetActorLocation();
+
+	return GetLineOfSight(Request);
+}
+
+EShooterLineOfSight::Type UShooterLineOfSightService::GetLineOfSight(APawn* Observer, const FVector& TargetLocation)
+{
+	if (Observer == nullptr)
+	{
+		return EShooterLineOfSight::Blocked;
+	}
+
+	FRequest Request;
+	Request.Key.Observer = Observer;
+	Request.Key.Location = FIntVector(
+		FMath::RoundToInt(TargetLocation.X / LOSLocationQuantization),
+		FMath::RoundToInt(TargetLocation.Y / LOSLocationQuantization),
+		FMath::RoundToInt(TargetLocation.Z / LOSLocationQuantization));
+	Request.Observer = Observer;
+	Request.TargetLocation = TargetLocation;
+
+	return GetLineOfSight(Request);
+}
+
+EShooterLineOfSight::Type UShooterLineOfSightService::GetLineOfSight(const FRequest& Request)
+{
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	FResult& Result = Results.FindOrAdd(Request.Key);
+	Result.RequestTime = Now;
+
+	// Several bots (or several decorators of one bot) asking in the same frame share one trace
+	if (!Result.bQueued && (Result.ResultTime < 0.f || Now - Result.ResultTime > ShooterLOSMaxAge))
+	{
+		Result.bQueued = true;
+		Queue.Add(Request);
+	}
+
+	if (Result.ResultTime < 0.f)
+	{
+		return EShooterLineOfSight::Unknown;
+	}
+
+	return Result.bVisible ? EShooterLineOfSight::Visible : EShooterLineOfSight::Blocked;
+}
+
+void UShooterLineOfSightService::Tick(float DeltaTime)
+{
+	UWorld* World = GetWorld();
+	const float Now = World->GetTimeSeconds();
+
+	int32 NumTraces = 0;
+	int32 NumProcessed = 0;
+	for (; NumProcessed < Queue.Num() && NumTraces < ShooterLOSTracesPerFrame; ++NumProcessed)
+	{
+		const FRequest& Request = Queue[NumProcessed];
+		FResult* Result = Results.Find(Request.Key);
+		APawn* Observer = Request.Observer.Get();
+		AActor* Target = Request.Target.Get();
+
+		if (Result == nullptr || Observer == nullptr || (Target == nullptr && Request.Key.Target != FObjectKey()))
+		{
+			if (Result)
+			{
+				Result->bQueued = false;
+			}
+			continue;
+		}
+
+		FVector StartLocation = Observer->GetActorLocation();
+		StartLocation.Z += Observer->BaseEyeHeight; //look from eyes
+
+		FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(AILosTrace), true, Observer);
+		TraceParams.AddIgnoredActor(Observer->GetController());
+
+		const uint32 TraceId = NextTraceId++;
+		if (NextTraceId == 0)
+		{
+			NextTraceId = 1;
+		}
+
+		FTraceDelegate TraceDelegate = FTraceDelegate::CreateUObject(this, &UShooterLineOfSightService::OnTraceDone);
+		World->AsyncLineTraceByChannel(EAsyncTraceType::Single, StartLocation, Target ? Target->GetActorLocation() : Request.TargetLocation, COLLISION_WEAPON, TraceParams, FCollisionResponseParams::DefaultResponseParam, &TraceDelegate, TraceId);
+
+		PendingTraces.Add(TraceId, Request);
+		++NumTraces;
+	}
+
+	Queue.RemoveAt(0, NumProcessed, false);
+
+	// Forget pairs nobody asked about in a while, queued or not: a trace nobody is waiting for is wasted, and a queued pair
+	// whose observer went away (or whose trace never came back) would otherwise be kept forever
+	if (Now - LastCleanupTime > 1.f)
+	{
+		LastCleanupTime = Now;
+
+		for (auto It = Results.CreateIterator(); It; ++It)
+		{
+			if (Now - It.Value().RequestTime > 2.f)
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		Queue.RemoveAll([this](const FRequest& Request)
+		{
+			return !Results.Contains(Request.Key) || !Request.Observer.IsValid() || (Request.Key.Target != FObjectKey() && !Request.Target.IsValid());
+		});
+
+		for (auto It = PendingTraces.CreateIterator(); It; ++It)
+		{
+			if (!Results.Contains(It.Value().Key))
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+}
+
+void UShooterLineOfSightService::OnTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	FRequest Request;
+	if (PendingTraces.RemoveAndCopyValue(TraceDatum.UserData, Request) == false)
+	{
+		return;
+	}
+
+	FResult* Result = Results.Find(Request.Key);
+	APawn* Observer = Request.Observer.Get();
+	if (Result == nullptr)
+	{
+		return;
+	}
+
+	Result->bQueued = false;
+	Result->ResultTime = GetWorld()->GetTimeSeconds();
+	Result->bVisible = false;
+
+	const FHitResult* Hit = TraceDatum.OutHits.FindByPredicate([](const FHitResult& TestHit) { return TestHit.bBlockingHit; });
+	if (Hit == nullptr)
+	{
+		// Nothing in the way
+		Result->bVisible = true;
+	}
+	else if (Request.Key.Target == FObjectKey())
+	{
+		// Location target: only blocked if something is hit before reaching it
+		Result->bVisible = FVector::DistSquared(TraceDatum.Start, Hit->ImpactPoint) >= FVector::DistSquared(TraceDatum.Start, TraceDatum.End) - 1.f;
+	}
+	else if (AActor* HitActor = Hit->GetActor())
+	{
+		if (HitActor == Request.Target.Get())
+		{
+			Result->bVisible = true;
+		}
+		else if (ACharacter* HitChar = Cast<ACharacter>(HitActor))
+		{
+			// Its not our target, maybe its still an enemy ?
+			AShooterPlayerState* HitPlayerState = Cast<AShooterPlayerState>(HitChar->GetPlayerState());
+			AShooterPlayerState* MyPlayerState = Observer ? Cast<AShooterPlayerState>(Observer->GetPlayerState()) : nullptr;
+			if (HitPlayerState && MyPlayerState && HitPlayerState->GetTeamNum() != MyPlayerState->GetTeamNum())
+			{
+				Result->bVisible = true;
+			}
+		}
+	}
+}
+
+bool UShooterLineOfSightService::IsTickable() const
+{
+	const UWorld* World = GetWorld();
+	return !HasAnyFlags(RF_ClassDefaultObject) && World && World->IsGameWorld() && (Queue.Num() > 0 || Results.Num() > 0);
+}
+
+TStatId UShooterLineOfSightService::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterLineOfSightService, STATGROUP_Tickables);
+}
@@ -0,0 +1,135 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Bots/ShooterNavQueryService.h"
+#include "NavigationSystem.h"
+
+static int32 ShooterNavQueriesPerFrame = 4;
+static FAutoConsoleVariableRef CVarShooterNavQueriesPerFrame(
+	TEXT("ShooterGame.NavQuery.QueriesPerFrame"),
+	ShooterNavQueriesPerFrame,
+	TEXT("Max deferred bot navmesh queries run per frame."),
+	ECVF_Default);
+
+static float ShooterNavQueryMaxAge = 1.f;
+static FAutoConsoleVariableRef CVarShooterNavQueryMaxAge(
+	TEXT("ShooterGame.NavQuery.MaxAge"),
+	ShooterNavQueryMaxAge,
+	TEXT("Seconds a bot navmesh query result can be reused by other bots heading for the same target."),
+	ECVF_Default);
+
+static float ShooterNavQueryReuseDistance = 150.f;
+static FAutoConsoleVariableRef CVarShooterNavQueryReuseDistance(
+	TEXT("ShooterGame.NavQuery.ReuseDistance"),
+	ShooterNavQueryReuseDistance,
+	TEXT("A bot navmesh query result is reused if the new query's origin is within this distance of the old one."),
+	ECVF_Default);
+
+/** Recent results kept per target */
+static const int32 MaxCachedPointsPerTarget = 8;
+
+bool UShooterNavQueryService::RequestRandomReachablePoint(UObject* Querier, const AActor* Target, const FVector& Origin, float Radius, FVector& OutLocation, FShooterNavQueryDone OnDone)
+{
+	const float Now = GetWorld()->GetTimeSeconds();
+	if (const TArray<FCachedPoint, TInlineAllocator<4>>* TargetPoints = CachedPoints.Find(Target))
+	{
+		for (const FCachedPoint& Point : *TargetPoints)
+		{
+			if (Now - Point.Time < ShooterNavQueryMaxAge && FVector::DistSquared(Point.Origin, Origin) < FMath::Square(ShooterNavQueryReuseDistance))
+			{
+				CancelRequest(Querier);
+				OutLocation = Point.Location;
+				return true;
+			}
+		}
+	}
+
+	// A querier asking again while its request is still queued keeps its place in the queue, with the new parameters.
+	// Re-queueing at the back would starve bots that re-run their task faster than the queue drains.
+	const FObjectKey QuerierKey(Querier);
+	FRequest* QueuedRequest = Queue.FindByPredicate([&QuerierKey](const FRequest& Request) { return Request.Querier == QuerierKey; });
+	FRequest& Request = QueuedRequest ? *QueuedRequest : Queue.AddDefaulted_GetRef();
+	Request.Querier = Querier;
+	Request.Target = Target;
+	Request.Origin = Origin;
+	Request.Radius = Radius;
+	Request.OnDone = MoveTemp(OnDone);
+
+	return false;
+}
+
+void UShooterNavQueryService::CancelRequest(UObject* Querier)
+{
+	const FObjectKey QuerierKey(Querier);
+	Queue.RemoveAll([&QuerierKey](const FRequest& Request) { return Request.Querier == QuerierKey; });
+}
+
+void UShooterNavQueryService::AddCachedPoint(const FObjectKey& Target, const FVector& Origin, const FVector& Location)
+{
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	TArray<FCachedPoint, TInlineAllocator<4>>& TargetPoints = CachedPoints.FindOrAdd(Target);
+	TargetPoints.RemoveAll([Now](const FCachedPoint& Point) { return Now - Point.Time >= ShooterNavQueryMaxAge; });
+	if (TargetPoints.Num() >= MaxCachedPointsPerTarget)
+	{
+		TargetPoints.RemoveAt(0);
+	}
+
+	FCachedPoint& Point = TargetPoints.AddDefaulted_GetRef();
+	Point.Origin = Origin;
+	Point.Location = Location;
+	Point.Time = Now;
+}
+
+void UShooterNavQueryService::Tick(float DeltaTime)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(UShooterNavQueryService_Tick);
+
+	UWorld* World = GetWorld();
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World);
+	ANavigationData* NavData = NavSys ? NavSys->GetDefaultNavDataInstance(FNavigationSystem::DontCreate) : nullptr;
+
+	// Pull this frame's requests out first, OnDone may queue new ones
+	const int32 NumQueries = FMath::Min(Queue.Num(), FMath::Max(ShooterNavQueriesPerFrame, 1));
+	TArray<FRequest, TInlineAllocator<16>> Requests;
+	Requests.Append(Queue.GetData(), NumQueries);
+	Queue.RemoveAt(0, NumQueries, false);
+
+	for (FRequest& Request : Requests)
+	{
+		if (Request.Querier.ResolveObjectPtr() == nullptr)
+		{
+			continue;
+		}
+
+		FNavLocation Result;
+		const bool bSuccess = NavData && NavSys->GetRandomReachablePointInRadius(Request.Origin, Request.Radius, Result, NavData);
+		if (bSuccess)
+		{
+			AddCachedPoint(Request.Target, Request.Origin, Result.Location);
+		}
+
+		Request.OnDone.ExecuteIfBound(bSuccess, Result.Location);
+	}
+
+	// Forget targets with only expired results
+	const float Now = World->GetTimeSeconds();
+	for (auto It = CachedPoints.CreateIterator(); It; ++It)
+	{
+		if (It.Value().Num() == 0 || Now - It.Value().Last().Time >= ShooterNavQueryMaxAge)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+bool UShooterNavQueryService::IsTickable() const
+{
+	const UWorld* World = GetWorld();
+	return !HasAnyFlags(RF_ClassDefaultObject) && World && World->IsGameWorld() && (Queue.Num() > 0 || CachedPoints.Num() > 0);
+}
+
+TStatId UShooterNavQueryService::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterNavQueryService, STATGROUP_Tickables);
+}
@@ -10,6 +10,44 @@
 #include "Online/ShooterGameSession.h"
 #include "Bots/ShooterAIController.h"
 #include "ShooterTeamStart.h"
+#include "Online/ShooterSpawnManager.h"
+#include "Weapons/ShooterWeapon.h"
+#include "Async/ParallelFor.h"
+
+static int32 ShooterBotThinkEnable = 1;
+static FAutoConsoleVariableRef CVarShooterBotThinkEnable(
+	TEXT("ShooterGame.AI.Think.Enable"),
+	ShooterBotThinkEnable,
+	TEXT("Finds the enemies and ammo needs of all bots in one parallel pass per frame. 0: each bot searches on its own."),
+	ECVF_Default);
+
+static int32 ShooterBotThinkMinParallelBots = 8;
+static FAutoConsoleVariableRef CVarShooterBotThinkMinParallelBots(
+	TEXT("ShooterGame.AI.Think.MinParallelBots"),
+	ShooterBotThinkMinParallelBots,
+	TEXT("Min bots before the bot think pass goes wide."),
+	ECVF_Default);
+
+static int32 ShooterBotThinkMaxEnemies = 8;
+static FAutoConsoleVariableRef CVarShooterBotThinkMaxEnemies(
+	TEXT("ShooterGame.AI.Think.MaxEnemies"),
+	ShooterBotThinkMaxEnemies,
+	TEXT("Closest enemies the bot think pass keeps for each bot."),
+	ECVF_Default);
+
+static float ShooterReplayCheckpointInterval = 5.f;
+static FAutoConsoleVariableRef CVarShooterReplayCheckpointInterval(
+	TEXT("ShooterGame.Replay.CheckpointInterval"),
+	ShooterReplayCheckpointInterval,
+	TEXT("Seconds between replay checkpoints when recording a match, seeking replays from the nearest checkpoint before the target. 0: use demo.CheckpointUploadDelayInSeconds as is."),
+	ECVF_Default);
+
+static int32 ShooterReplayMaxCheckpoints = 120;
+static FAutoConsoleVariableRef CVarShooterReplayMaxCheckpoints(
+	TEXT("ShooterGame.Replay.MaxCheckpoints"),
+	ShooterReplayMaxCheckpoints,
+	TEXT("Caps the number of checkpoints in the replay of one match, longer matches get a longer checkpoint interval."),
+	ECVF_Default);
 
 
 AShooterGameMode::AShooterGameMode(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
@@ -31,6 +69,9 @@ AShooterGameMode::AShooterGameMode(const FObjectInitializer& ObjectInitializer)
 
 	bAllowBots = true;	
 	bNeedsBotCreation = true;
+	LastBotThinkSeconds = 0.0;
+	LastBotThinkBots = 0;
+	PrimaryActorTick.bCanEverTick = true;
 	bUseSeamlessTravel = FParse::Param(FCommandLine::Get(), TEXT("NoSeamlessTravel")) ? false : true;
 }
 
@@ -54,6 +95,15 @@ void AShooterGameMode::InitGame(const FString& MapName, const FString& Options,
 	SetAllowBots(BotsCountOptionValue > 0 ? true : false, BotsCountOptionValue);	
 	Super::InitGame(MapName, Options, ErrorMessage);
 
+	SpawnManager = NewObject<UShooterSpawnManager>(this);
+	SpawnManager->Init(GetWorld());
+
+	// Recording starts right after the game mode is set up
+	if (UGameplayStatics::HasOption(Options, TEXT("DemoRec")))
+	{
+		SetReplayCheckpointInterval();
+	}
+
 	const UGameInstance* GameInstance = GetGameInstance();
 	if (GameInstance && Cast<UShooterGameInstance>(GameInstance)->GetOnlineMode() != EOnlineMode::Offline)
 	{
@@ -61,6 +111,51 @@ void AShooterGameMode::InitGame(const FString& MapName, const FString& Options,
 	}
 }
 
+void AShooterGameMode::SetReplayCheckpointInterval()
+{
+	static IConsoleVariable* CheckpointDelayCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("demo.CheckpointUploadDelayInSeconds"));
+	if (CheckpointDelayCVar == nullptr || ShooterReplayCheckpointInterval <= 0.f)
+	{
+		return;
+	}
+
+	// Denser checkpoints make seeks faster but each one is a full snapshot of the world, so their number is capped per match
+	const float MatchLength = WarmupTime + RoundTime;
+	const float Interval = FMath::Max(ShooterReplayCheckpointInterval, MatchLength / FMath::Max(ShooterReplayMaxCheckpoints, 1));
+
+	// The cvar is global, it goes back when this match is over
+	if (SavedReplayCheckpointInterval.IsEmpty())
+	{
+		SavedReplayCheckpointInterval = CheckpointDelayCVar->GetString();
+	}
+	CheckpointDelayCVar->Set(Interval, ECVF_SetByCode);
+
+	UE_LOG(LogShooter, Log, TEXT("Recording replay with a checkpoint every %.1fs"), Interval);
+}
+
+void AShooterGameMode::RestoreReplayCheckpointInterval()
+{
+	if (SavedReplayCheckpointInterval.IsEmpty())
+	{
+		return;
+	}
+
+	IConsoleVariable* CheckpointDelayCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("demo.CheckpointUploadDelayInSeconds"));
+	if (CheckpointDelayCVar)
+	{
+		CheckpointDelayCVar->Set(*SavedReplayCheckpointInterval, ECVF_SetByCode);
+	}
+	SavedReplayCheckpointInterval.Empty();
+}
+
+void AShooterGameMode::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Recording stops with the world
+	RestoreReplayCheckpointInterval();
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void AShooterGameMode::SetAllowBots(bool bInAllowBots, int32 InMaxBots)
 {
 	bAllowBots = bInAllowBots;
@@ -80,6 +175,16 @@ void AShooterGameMode::PreInitializeComponents()
 	GetWorldTimerManager().SetTimer(TimerHandle_DefaultTimer, this, &AShooterGameMode::DefaultTimer, GetWorldSettings()->GetEffectiveTimeDilation(), true);
 }
 
+void AShooterGameMode::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (ShooterBotThinkEnable && IsMatchInProgress())
+	{
+		UpdateBotThink();
+	}
+}
+
 void AShooterGameMode::DefaultTimer()
 {
 	// don't update timers for Play In Editor mode, it's not real match
@@ -305,13 +410,18 @@ void AShooterGameMode::Killed(AController* Killer, AController* KilledPlayer, AP
 	if (KillerPlayerState && KillerPlayerState != VictimPlayerState)
 	{
 		KillerPlayerState->ScoreKill(VictimPlayerState, KillScore);
-		KillerPlayerState->InformAboutKill(KillerPlayerState, DamageType, VictimPlayerState);
 	}
 
 	if (VictimPlayerState)
 	{
 		VictimPlayerState->ScoreDeath(KillerPlayerState, DeathScore);
-		VictimPlayerState->BroadcastDeath(KillerPlayerState, DamageType, VictimPlayerState);
+
+		// the kill feed tells every client, including the killer
+		AShooterGameState* const MyGameState = GetGameState<AShooterGameState>();
+		if (MyGameState)
+		{
+			MyGameState->AddKill(KillerPlayerState, DamageType, VictimPlayerState);
+		}
 	}
 }
 
@@ -384,48 +494,31 @@ void AShooterGameMode::RestartPlayer(AController* NewPlayer)
 	}
 }
 
-AActor* AShooterGameMode::ChoosePlayerStart_Implementation(AController* Player)
+void AShooterGameMode::RestartPlayerAtPlayerStart(AController* NewPlayer, AActor* StartSpot)
 {
-	TArray<APlayerStart*> PreferredSpawns;
-	TArray<APlayerStart*> FallbackSpawns;
+	Super::RestartPlayerAtPlayerStart(NewPlayer, StartSpot);
+
+	if (SpawnManager && NewPlayer && NewPlayer->GetPawn())
+	{
+		SpawnManager->MarkSpawnUsed(Cast<APlayerStart>(StartSpot));
+	}
+}
 
+AActor* AShooterGameMode::ChoosePlayerStart_Implementation(AController* Player)
+{
 	APlayerStart* BestStart = NULL;
-	for (TActorIterator<APlayerStart> It(GetWorld()); It; ++It)
+	if (GetWorld()->IsPlayInEditor())
 	{
-		APlayerStart* TestSpawn = *It;
-		if (TestSpawn->IsA<APlayerStartPIE>())
-		{
-			// Always prefer the first "Play from Here" PlayerStart, if we find one while in PIE mode
-			BestStart = TestSpawn;
-			break;
-		}
-		else
-		{
-			if (IsSpawnpointAllowed(TestSpawn, Player))
-			{
-				if (IsSpawnpointPreferred(TestSpawn, Player))
-				{
-					PreferredSpawns.Add(TestSpawn);
-				}
-				else
-				{
-					FallbackSpawns.Add(TestSpawn);
-				}
-			}
-		}
+		// Always prefer the first "Play from Here" PlayerStart, if we find one while in PIE mode
+		TActorIterator<APlayerStartPIE> It(GetWorld());
+		BestStart = It ? *It : NULL;
 	}
 
-	
-	if (BestStart == NULL)
+	if (BestStart == NULL && SpawnManager)
 	{
-		if (PreferredSpawns.Num() > 0)
-		{
-			BestStart = PreferredSpawns[FMath::RandHelper(PreferredSpawns.Num())];
-		}
-		else if (FallbackSpawns.Num() > 0)
-		{
-			BestStart = FallbackSpawns[FMath::RandHelper(FallbackSpawns.Num())];
-		}
+		BestStart = SpawnManager->ChooseSpawn(Player,
+			[this, Player](APlayerStart* TestSpawn) { return IsSpawnpointAllowed(TestSpawn, Player); },
+			[this, Player](APlayerStart* TestSpawn) { return IsSpawnpointPreferred(TestSpawn, Player); });
 	}
 
 	return BestStart ? BestStart : Super::ChoosePlayerStart_Implementation(Player);
@@ -464,9 +557,32 @@ bool AShooterGameMode::IsSpawnpointPreferred(APlayerStart* SpawnPoint, AControll
 	if (MyPawn)
 	{
 		const FVector SpawnLocation = SpawnPoint->GetActorLocation();
-		for (ACharacter* OtherPawn : TActorRange<ACharacter>(GetWorld()))
+
+		// Ask physics for the pawns around the spawn point rather than the character index: the index is only rebuilt once per frame,
+		// so it misses pawns spawned earlier this frame, and it only holds AShooterCharacters.
+		// The overlap shape adds the other pawn's extents, so the query is sized for the tallest pawn we spawn to cover the
+		// vertical test below (2 * (MyHalfHeight + OtherHalfHeight)).
+		float MaxOtherHalfHeight = MyPawn->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+		for (UClass* PawnClass : { *DefaultPawnClass, *BotPawnClass })
 		{
-			if (OtherPawn != MyPawn)
+			const ACharacter* PawnCDO = PawnClass ? Cast<ACharacter>(PawnClass->GetDefaultObject()) : nullptr;
+			if (PawnCDO && PawnCDO->GetCapsuleComponent())
+			{
+				MaxOtherHalfHeight = FMath::Max(MaxOtherHalfHeight, PawnCDO->GetCapsuleComponent()->GetScaledCapsuleHalfHeight());
+			}
+		}
+
+		const float QueryRadius = MyPawn->GetCapsuleComponent()->GetScaledCapsuleRadius();
+		const float QueryHalfHeight = MyPawn->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() * 2.0f + MaxOtherHalfHeight;
+
+		TArray<FOverlapResult> Overlaps;
+		GetWorld()->OverlapMultiByObjectType(Overlaps, SpawnLocation, FQuat::Identity, FCollisionObjectQueryParams(ECC_Pawn),
+			FCollisionShape::MakeCapsule(QueryRadius, QueryHalfHeight), FCollisionQueryParams(SCENE_QUERY_STAT(ShooterSpawnpointOccupied), false));
+
+		for (const FOverlapResult& Overlap : Overlaps)
+		{
+			ACharacter* OtherPawn = Cast<ACharacter>(Overlap.GetActor());
+			if (OtherPawn && OtherPawn != MyPawn)
 			{
 				const float CombinedHeight = (MyPawn->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() + OtherPawn->GetCapsuleComponent()->GetScaledCapsuleHalfHeight()) * 2.0f;
 				const float CombinedRadius = MyPawn->GetCapsuleComponent()->GetScaledCapsuleRadius() + OtherPawn->GetCapsuleComponent()->GetScaledCapsuleRadius();
@@ -537,6 +653,131 @@ void AShooterGameMode::StartBots()
 	}	
 }
 
+void AShooterGameMode::UpdateBotThink()
+{
+	QUICK_SCOPE_CYCLE_COUNTER(AShooterGameMode_UpdateBotThink);
+
+	const double StartTime = FPlatformTime::Seconds();
+	UWorld* World = GetWorld();
+
+	// Game thread: snapshot everything the think pass reads
+	int32 NumBots = 0;
+	for (FConstControllerIterator It = World->GetControllerIterator(); It; ++It)
+	{
+		AShooterAIController* AIC = Cast<AShooterAIController>(*It);
+		AShooterCharacter* Bot = AIC ? Cast<AShooterCharacter>(AIC->GetPawn()) : nullptr;
+		if (Bot == nullptr || !Bot->IsAlive())
+		{
+			continue;
+		}
+
+		// Throttled bots search the character index from their behavior tree, at their lower tick rate
+		if (AIC->GetLOD() != EShooterBotLOD::Full)
+		{
+			continue;
+		}
+
+		if (NumBots == BotThinks.Num())
+		{
+			BotThinks.AddDefaulted();
+		}
+
+		const AShooterPlayerState* BotPlayerState = Cast<AShooterPlayerState>(AIC->PlayerState);
+		const AShooterWeapon* Weapon = Bot->GetWeapon();
+
+		FBotThink& Think = BotThinks[NumBots++];
+		Think.Controller = AIC;
+		Think.Pawn = Bot;
+		Think.Location = Bot->GetActorLocation();
+		Think.TeamNum = BotPlayerState ? BotPlayerState->GetTeamNum() : INDEX_NONE;
+		Think.bHasWeapon = Weapon != nullptr;
+		Think.Ammo = Weapon ? Weapon->GetCurrentAmmo() : 0;
+		Think.MaxAmmo = Weapon ? Weapon->GetMaxAmmo() : 0;
+	}
+
+	// Only full LOD bots read the characters, don't walk them when every bot is throttled
+	BotThinkCharacters.Reset();
+	if (NumBots > 0)
+	{
+		for (AShooterCharacter* Character : TActorRange<AShooterCharacter>(World))
+		{
+			const AShooterPlayerState* CharacterPlayerState = Cast<AShooterPlayerState>(Character->GetPlayerState());
+
+			FBotThinkCharacter& Entry = BotThinkCharacters.AddDefaulted_GetRef();
+			Entry.Character = Character;
+			Entry.Location = Character->GetActorLocation();
+			Entry.TeamNum = CharacterPlayerState ? CharacterPlayerState->GetTeamNum() : INDEX_NONE;
+			Entry.bAlive = Character->IsAlive();
+		}
+	}
+
+	// Same rule as CanDealDamage in the shipped modes: with teams only the other teams are enemies, without everybody else is
+	const AShooterGameState* MyGameState = GetGameState<AShooterGameState>();
+	const bool bTeamGame = MyGameState && MyGameState->NumTeams > 1;
+
+	// One task per bot. Each only reads the snapshot and writes its own results.
+	const bool bForceSingleThread = NumBots < ShooterBotThinkMinParallelBots;
+	const int32 MaxEnemies = FMath::Max(ShooterBotThinkMaxEnemies, 1);
+	ParallelFor(NumBots, [this, bTeamGame, MaxEnemies](int32 BotIdx)
+	{
+		FBotThink& Think = BotThinks[BotIdx];
+
+		// Keeps the closest MaxEnemies in order as it goes, instead of sorting every enemy
+		Think.Enemies.Reset();
+		for (int32 CharacterIdx = 0; CharacterIdx < BotThinkCharacters.Num(); ++CharacterIdx)
+		{
+			const FBotThinkCharacter& Other = BotThinkCharacters[CharacterIdx];
+			if (Other.Character == Think.Pawn || !Other.bAlive || (bTeamGame && Other.TeamNum == Think.TeamNum))
+			{
+				continue;
+			}
+
+			const float DistSq = FVector::DistSquared(Think.Location, Other.Location);
+			if (Think.Enemies.Num() == MaxEnemies && DistSq >= Think.Enemies.Last().Key)
+			{
+				continue;
+			}
+
+			int32 InsertIdx = Think.Enemies.Num();
+			while (InsertIdx > 0 && Think.Enemies[InsertIdx - 1].Key > DistSq)
+			{
+				--InsertIdx;
+			}
+			if (Think.Enemies.Num() == MaxEnemies)
+			{
+				Think.Enemies.Pop(false);
+			}
+			Think.Enemies.Insert(TPair<float, int32>(DistSq, CharacterIdx), InsertIdx);
+		}
+
+		Think.bNeedAmmo = Think.bHasWeapon && AShooterAIController::IsLowOnAmmo(Think.Ammo, Think.MaxAmmo);
+	}, bForceSingleThread);
+
+	// Back on the game thread
+	for (int32 BotIdx = 0; BotIdx < NumBots; ++BotIdx)
+	{
+		const FBotThink& Think = BotThinks[BotIdx];
+
+		TArray<TWeakObjectPtr<AShooterCharacter>> Enemies;
+		Enemies.Reserve(Think.Enemies.Num());
+		for (const TPair<float, int32>& Enemy : Think.Enemies)
+		{
+			Enemies.Add(BotThinkCharacters[Enemy.Value].Character);
+		}
+
+		Think.Controller->SetThinkEnemies(MoveTemp(Enemies));
+		if (Think.bHasWeapon)
+		{
+			Think.Controller->SetNeedAmmo(Think.bNeedAmmo);
+		}
+	}
+
+	BotThinks.SetNum(NumBots, false);
+
+	LastBotThinkSeconds = FPlatformTime::Seconds() - StartTime;
+	LastBotThinkBots = NumBots;
+}
+
 void AShooterGameMode::InitBot(AShooterAIController* AIController, int32 BotNum)
 {	
 	if (AIController)
@@ -11,6 +11,20 @@ namespace
 	const FString CustomMatchKeyword("Custom");
 }
 
+static float ShooterMatchmakingMaxPing = 250.f;
+static FAutoConsoleVariableRef CVarShooterMatchmakingMaxPing(
+	TEXT("ShooterGame.Matchmaking.MaxPing"),
+	ShooterMatchmakingMaxPing,
+	TEXT("Ping in ms at or above which a session gets nothing for its ping when matchmaking scores it."),
+	ECVF_Default);
+
+static float ShooterMatchmakingJoinFailureTime = 60.f;
+static FAutoConsoleVariableRef CVarShooterMatchmakingJoinFailureTime(
+	TEXT("ShooterGame.Matchmaking.JoinFailureTime"),
+	ShooterMatchmakingJoinFailureTime,
+	TEXT("Seconds during which matchmaking skips a session that failed to join."),
+	ECVF_Default);
+
 AShooterGameSession::AShooterGameSession(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
@@ -142,6 +156,11 @@ EOnlineAsyncTaskState::Type AShooterGameSession::GetSearchResultStatus(int32& Se
 			SearchResultIdx = CurrentSessionParams.BestSessionIdx;
 			NumSearchResults = SearchSettings->SearchResults.Num();
 		}
+		else if (SearchSettings->SearchState == EOnlineAsyncTaskState::InProgress)
+		{
+			// LAN searches add results as servers answer, so they can be shown before the search ends
+			NumSearchResults = SearchSettings->SearchResults.Num();
+		}
 		return SearchSettings->SearchState;
 	}
 
@@ -308,15 +327,98 @@ void AShooterGameSession::OnFindSessionsComplete(bool bWasSuccessful)
 void AShooterGameSession::ResetBestSessionVars()
 {
 	CurrentSessionParams.BestSessionIdx = -1;
+	CurrentSessionParams.MatchmakingCandidates.Reset();
+	CurrentSessionParams.NextMatchmakingCandidate = 0;
+}
+
+float AShooterGameSession::ScoreSearchResult(const FOnlineSessionSearchResult& SearchResult)
+{
+	const FOnlineSession& Session = SearchResult.Session;
+	if (Session.SessionSettings.BuildUniqueId != GetBuildUniqueId())
+	{
+		return -1.f;
+	}
+
+	const int32 MaxNumPlayers = Session.SessionSettings.NumPublicConnections + Session.SessionSettings.NumPrivateConnections;
+	const int32 OpenSlots = Session.NumOpenPublicConnections;
+	const int32 NumPlayers = MaxNumPlayers - Session.NumOpenPublicConnections - Session.NumOpenPrivateConnections;
+	if (OpenSlots <= 0 || MaxNumPlayers <= 0)
+	{
+		return -1.f;
+	}
+
+	// Low ping matters most, unknown pings (reported as huge values) count as the max
+	float Score = 2.f * (1.f - FMath::Clamp(SearchResult.PingInMs / FMath::Max(ShooterMatchmakingMaxPing, 1.f), 0.f, 1.f));
+
+	// Then busy games, but a last slot may well be taken before the join gets there
+	Score += (float)NumPlayers / MaxNumPlayers;
+	if (OpenSlots == 1)
+	{
+		Score -= 0.5f;
+	}
+
+	// Team games with an odd number of players are short one player on a team
+	FString GameType;
+	if (Session.SessionSettings.Get(SETTING_GAMEMODE, GameType) && GameType == TEXT("TDM") && NumPlayers % 2 == 1)
+	{
+		Score += 0.25f;
+	}
+
+	return Score;
+}
+
+void AShooterGameSession::RankSearchResults(const TArray<FOnlineSessionSearchResult>& SearchResults, const TMap<FString, double>& JoinFailureTimes, double Now, TArray<int32>& OutCandidates)
+{
+	TArray<TPair<float, int32>> Scores;
+	for (int32 SessionIndex = 0; SessionIndex < SearchResults.Num(); SessionIndex++)
+	{
+		const FOnlineSessionSearchResult& SearchResult = SearchResults[SessionIndex];
+
+		const double* FailureTime = JoinFailureTimes.Find(SearchResult.GetSessionIdStr());
+		if (FailureTime && Now - *FailureTime <= ShooterMatchmakingJoinFailureTime)
+		{
+			continue;
+		}
+
+		const float Score = ScoreSearchResult(SearchResult);
+		if (Score >= 0.f)
+		{
+			Scores.Emplace(Score, SessionIndex);
+		}
+	}
+
+	// Highest score first, search order between equal scores
+	Scores.StableSort([](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key > B.Key; });
+
+	OutCandidates.Reset(Scores.Num());
+	for (const TPair<float, int32>& Score : Scores)
+	{
+		OutCandidates.Add(Score.Value);
+	}
 }
 
 void AShooterGameSession::ChooseBestSession()
 {
+	// Score the search results once, then go down the list
+	if (CurrentSessionParams.BestSessionIdx == -1 && CurrentSessionParams.NextMatchmakingCandidate == 0)
+	{
+		const double Now = FPlatformTime::Seconds();
+		for (TMap<FString, double>::TIterator It(JoinFailureTimes); It; ++It)
+		{
+			if (Now - It.Value() > ShooterMatchmakingJoinFailureTime)
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		RankSearchResults(SearchSettings->SearchResults, JoinFailureTimes, Now, CurrentSessionParams.MatchmakingCandidates);
+	}
+
 	// Start searching from where we left off
-	for (int32 SessionIndex = CurrentSessionParams.BestSessionIdx+1; SessionIndex < SearchSettings->SearchResults.Num(); SessionIndex++)
+	if (CurrentSessionParams.NextMatchmakingCandidate < CurrentSessionParams.MatchmakingCandidates.Num())
 	{
 		// Found the match that we want
-		CurrentSessionParams.BestSessionIdx = SessionIndex;
+		CurrentSessionParams.BestSessionIdx = CurrentSessionParams.MatchmakingCandidates[CurrentSessionParams.NextMatchmakingCandidate++];
 		return;
 	}
 
@@ -326,7 +428,15 @@ void AShooterGameSession::ChooseBestSession()
 void AShooterGameSession::StartMatchmaking()
 {
 	ResetBestSessionVars();
-	ContinueMatchmaking();
+	CurrentSessionParams.bMatchmaking = SearchSettings.IsValid();
+	if (CurrentSessionParams.bMatchmaking)
+	{
+		ContinueMatchmaking();
+	}
+	else
+	{
+		OnNoMatchesAvailable();
+	}
 }
 
 void AShooterGameSession::ContinueMatchmaking()
@@ -334,27 +444,30 @@ void AShooterGameSession::ContinueMatchmaking()
 	ChooseBestSession();
 	if (CurrentSessionParams.BestSessionIdx >= 0 && CurrentSessionParams.BestSessionIdx < SearchSettings->SearchResults.Num())
 	{
-		IOnlineSubsystem* OnlineSub = Online::GetSubsystem(GetWorld());
-		if (OnlineSub)
+		IOnlineSessionPtr Sessions = Online::GetSessionInterface(GetWorld());
+		if (Sessions.IsValid() && CurrentSessionParams.UserId.IsValid())
 		{
-			IOnlineSessionPtr Sessions = OnlineSub->GetSessionInterface();
-			if (Sessions.IsValid() && CurrentSessionParams.UserId.IsValid())
-			{
-				OnJoinSessionCompleteDelegateHandle = Sessions->AddOnJoinSessionCompleteDelegate_Handle(OnJoinSessionCompleteDelegate);
-				Sessions->JoinSession(*CurrentSessionParams.UserId, CurrentSessionParams.SessionName, SearchSettings->SearchResults[CurrentSessionParams.BestSessionIdx]);
-			}
+			UE_LOG(LogOnlineGame, Verbose, TEXT("Matchmaking: trying session %d of %d."), CurrentSessionParams.NextMatchmakingCandidate, CurrentSessionParams.MatchmakingCandidates.Num());
+
+			// The join completion comes back through OnJoinSessionComplete, success or not
+			JoinSession(CurrentSessionParams.UserId, CurrentSessionParams.SessionName, SearchSettings->SearchResults[CurrentSessionParams.BestSessionIdx]);
+			return;
 		}
 	}
-	else
-	{
-		OnNoMatchesAvailable();
-	}
+
+	OnNoMatchesAvailable();
 }
 
 void AShooterGameSession::OnNoMatchesAvailable()
 {
 	UE_LOG(LogOnlineGame, Verbose, TEXT("Matchmaking complete, no sessions available."));
 	SearchSettings = NULL;
+
+	if (CurrentSessionParams.bMatchmaking)
+	{
+		CurrentSessionParams.bMatchmaking = false;
+		OnJoinSessionComplete().Broadcast(EOnJoinSessionCompleteResult::SessionDoesNotExist);
+	}
 }
 
 void AShooterGameSession::FindSessions(TSharedPtr<const FUniqueNetId> UserId, FName InSessionName, bool bIsLAN, bool bIsPresence)
@@ -407,6 +520,7 @@ bool AShooterGameSession::JoinSession(TSharedPtr<const FUniqueNetId> UserId, FNa
 		IOnlineSessionPtr Sessions = OnlineSub->GetSessionInterface();
 		if (Sessions.IsValid() && UserId.IsValid())
 		{
+			PendingJoinSessionId = SearchResult.GetSessionIdStr();
 			OnJoinSessionCompleteDelegateHandle = Sessions->AddOnJoinSessionCompleteDelegate_Handle(OnJoinSessionCompleteDelegate);
 			bResult = Sessions->JoinSession(*UserId, InSessionName, SearchResult);
 		}
@@ -437,6 +551,20 @@ void AShooterGameSession::OnJoinSessionComplete(FName InSessionName, EOnJoinSess
 		}
 	}
 
+	if (Result != EOnJoinSessionCompleteResult::Success && Result != EOnJoinSessionCompleteResult::AlreadyInSession && !PendingJoinSessionId.IsEmpty())
+	{
+		JoinFailureTimes.Add(PendingJoinSessionId, FPlatformTime::Seconds());
+	}
+	PendingJoinSessionId.Empty();
+
+	// While matchmaking, a failed join moves on to the next best session. Already being in a session fails every join the same way, so that ends matchmaking.
+	if (CurrentSessionParams.bMatchmaking && Result != EOnJoinSessionCompleteResult::Success && Result != EOnJoinSessionCompleteResult::AlreadyInSession)
+	{
+		ContinueMatchmaking();
+		return;
+	}
+	CurrentSessionParams.bMatchmaking = false;
+
 	OnJoinSessionComplete().Broadcast(Result);
 }
 
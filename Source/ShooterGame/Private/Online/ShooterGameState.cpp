@@ -6,11 +6,28 @@
 #include "OnlineSubsystemUtils.h"
 #include "OnlineGameMatchesInterface.h"
 
+/** kills kept in the kill feed for players joining later */
+static const int32 MaxKillFeedEntries = 16;
+
+/** older kills are not shown anymore, same as the hud's death message duration */
+static const float MaxKillFeedAge = 10.0f;
+
+void FShooterKillFeedEntry::PostReplicatedAdd(const FShooterKillFeed& InArraySerializer)
+{
+	if (InArraySerializer.GameState)
+	{
+		InArraySerializer.GameState->HandleKill(*this);
+	}
+}
+
 AShooterGameState::AShooterGameState(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 	NumTeams = 0;
 	RemainingTime = 0;
 	bTimerPaused = false;
+	bRankedMapsDirty = true;
+	RankedMapVersion = 0;
+	KillFeed.GameState = this;
 
 	UShooterGameInstance* GameInstance = GetWorld() != nullptr ? Cast<UShooterGameInstance>(GetWorld()->GetGameInstance()) : nullptr;
 
@@ -25,38 +42,160 @@ void AShooterGameState::GetLifetimeReplicatedProps( TArray< FLifetimeProperty >
 	DOREPLIFETIME( AShooterGameState, RemainingTime );
 	DOREPLIFETIME( AShooterGameState, bTimerPaused );
 	DOREPLIFETIME( AShooterGameState, TeamScores );
+	DOREPLIFETIME( AShooterGameState, KillFeed );
 }
 
 void AShooterGameState::GetRankedMap(int32 TeamIndex, RankedPlayerMap& OutRankedMap) const
 {
-	OutRankedMap.Empty();
+	UpdateRankedMaps();
+
+	const RankedPlayerMap* TeamRankedMap = RankedMaps.Find(TeamIndex);
+	if (TeamRankedMap)
+	{
+		OutRankedMap = *TeamRankedMap;
+	}
+	else
+	{
+		OutRankedMap.Empty();
+	}
+}
+
+void AShooterGameState::UpdateRankedMaps() const
+{
+	if (!bRankedMapsDirty)
+	{
+		return;
+	}
+
+	QUICK_SCOPE_CYCLE_COUNTER(AShooterGameState_UpdateRankedMaps);
+
+	bRankedMapsDirty = false;
 
-	//first, we need to go over all the PlayerStates, grab their score, and rank them
-	TMultiMap<int32, AShooterPlayerState*> SortedMap;
-	for(int32 i = 0; i < PlayerArray.Num(); ++i)
+	//first, we need to go over all the PlayerStates, grab their score and team
+	TArray<AShooterPlayerState*> SortedPlayers;
+	SortedPlayers.Reserve(PlayerArray.Num());
+	for (int32 i = 0; i < PlayerArray.Num(); ++i)
 	{
-		int32 Score = 0;
 		AShooterPlayerState* CurPlayerState = Cast<AShooterPlayerState>(PlayerArray[i]);
-		if (CurPlayerState && (CurPlayerState->GetTeamNum() == TeamIndex))
+		if (CurPlayerState)
 		{
-			SortedMap.Add(FMath::TruncToInt(CurPlayerState->GetScore()), CurPlayerState);
+			SortedPlayers.Add(CurPlayerState);
 		}
 	}
 
-	//sort by the keys
-	SortedMap.KeySort(TGreater<int32>());
+	//sort by score, ties keep the PlayerArray order
+	SortedPlayers.StableSort([](const AShooterPlayerState& A, const AShooterPlayerState& B)
+	{
+		return FMath::TruncToInt(A.GetScore()) > FMath::TruncToInt(B.GetScore());
+	});
+
+	//now, add them to the ranked map of their team
+	for (TPair<int32, RankedPlayerMap>& TeamRankedMap : RankedMaps)
+	{
+		TeamRankedMap.Value.Reset();
+	}
+
+	for (AShooterPlayerState* CurPlayerState : SortedPlayers)
+	{
+		RankedPlayerMap& TeamRankedMap = RankedMaps.FindOrAdd(CurPlayerState->GetTeamNum());
+		TeamRankedMap.Add(TeamRankedMap.Num(), CurPlayerState);
+	}
+}
+
+void AShooterGameState::InvalidateRankedMaps()
+{
+	bRankedMapsDirty = true;
+	++RankedMapVersion;
+}
+
+void AShooterGameState::AddPlayerState(APlayerState* PlayerState)
+{
+	Super::AddPlayerState(PlayerState);
+	InvalidateRankedMaps();
+}
+
+void AShooterGameState::RemovePlayerState(APlayerState* PlayerState)
+{
+	Super::RemovePlayerState(PlayerState);
+	InvalidateRankedMaps();
+}
+
+void AShooterGameState::AddKill(AShooterPlayerState* KillerPlayerState, const UDamageType* KillerDamageType, AShooterPlayerState* KilledPlayerState)
+{
+	check(HasAuthority());
+
+	if (KillFeed.Entries.Num() >= MaxKillFeedEntries)
+	{
+		KillFeed.Entries.RemoveAt(0, KillFeed.Entries.Num() - MaxKillFeedEntries + 1, false);
+		KillFeed.MarkArrayDirty();
+	}
+
+	FShooterKillFeedEntry& Entry = KillFeed.Entries.AddDefaulted_GetRef();
+	Entry.KillerPlayerId = KillerPlayerState ? KillerPlayerState->GetPlayerId() : INDEX_NONE;
+	Entry.VictimPlayerId = KilledPlayerState ? KilledPlayerState->GetPlayerId() : INDEX_NONE;
+	Entry.DamageType = KillerDamageType ? KillerDamageType->GetClass() : nullptr;
+	Entry.KillTime = GetServerWorldTimeSeconds();
+	KillFeed.MarkItemDirty(Entry);
+
+	// Send this frame's kills with the next net update instead of waiting for the game state's update rate
+	ForceNetUpdate();
+
+	// Replication callbacks don't run on the server, its local players are told right away
+	if (GetNetMode() != NM_DedicatedServer)
+	{
+		HandleKill(Entry);
+	}
+}
+
+void AShooterGameState::HandleKill(const FShooterKillFeedEntry& Entry)
+{
+	if (GetServerWorldTimeSeconds() - Entry.KillTime > MaxKillFeedAge)
+	{
+		return;
+	}
+
+	AShooterPlayerState* KillerPlayerState = FindPlayerStateById(Entry.KillerPlayerId);
+	AShooterPlayerState* KilledPlayerState = FindPlayerStateById(Entry.VictimPlayerId);
+	if (KilledPlayerState == nullptr)
+	{
+		return;
+	}
 
-	//now, add them back to the ranked map
-	OutRankedMap.Empty();
+	const UDamageType* KillerDamageType = Entry.DamageType ? Entry.DamageType->GetDefaultObject<UDamageType>() : nullptr;
 
-	int32 Rank = 0;
-	for(TMultiMap<int32, AShooterPlayerState*>::TIterator It(SortedMap); It; ++It)
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
 	{
-		OutRankedMap.Add(Rank++, It.Value());
+		AShooterPlayerController* TestPC = Cast<AShooterPlayerController>(*It);
+		if (TestPC && TestPC->IsLocalController())
+		{
+			if (KillerPlayerState && KillerPlayerState != KilledPlayerState && TestPC->PlayerState == KillerPlayerState)
+			{
+				TestPC->OnKill();
+			}
+
+			// all local players get death messages so they can update their huds.
+			TestPC->OnDeathMessage(KillerPlayerState, KilledPlayerState, KillerDamageType);
+		}
 	}
-	
 }
 
+AShooterPlayerState* AShooterGameState::FindPlayerStateById(int32 PlayerId) const
+{
+	if (PlayerId == INDEX_NONE)
+	{
+		return nullptr;
+	}
+
+	for (APlayerState* TestPlayerState : PlayerArray)
+	{
+		if (TestPlayerState && TestPlayerState->GetPlayerId() == PlayerId)
+		{
+			return Cast<AShooterPlayerState>(TestPlayerState);
+		}
+	}
+
+	return nullptr;
+}
 
 void AShooterGameState::RequestFinishAndExitToMainMenu()
 {
@@ -25,6 +25,8 @@ void AShooterPlayerState::Reset()
 	NumBulletsFired = 0;
 	NumRocketsFired = 0;
 	bQuitter = false;
+
+	InvalidateRanking();
 }
 
 void AShooterPlayerState::RegisterPlayerWithSession(bool bWasFromInvite)
@@ -55,11 +57,28 @@ void AShooterPlayerState::SetTeamNum(int32 NewTeamNumber)
 	TeamNumber = NewTeamNumber;
 
 	UpdateTeamColors();
+	InvalidateRanking();
 }
 
 void AShooterPlayerState::OnRep_TeamColor()
 {
 	UpdateTeamColors();
+	InvalidateRanking();
+}
+
+void AShooterPlayerState::OnRep_Score()
+{
+	Super::OnRep_Score();
+	InvalidateRanking();
+}
+
+void AShooterPlayerState::InvalidateRanking()
+{
+	AShooterGameState* const MyGameState = GetWorld() ? GetWorld()->GetGameState<AShooterGameState>() : nullptr;
+	if (MyGameState)
+	{
+		MyGameState->InvalidateRankedMaps();
+	}
 }
 
 void AShooterPlayerState::AddBulletsFired(int32 NumBullets)
@@ -167,42 +186,7 @@ void AShooterPlayerState::ScorePoints(int32 Points)
 	}
 
 	SetScore(GetScore() + Points);
-}
-
-void AShooterPlayerState::InformAboutKill_Implementation(class AShooterPlayerState* KillerPlayerState, const UDamageType* KillerDamageType, class AShooterPlayerState* KilledPlayerState)
-{
-	//id can be null for bots
-	if (KillerPlayerState->GetUniqueId().IsValid())
-	{	
-		//search for the actual killer before calling OnKill()	
-		for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
-		{		
-			AShooterPlayerController* TestPC = Cast<AShooterPlayerController>(*It);
-			if (TestPC && TestPC->IsLocalController())
-			{
-				// a local player might not have an ID if it was created with CreateDebugPlayer.
-				ULocalPlayer* LocalPlayer = Cast<ULocalPlayer>(TestPC->Player);
-				FUniqueNetIdRepl LocalID = LocalPlayer->GetCachedUniqueNetId();
-				if (LocalID.IsValid() &&  *LocalPlayer->GetCachedUniqueNetId() == *KillerPlayerState->GetUniqueId())
-				{			
-					TestPC->OnKill();
-				}
-			}
-		}
-	}
-}
-
-void AShooterPlayerState::BroadcastDeath_Implementation(class AShooterPlayerState* KillerPlayerState, const UDamageType* KillerDamageType, class AShooterPlayerState* KilledPlayerState)
-{	
-	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
-	{
-		// all local players get death messages so they can update their huds.
-		AShooterPlayerController* TestPC = Cast<AShooterPlayerController>(*It);
-		if (TestPC && TestPC->IsLocalController())
-		{
-			TestPC->OnDeathMessage(KillerPlayerState, this, KillerDamageType);				
-		}
-	}	
+	InvalidateRanking();
 }
 
 void AShooterPlayerState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
@@ -212,7 +196,7 @@ void AShooterPlayerState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>&
 	DOREPLIFETIME(AShooterPlayerState, TeamNumber);
 	DOREPLIFETIME(AShooterPlayerState, NumKills);
 	DOREPLIFETIME(AShooterPlayerState, NumDeaths);
-	DOREPLIFETIME(AShooterPlayerState, MatchId);
+	DOREPLIFETIME_CONDITION(AShooterPlayerState, MatchId, COND_SkipReplay);
 }
 
 FString AShooterPlayerState::GetShortPlayerName() const
@@ -40,6 +40,30 @@
 *		to simulated connections at a low, steady frequency, and to take advantage of serialization sharing. Auto proxy player states are replicated at higher frequency (to the
 *		owning connection only) via UShooterReplicationGraphNode_AlwaysRelevant_ForConnection.
 *		
+*		UShooterReplicationGraphNode_Projectiles_ForConnection
+*		Connection specific node for projectiles. Projectiles live for a couple of seconds at most, so putting them in the grid mostly buys channel open/close churn for
+*		connections that will never see them. This node returns only the closest projectiles within ShooterRepGraph.Projectiles.MaxDist of the viewers (capped per frame).
+*		Connections that never had a channel for a projectile get a single unreliable explosion event instead (UShooterReplicationGraph::OnProjectileExploded).
+*		
+*		UShooterReplicationGraphNode_TeamVisibility_ForConnection
+*		Connection specific node for pawn visibility. Teammates are always gathered (and never distance culled) for the connection. Enemies in grid range are
+*		checked against world geometry with a small per-frame budget of async traces; enemies that are hidden from every viewer replicate at a reduced rate.
+*		Results expire quickly (hidden sooner than visible) so a stale result can only ever make an enemy replicate at its normal rate.
+*		
+*		UShooterReplicationGraphNode_PrepareConnections
+*		Global node that never gathers anything. With ShooterRepGraph.ParallelGather, its PrepareForReplication works out the lists of all the ShooterGame
+*		connection nodes above (UShooterReplicationGraphNode_PreparedForConnection) in a ParallelFor, one task per connection, before the serial per connection
+*		gather starts. Tasks only read shared state and fill arrays owned by their own nodes. Rep lists (FActorRepListRefView storage comes from a
+*		game thread only allocator), ActorInfoMaps, async traces and stats are all written right after, on the game thread, in
+*		FinishPrepareForConnection. GatherActorListsForConnection then just hands out the prepared lists.
+*		
+*		UShooterReplayReplicationGraph
+*		Graph used by the demo net driver (see DefaultEngine.ini) so replay recording does not go through the legacy, per actor relevancy path.
+*		Nothing is spatialized: every actor goes into a single list for the demo connection. Update rates are recomputed for the demo record
+*		rate and scaled down (ShooterRepGraph.Replay.RateScale, ShooterRepGraph.Replay.PawnMaxHz). Recording cost shows up as the ReplayRecordMs CSV stat.
+*		Cosmetic replicated properties (weapon BurstCounter and HitNotify, LastTakeHitInfo, targeting/running/jetpack flags) are what a replay viewer
+*		watches, so they are recorded. Only state that never matters when watching is COND_SkipReplay (cheat flags, the online match id).
+*		
 *		UReplicationGraphNode_TearOff_ForConnection
 *		Connection specific node for handling tear off actors. This is created and managed in the base implementation of Replication Graph.
 *		
@@ -55,7 +79,7 @@
 *	
 *		Making something always relevant: Please avoid if you can :) If you must, just setting AActor::bAlwaysRelevant = true in the class defaults will do it.
 *		
-*		Making something always relevant to connection: You will need to modify UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection. You will also want 
+*		Making something always relevant to connection: You will need to modify UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::PrepareForConnection. You will also want 
 *		to make sure the actor does not get put in one of the other nodes. The safest way to do this is by setting its EClassRepNodeMapping to NotRouted in UShooterReplicationGraph::InitGlobalActorClassSettings.
 *
 *	How To Debug
@@ -73,6 +97,11 @@
 *		Net.RepGraph.PrintAllActorInfo <ActorMatchString> - will print the class, global, and connection replication info associated with an actor/class. If MatchString is empty will print everything. Call directly from client.
 *		
 *		ShooterRepGraph.PrintRouting - will print the EClassRepNodeMapping for each class. That is, how a given actor class is routed (or not) in the Replication Graph.
+*		
+*		ShooterRepGraph.Projectiles.Stats [reset] - will print projectile actor channel open/close counts and rates since the last reset. Also available as CSV stats (-csvprofile).
+*		
+*		UShooterTestControllerReplicationGraphLoad - a Gauntlet controller that loads a dedicated server with simulated connections, bots and projectiles and writes
+*		ServerReplicateActors time, actors and bytes per connection to a CSV (Saved/Profiling/RepGraphLoad). Runs headless: -gauntlet=ShooterTestControllerReplicationGraphLoad -nullrhi
 *	
 */
 
@@ -83,6 +112,8 @@
 #include "Engine/LevelStreaming.h"
 #include "EngineUtils.h"
 #include "CoreGlobals.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Async/ParallelFor.h"
 
 #if WITH_GAMEPLAY_DEBUGGER
 #include "GameplayDebuggerCategoryReplicator.h"
@@ -96,10 +127,13 @@
 #include "Player/ShooterCharacter.h"
 #include "Online/ShooterPlayerState.h"
 #include "Weapons/ShooterWeapon.h"
+#include "Weapons/ShooterProjectile.h"
 #include "Pickups/ShooterPickup.h"
 
 DEFINE_LOG_CATEGORY( LogShooterReplicationGraph );
 
+CSV_DEFINE_CATEGORY(ShooterRepGraph, true);
+
 float CVar_ShooterRepGraph_DestructionInfoMaxDist = 30000.f;
 static FAutoConsoleVariableRef CVarShooterRepGraphDestructMaxDist(TEXT("ShooterRepGraph.DestructInfo.MaxDist"), CVar_ShooterRepGraph_DestructionInfoMaxDist, TEXT("Max distance (not squared) to rep destruct infos at"), ECVF_Default );
 
@@ -124,6 +158,62 @@ static FAutoConsoleVariableRef CVarShooterRepDynamicActorFrequencyBuckets(TEXT("
 int32 CVar_ShooterRepGraph_DisableSpatialRebuilds = 1;
 static FAutoConsoleVariableRef CVarShooterRepDisableSpatialRebuilds(TEXT("ShooterRepGraph.DisableSpatialRebuilds"), CVar_ShooterRepGraph_DisableSpatialRebuilds, TEXT(""), ECVF_Default );
 
+int32 CVar_ShooterRepGraph_Occlusion_Enable = 1;
+static FAutoConsoleVariableRef CVarShooterRepGraphOcclusionEnable(TEXT("ShooterRepGraph.Occlusion.Enable"), CVar_ShooterRepGraph_Occlusion_Enable, TEXT("Reduce replication rate of enemy pawns hidden behind world geometry"), ECVF_Default );
+
+// Async visibility traces each connection may issue per frame. Enemies are traced round robin.
+int32 CVar_ShooterRepGraph_Occlusion_TracesPerConnection = 2;
+static FAutoConsoleVariableRef CVarShooterRepGraphOcclusionTracesPerConnection(TEXT("ShooterRepGraph.Occlusion.TracesPerConnection"), CVar_ShooterRepGraph_Occlusion_TracesPerConnection, TEXT("Async visibility traces per connection per frame"), ECVF_Default );
+
+// Minimum age of a result before it is traced again
+float CVar_ShooterRepGraph_Occlusion_RefreshInterval = 0.1f;
+static FAutoConsoleVariableRef CVarShooterRepGraphOcclusionRefreshInterval(TEXT("ShooterRepGraph.Occlusion.RefreshInterval"), CVar_ShooterRepGraph_Occlusion_RefreshInterval, TEXT("Seconds before a visibility result is traced again"), ECVF_Default );
+
+// A "hidden" result older than this is ignored (enemy treated as visible). Keep this short: enemies move.
+float CVar_ShooterRepGraph_Occlusion_HiddenTimeout = 0.25f;
+static FAutoConsoleVariableRef CVarShooterRepGraphOcclusionHiddenTimeout(TEXT("ShooterRepGraph.Occlusion.HiddenTimeout"), CVar_ShooterRepGraph_Occlusion_HiddenTimeout, TEXT("Seconds a hidden result is trusted"), ECVF_Default );
+
+// A "visible" result older than this is forgotten.
+float CVar_ShooterRepGraph_Occlusion_VisibleTimeout = 1.0f;
+static FAutoConsoleVariableRef CVarShooterRepGraphOcclusionVisibleTimeout(TEXT("ShooterRepGraph.Occlusion.VisibleTimeout"), CVar_ShooterRepGraph_Occlusion_VisibleTimeout, TEXT("Seconds a visible result is trusted"), ECVF_Default );
+
+// Hidden enemies replicate this many times less often than their class setting.
+int32 CVar_ShooterRepGraph_Occlusion_HiddenPeriodScale = 4;
+static FAutoConsoleVariableRef CVarShooterRepGraphOcclusionHiddenPeriodScale(TEXT("ShooterRepGraph.Occlusion.HiddenPeriodScale"), CVar_ShooterRepGraph_Occlusion_HiddenPeriodScale, TEXT("Replication period multiplier for hidden enemies"), ECVF_Default );
+
+// Replays (UShooterReplayReplicationGraph) update actors at NetUpdateFrequency * RateScale, and pawns at most at PawnMaxHz.
+float CVar_ShooterRepGraph_Replay_RateScale = 0.5f;
+static FAutoConsoleVariableRef CVarShooterRepGraphReplayRateScale(TEXT("ShooterRepGraph.Replay.RateScale"), CVar_ShooterRepGraph_Replay_RateScale, TEXT("Scale applied to NetUpdateFrequency when recording replays. Read when the demo net driver starts recording."), ECVF_Default );
+
+float CVar_ShooterRepGraph_Replay_PawnMaxHz = 4.f;
+static FAutoConsoleVariableRef CVarShooterRepGraphReplayPawnMaxHz(TEXT("ShooterRepGraph.Replay.PawnMaxHz"), CVar_ShooterRepGraph_Replay_PawnMaxHz, TEXT("Max update rate of pawns in replays. Read when the demo net driver starts recording."), ECVF_Default );
+
+// Prepare the ShooterGame connection nodes for all connections in parallel before gathering. 0 = prepare inline during each connection's gather.
+// Off until UShooterTestControllerReplicationGraphLoad shows it pays off: compare its ReplicateMs and PrepareMs with 0 and 1 at 16, 32, 64 and 100 connections.
+int32 CVar_ShooterRepGraph_ParallelGather = 0;
+static FAutoConsoleVariableRef CVarShooterRepGraphParallelGather(TEXT("ShooterRepGraph.ParallelGather"), CVar_ShooterRepGraph_ParallelGather, TEXT("Prepare per connection node lists in parallel"), ECVF_Default );
+
+// Below this many connections the prepare pass runs on the game thread only. Task overhead is not worth it.
+int32 CVar_ShooterRepGraph_ParallelGather_MinConnections = 8;
+static FAutoConsoleVariableRef CVarShooterRepGraphParallelGatherMinConnections(TEXT("ShooterRepGraph.ParallelGather.MinConnections"), CVar_ShooterRepGraph_ParallelGather_MinConnections, TEXT("Min connections before the prepare pass goes wide"), ECVF_Default );
+
+// Projectiles further than this from every viewer of a connection are never gathered for it.
+float CVar_ShooterRepGraph_Projectiles_MaxDist = 8000.f;
+static FAutoConsoleVariableRef CVarShooterRepGraphProjectilesMaxDist(TEXT("ShooterRepGraph.Projectiles.MaxDist"), CVar_ShooterRepGraph_Projectiles_MaxDist, TEXT("Max distance (not squared) at which projectiles are replicated to a connection"), ECVF_Default );
+
+// Upper bound on projectiles returned per connection per frame. The closest ones win.
+int32 CVar_ShooterRepGraph_Projectiles_MaxPerConnection = 24;
+static FAutoConsoleVariableRef CVarShooterRepGraphProjectilesMaxPerConnection(TEXT("ShooterRepGraph.Projectiles.MaxPerConnection"), CVar_ShooterRepGraph_Projectiles_MaxPerConnection, TEXT("Max projectiles gathered per connection per frame"), ECVF_Default );
+
+// Projectiles that already have a channel on a connection compete for the per connection cap as if they were this much closer (distance scale).
+// Keeps the set stable at the cap boundary instead of swapping channels back and forth between projectiles at similar distances.
+float CVar_ShooterRepGraph_Projectiles_OpenChannelBias = 0.75f;
+static FAutoConsoleVariableRef CVarShooterRepGraphProjectilesOpenChannelBias(TEXT("ShooterRepGraph.Projectiles.OpenChannelBias"), CVar_ShooterRepGraph_Projectiles_OpenChannelBias, TEXT("Distance scale applied to projectiles with an open channel when picking the closest ones. 1 = no hysteresis."), ECVF_Default );
+
+// Connections without a channel for an exploding projectile get an explosion event if they are within this distance.
+float CVar_ShooterRepGraph_Projectiles_ExplosionEventMaxDist = 15000.f;
+static FAutoConsoleVariableRef CVarShooterRepGraphProjectilesExplosionEventMaxDist(TEXT("ShooterRepGraph.Projectiles.ExplosionEventMaxDist"), CVar_ShooterRepGraph_Projectiles_ExplosionEventMaxDist, TEXT("Max distance (not squared) to send explosion events for projectiles that were not replicated"), ECVF_Default );
+
 // ----------------------------------------------------------------------------------------------------------
 
 
@@ -156,6 +246,8 @@ void UShooterReplicationGraph::ResetGameWorldState()
 	Super::ResetGameWorldState();
 
 	AlwaysRelevantStreamingLevelActors.Empty();
+	CharacterActors.Reset();
+	ProjectileActors.Reset();
 
 	for (UNetReplicationGraphConnection* ConnManager : Connections)
 	{
@@ -165,6 +257,10 @@ void UShooterReplicationGraph::ResetGameWorldState()
 			{
 				AlwaysRelevantConnectionNode->ResetGameWorldState();
 			}
+			else if (UShooterReplicationGraphNode_TeamVisibility_ForConnection* TeamVisibilityConnectionNode = Cast<UShooterReplicationGraphNode_TeamVisibility_ForConnection>(ConnectionNode))
+			{
+				TeamVisibilityConnectionNode->ResetGameWorldState();
+			}
 		}
 	}
 
@@ -176,6 +272,10 @@ void UShooterReplicationGraph::ResetGameWorldState()
 			{
 				AlwaysRelevantConnectionNode->ResetGameWorldState();
 			}
+			else if (UShooterReplicationGraphNode_TeamVisibility_ForConnection* TeamVisibilityConnectionNode = Cast<UShooterReplicationGraphNode_TeamVisibility_ForConnection>(ConnectionNode))
+			{
+				TeamVisibilityConnectionNode->ResetGameWorldState();
+			}
 		}
 	}
 }
@@ -196,6 +296,7 @@ void UShooterReplicationGraph::InitGlobalActorClassSettings()
 	AddInfo( AReplicationGraphDebugActor::StaticClass(),			EClassRepNodeMapping::NotRouted);				// Not needed. Replicated special case inside RepGraph
 	AddInfo( AInfo::StaticClass(),									EClassRepNodeMapping::RelevantAllConnections);	// Non spatialized, relevant to all
 	AddInfo( AShooterPickup::StaticClass(),							EClassRepNodeMapping::Spatialize_Static);		// Spatialized and never moves. Routes to GridNode.
+	AddInfo( AShooterProjectile::StaticClass(),						EClassRepNodeMapping::Projectile);				// Short lived. Gathered per connection via UShooterReplicationGraphNode_Projectiles_ForConnection
 
 #if WITH_GAMEPLAY_DEBUGGER
 	AddInfo( AGameplayDebuggerCategoryReplicator::StaticClass(),	EClassRepNodeMapping::NotRouted);				// Replicated via UShooterReplicationGraphNode_AlwaysRelevant_ForConnection
@@ -288,6 +389,16 @@ void UShooterReplicationGraph::InitGlobalActorClassSettings()
 	PlayerStateRepInfo.DistancePriorityScale = 0.f;
 	PlayerStateRepInfo.ActorChannelFrameTimeout = 0;
 	SetClassInfo( APlayerState::StaticClass(), PlayerStateRepInfo );
+
+	// Projectiles fly straight and are simulated on clients, so once the channel is open they only need the occasional update.
+	// Keep the channel for a few frames after it stops being gathered: a projectile that drops just past the per connection cap
+	// usually comes back a frame later, and reopening costs more than holding the channel.
+	FClassReplicationInfo ProjectileRepInfo;
+	InitClassReplicationInfo(ProjectileRepInfo, AShooterProjectile::StaticClass(), false, NetDriver->NetServerMaxTickRate);
+	ProjectileRepInfo.DistancePriorityScale = 1.f;
+	ProjectileRepInfo.StarvationPriorityScale = 1.f;
+	ProjectileRepInfo.ActorChannelFrameTimeout = 4;
+	SetClassInfo( AShooterProjectile::StaticClass(), ProjectileRepInfo );
 	
 	UReplicationGraphNode_ActorListFrequencyBuckets::DefaultSettings.ListSize = 12;
 
@@ -350,6 +461,7 @@ void UShooterReplicationGraph::InitGlobalActorClassSettings()
 	
 	AShooterCharacter::NotifyEquipWeapon.AddUObject(this, &UShooterReplicationGraph::OnCharacterEquipWeapon);
 	AShooterCharacter::NotifyUnEquipWeapon.AddUObject(this, &UShooterReplicationGraph::OnCharacterUnEquipWeapon);
+	AShooterProjectile::NotifyExploded.AddUObject(this, &UShooterReplicationGraph::OnProjectileExploded);
 
 #if WITH_GAMEPLAY_DEBUGGER
 	AGameplayDebuggerCategoryReplicator::NotifyDebuggerOwnerChange.AddUObject(this, &UShooterReplicationGraph::OnGameplayDebuggerOwnerChange);
@@ -384,6 +496,12 @@ void UShooterReplicationGraph::InitGlobalGraphNodes()
 	// -----------------------------------------------
 	UShooterReplicationGraphNode_PlayerStateFrequencyLimiter* PlayerStateNode = CreateNewNode<UShooterReplicationGraphNode_PlayerStateFrequencyLimiter>();
 	AddGlobalGraphNode(PlayerStateNode);
+
+	// -----------------------------------------------
+	//	Builds the connection specific node lists ahead of gathering, in parallel
+	// -----------------------------------------------
+	UShooterReplicationGraphNode_PrepareConnections* PrepareConnectionsNode = CreateNewNode<UShooterReplicationGraphNode_PrepareConnections>();
+	AddGlobalGraphNode(PrepareConnectionsNode);
 }
 
 void UShooterReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
@@ -397,6 +515,12 @@ void UShooterReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConn
 	RepGraphConnection->OnClientVisibleLevelNameRemove.AddUObject(AlwaysRelevantConnectionNode, &UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::OnClientLevelVisibilityRemove);
 
 	AddConnectionGraphNode(AlwaysRelevantConnectionNode, RepGraphConnection);
+
+	UShooterReplicationGraphNode_TeamVisibility_ForConnection* TeamVisibilityConnectionNode = CreateNewNode<UShooterReplicationGraphNode_TeamVisibility_ForConnection>();
+	AddConnectionGraphNode(TeamVisibilityConnectionNode, RepGraphConnection);
+
+	UShooterReplicationGraphNode_Projectiles_ForConnection* ProjectilesConnectionNode = CreateNewNode<UShooterReplicationGraphNode_Projectiles_ForConnection>();
+	AddConnectionGraphNode(ProjectilesConnectionNode, RepGraphConnection);
 }
 
 EClassRepNodeMapping UShooterReplicationGraph::GetMappingPolicy(UClass* Class)
@@ -430,6 +554,12 @@ void UShooterReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedA
 			break;
 		}
 
+		case EClassRepNodeMapping::Projectile:
+		{
+			ProjectileActors.ConditionalAdd(ActorInfo.Actor);
+			break;
+		}
+
 		case EClassRepNodeMapping::Spatialize_Static:
 		{
 			GridNode->AddActor_Static(ActorInfo, GlobalInfo);
@@ -448,6 +578,11 @@ void UShooterReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedA
 			break;
 		}
 	};
+
+	if (ActorInfo.Class->IsChildOf(AShooterCharacter::StaticClass()))
+	{
+		CharacterActors.ConditionalAdd(ActorInfo.Actor);
+	}
 }
 
 void UShooterReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
@@ -477,6 +612,15 @@ void UShooterReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicat
 			break;
 		}
 
+		case EClassRepNodeMapping::Projectile:
+		{
+			if (ProjectileActors.RemoveFast(ActorInfo.Actor) == false)
+			{
+				UE_LOG(LogShooterReplicationGraph, Warning, TEXT("Actor %s was not found in ProjectileActors list."), *GetActorRepListTypeDebugString(ActorInfo.Actor));
+			}
+			break;
+		}
+
 		case EClassRepNodeMapping::Spatialize_Static:
 		{
 			GridNode->RemoveActor_Static(ActorInfo);
@@ -495,6 +639,20 @@ void UShooterReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicat
 			break;
 		}
 	};
+
+	if (ActorInfo.Class->IsChildOf(AShooterCharacter::StaticClass()))
+	{
+		CharacterActors.RemoveFast(ActorInfo.Actor);
+	}
+}
+
+int32 UShooterReplicationGraph::ServerReplicateActors(float DeltaSeconds)
+{
+	const double StartTime = FPlatformTime::Seconds();
+	const int32 Result = Super::ServerReplicateActors(DeltaSeconds);
+	LastServerReplicateActorsSeconds = FPlatformTime::Seconds() - StartTime;
+
+	return Result;
 }
 
 // Since we listen to global (static) events, we need to watch out for cross world broadcasts (PIE)
@@ -524,6 +682,53 @@ void UShooterReplicationGraph::OnCharacterUnEquipWeapon(AShooterCharacter* Chara
 	}
 }
 
+void UShooterReplicationGraph::OnProjectileExploded(AShooterProjectile* Projectile, const FHitResult& Impact)
+{
+	if (Projectile == nullptr || Projectile->GetExplosionTemplate() == nullptr)
+	{
+		return;
+	}
+
+	CHECK_WORLDS(Projectile);
+
+	QUICK_SCOPE_CYCLE_COUNTER( UShooterReplicationGraph_OnProjectileExploded );
+
+	const float MaxDistSq = CVar_ShooterRepGraph_Projectiles_ExplosionEventMaxDist * CVar_ShooterRepGraph_Projectiles_ExplosionEventMaxDist;
+
+	for (UNetReplicationGraphConnection* ConnManager : Connections)
+	{
+		// Connections with an open channel get bExploded the normal way
+		FConnectionReplicationActorInfo* ConnectionActorInfo = ConnManager->ActorInfoMap.Find(Projectile);
+		if (ConnectionActorInfo && ConnectionActorInfo->Channel)
+		{
+			continue;
+		}
+
+		UNetConnection* NetConnection = ConnManager->NetConnection;
+		AShooterPlayerController* PC = NetConnection ? Cast<AShooterPlayerController>(NetConnection->PlayerController) : nullptr;
+		if (PC == nullptr)
+		{
+			continue;
+		}
+
+		// Split screen players share the connection (and its world on the client), so one event is enough if any of them is in range
+		bool bInRange = FVector::DistSquared(FNetViewer(NetConnection, 0.f).ViewLocation, Impact.ImpactPoint) <= MaxDistSq;
+		for (int32 ChildIdx = 0; !bInRange && ChildIdx < NetConnection->Children.Num(); ++ChildIdx)
+		{
+			UChildConnection* Child = NetConnection->Children[ChildIdx];
+			if (Child && Child->ViewTarget)
+			{
+				bInRange = FVector::DistSquared(FNetViewer(Child, 0.f).ViewLocation, Impact.ImpactPoint) <= MaxDistSq;
+			}
+		}
+
+		if (bInRange)
+		{
+			PC->ClientPlayProjectileExplosion(Projectile->GetExplosionTemplate(), Impact.ImpactPoint, Impact.ImpactNormal);
+		}
+	}
+}
+
 #if WITH_GAMEPLAY_DEBUGGER
 void UShooterReplicationGraph::OnGameplayDebuggerOwnerChange(AGameplayDebuggerCategoryReplicator* Debugger, APlayerController* OldOwner)
 {
@@ -564,35 +769,153 @@ void UShooterReplicationGraph::OnGameplayDebuggerOwnerChange(AGameplayDebuggerCa
 
 // ------------------------------------------------------------------------------
 
+void UShooterReplayReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	// Every projectile is recorded, so explosions already come through bExploded. Explosion events would only be extra RPCs in the replay.
+	AShooterProjectile::NotifyExploded.RemoveAll(this);
+
+	// Replication periods are counted in demo record frames, not server ticks. Recompute them from the legacy update frequencies at the record rate,
+	// then scale down: a replay looks fine with far fewer updates than a live client needs, and pawns are the bulk of the recording cost.
+	static IConsoleVariable* DemoRecordHzCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("demo.RecordHz"));
+	const float RecordHz = FMath::Max(DemoRecordHzCVar ? DemoRecordHzCVar->GetFloat() : NetDriver->NetServerMaxTickRate, 1.f);
+
+	for (auto ClassRepInfoIt = GlobalActorReplicationInfoMap.CreateClassMapIterator(); ClassRepInfoIt; ++ClassRepInfoIt)
+	{
+		UClass* Class = CastChecked<UClass>(ClassRepInfoIt.Key().ResolveObjectPtr());
+		FClassReplicationInfo& ClassInfo = ClassRepInfoIt.Value();
+
+		float ReplayHz = Class->GetDefaultObject<AActor>()->NetUpdateFrequency * CVar_ShooterRepGraph_Replay_RateScale;
+		if (Class->IsChildOf(APawn::StaticClass()))
+		{
+			ReplayHz = FMath::Min(ReplayHz, CVar_ShooterRepGraph_Replay_PawnMaxHz);
+		}
+
+		ClassInfo.ReplicationPeriodFrame = FMath::Max<uint32>((uint32)FMath::RoundToFloat(RecordHz / FMath::Max(ReplayHz, KINDA_SMALL_NUMBER)), 1);
+
+		// Everything is always relevant to the demo connection, distance only matters for priority
+		ClassInfo.SetCullDistanceSquared(0.f);
+	}
+
+	UE_LOG(LogShooterReplicationGraph, Log, TEXT("Replay replication periods computed for %.1f record Hz (RateScale %.2f, PawnMaxHz %.1f)"), RecordHz, CVar_ShooterRepGraph_Replay_RateScale, CVar_ShooterRepGraph_Replay_PawnMaxHz);
+}
+
+void UShooterReplayReplicationGraph::InitGlobalGraphNodes()
+{
+	// No grid: replays must contain every actor regardless of where the demo spectator is
+	ReplayActorsNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(ReplayActorsNode);
+
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+
+	UShooterReplicationGraphNode_PlayerStateFrequencyLimiter* PlayerStateNode = CreateNewNode<UShooterReplicationGraphNode_PlayerStateFrequencyLimiter>();
+	AddGlobalGraphNode(PlayerStateNode);
+}
+
+void UShooterReplayReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+	// Skip the live per connection nodes: team visibility and projectile distance limits make no sense for a replay, only the always relevant node is needed
+	UReplicationGraph::InitConnectionGraphNodes(RepGraphConnection);
+
+	UShooterReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantConnectionNode = CreateNewNode<UShooterReplicationGraphNode_AlwaysRelevant_ForConnection>();
+
+	RepGraphConnection->OnClientVisibleLevelNameAdd.AddUObject(AlwaysRelevantConnectionNode, &UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::OnClientLevelVisibilityAdd);
+	RepGraphConnection->OnClientVisibleLevelNameRemove.AddUObject(AlwaysRelevantConnectionNode, &UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::OnClientLevelVisibilityRemove);
+
+	AddConnectionGraphNode(AlwaysRelevantConnectionNode, RepGraphConnection);
+}
+
+void UShooterReplayReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	const EClassRepNodeMapping Policy = GetMappingPolicy(ActorInfo.Class);
+	if (IsSpatialized(Policy) || Policy == EClassRepNodeMapping::Projectile)
+	{
+		ReplayActorsNode->NotifyAddNetworkActor(ActorInfo);
+		return;
+	}
+
+	Super::RouteAddNetworkActorToNodes(ActorInfo, GlobalInfo);
+}
+
+void UShooterReplayReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	const EClassRepNodeMapping Policy = GetMappingPolicy(ActorInfo.Class);
+	if (IsSpatialized(Policy) || Policy == EClassRepNodeMapping::Projectile)
+	{
+		ReplayActorsNode->NotifyRemoveNetworkActor(ActorInfo);
+		return;
+	}
+
+	Super::RouteRemoveNetworkActorToNodes(ActorInfo);
+}
+
+int32 UShooterReplayReplicationGraph::ServerReplicateActors(float DeltaSeconds)
+{
+	const int32 Result = Super::ServerReplicateActors(DeltaSeconds);
+
+	// Recording cost per demo frame, next to the live graph's frame time in -csvprofile captures
+	CSV_CUSTOM_STAT(ShooterRepGraph, ReplayRecordMs, (float)(LastServerReplicateActorsSeconds * 1000.0), ECsvCustomStatOp::Set);
+
+	return Result;
+}
+
+// ------------------------------------------------------------------------------
+
+void UShooterReplicationGraphNode_PreparedForConnection::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	if (PreparedFrameNum != Params.ReplicationFrameNum)
+	{
+		// Not prepared ahead of time this frame (parallel gather disabled, or the connection was skipped). Do it inline.
+		const FShooterConnectionPrepareParams PrepareParams(Params.Viewers, Params.ConnectionManager, Params.ReplicationFrameNum);
+		PrepareForConnection(PrepareParams);
+		FinishPrepareForConnection(PrepareParams);
+		MarkPrepared(Params.ReplicationFrameNum);
+	}
+
+	GatherPreparedLists(Params);
+}
+
+// ------------------------------------------------------------------------------
+
 void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::ResetGameWorldState()
 {
 	AlwaysRelevantStreamingLevelsNeedingReplication.Empty();
 }
 
-void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::PrepareForConnection(const FShooterConnectionPrepareParams& Params)
 {
-	QUICK_SCOPE_CYCLE_COUNTER( UShooterReplicationGraphNode_AlwaysRelevant_ForConnection_GatherActorListsForConnection );
+	QUICK_SCOPE_CYCLE_COUNTER( UShooterReplicationGraphNode_AlwaysRelevant_ForConnection_PrepareForConnection );
 
 	UShooterReplicationGraph* ShooterGraph = CastChecked<UShooterReplicationGraph>(GetOuter());
 
-	ReplicationActorList.Reset();
+	PreparedActors.Reset();
+	PreparedCullDistanceResets.Reset();
+	PreparedPlayerStateInit = nullptr;
+	PreparedStreamingLevels.Reset();
+
+	auto ConditionalAdd = [&](AActor* Actor) {
+
+		if (Actor)
+		{
+			PreparedActors.Add(Actor);
+		}
+	};
 
 	auto ResetActorCullDistance = [&](AActor* ActorToSet, AActor*& LastActor) {
 
 		if (ActorToSet != LastActor)
 		{
 			LastActor = ActorToSet;
-
-			UE_LOG(LogShooterReplicationGraph, Verbose, TEXT("Setting pawn cull distance to 0. %s"), *ActorToSet->GetName());
-			FConnectionReplicationActorInfo& ConnectionActorInfo = Params.ConnectionManager.ActorInfoMap.FindOrAdd(ActorToSet);
-			ConnectionActorInfo.SetCullDistanceSquared(0.f);
+			PreparedCullDistanceResets.Add(ActorToSet);
 		}
 	};
 
 	for (const FNetViewer& CurViewer : Params.Viewers)
 	{
-		ReplicationActorList.ConditionalAdd(CurViewer.InViewer);
-		ReplicationActorList.ConditionalAdd(CurViewer.ViewTarget);
+		ConditionalAdd(CurViewer.InViewer);
+		ConditionalAdd(CurViewer.ViewTarget);
 
 		if (AShooterPlayerController* PC = Cast<AShooterPlayerController>(CurViewer.InViewer))
 		{
@@ -606,11 +929,10 @@ void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorLists
 					if (!bInitializedPlayerState)
 					{
 						bInitializedPlayerState = true;
-						FConnectionReplicationActorInfo& ConnectionActorInfo = Params.ConnectionManager.ActorInfoMap.FindOrAdd(PS);
-						ConnectionActorInfo.ReplicationPeriodFrame = 1;
+						PreparedPlayerStateInit = PS;
 					}
 
-					ReplicationActorList.ConditionalAdd(PS);
+					ConditionalAdd(PS);
 				}
 			}
 
@@ -632,7 +954,7 @@ void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorLists
 
 				if (Pawn != CurViewer.ViewTarget)
 				{
-					ReplicationActorList.ConditionalAdd(Pawn);
+					ConditionalAdd(Pawn);
 				}
 
 				int32 InventoryCount = Pawn->GetInventoryCount();
@@ -641,7 +963,7 @@ void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorLists
 					AShooterWeapon* Weapon = Pawn->GetInventoryWeapon(i);
 					if (Weapon)
 					{
-						ReplicationActorList.ConditionalAdd(Weapon);
+						ConditionalAdd(Weapon);
 					}
 				}
 			}
@@ -657,18 +979,20 @@ void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorLists
 		return RelActorInfo.Connection == nullptr;
 	});
 
-	Params.OutGatheredReplicationLists.AddReplicationActorList(ReplicationActorList);
+#if WITH_GAMEPLAY_DEBUGGER
+	ConditionalAdd(GameplayDebugger);
+#endif
 
-	// Always relevant streaming level actors.
+	// Always relevant streaming level actors. Read only lookups: actors without an entry are not dormant on the connection.
 	FPerConnectionActorInfoMap& ConnectionActorInfoMap = Params.ConnectionManager.ActorInfoMap;
 	
-	TMap<FName, FActorRepListRefView>& AlwaysRelevantStreamingLevelActors = ShooterGraph->AlwaysRelevantStreamingLevelActors;
+	const TMap<FName, FActorRepListRefView>& AlwaysRelevantStreamingLevelActors = ShooterGraph->AlwaysRelevantStreamingLevelActors;
 
 	for (int32 Idx=AlwaysRelevantStreamingLevelsNeedingReplication.Num()-1; Idx >= 0; --Idx)
 	{
 		const FName& StreamingLevel = AlwaysRelevantStreamingLevelsNeedingReplication[Idx];
 
-		FActorRepListRefView* Ptr = AlwaysRelevantStreamingLevelActors.Find(StreamingLevel);
+		const FActorRepListRefView* Ptr = AlwaysRelevantStreamingLevelActors.Find(StreamingLevel);
 		if (Ptr == nullptr)
 		{
 			// No always relevant lists for that level
@@ -677,15 +1001,15 @@ void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorLists
 			continue;
 		}
 
-		FActorRepListRefView& RepList = *Ptr;
+		const FActorRepListRefView& RepList = *Ptr;
 
 		if (RepList.Num() > 0)
 		{
 			bool bAllDormant = true;
 			for (FActorRepListType Actor : RepList)
 			{
-				FConnectionReplicationActorInfo& ConnectionActorInfo = ConnectionActorInfoMap.FindOrAdd(Actor);
-				if (ConnectionActorInfo.bDormantOnConnection == false)
+				const FConnectionReplicationActorInfo* ConnectionActorInfo = ConnectionActorInfoMap.Find(Actor);
+				if (ConnectionActorInfo == nullptr || ConnectionActorInfo->bDormantOnConnection == false)
 				{
 					bAllDormant = false;
 					break;
@@ -700,22 +1024,55 @@ void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorLists
 			else
 			{
 				UE_CLOG(CVar_ShooterRepGraph_DisplayClientLevelStreaming > 0, LogShooterReplicationGraph, Display, TEXT("CLIENTSTREAMING Adding always Actors on StreamingLevel %s for %s because it has at least one non dormant actor"), *StreamingLevel.ToString(), *Params.ConnectionManager.GetName());
-				Params.OutGatheredReplicationLists.AddReplicationActorList(RepList);
+				PreparedStreamingLevels.Add(StreamingLevel);
 			}
 		}
 		else
 		{
-			UE_LOG(LogShooterReplicationGraph, Warning, TEXT("UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection - empty RepList %s"), *Params.ConnectionManager.GetName());
+			UE_LOG(LogShooterReplicationGraph, Warning, TEXT("UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::PrepareForConnection - empty RepList %s"), *Params.ConnectionManager.GetName());
 		}
 
 	}
+}
 
-#if WITH_GAMEPLAY_DEBUGGER
-	if (GameplayDebugger)
+void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::FinishPrepareForConnection(const FShooterConnectionPrepareParams& Params)
+{
+	FPerConnectionActorInfoMap& ConnectionActorInfoMap = Params.ConnectionManager.ActorInfoMap;
+
+	ReplicationActorList.Reset();
+	for (AActor* Actor : PreparedActors)
 	{
-		ReplicationActorList.ConditionalAdd(GameplayDebugger);
+		ReplicationActorList.Add(Actor);
+	}
+
+	for (AActor* Actor : PreparedCullDistanceResets)
+	{
+		UE_LOG(LogShooterReplicationGraph, Verbose, TEXT("Setting pawn cull distance to 0. %s"), *Actor->GetName());
+		FConnectionReplicationActorInfo& ConnectionActorInfo = ConnectionActorInfoMap.FindOrAdd(Actor);
+		ConnectionActorInfo.SetCullDistanceSquared(0.f);
+	}
+
+	if (PreparedPlayerStateInit)
+	{
+		FConnectionReplicationActorInfo& ConnectionActorInfo = ConnectionActorInfoMap.FindOrAdd(PreparedPlayerStateInit);
+		ConnectionActorInfo.ReplicationPeriodFrame = 1;
+	}
+}
+
+void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::GatherPreparedLists(const FConnectionGatherActorListParameters& Params)
+{
+	UShooterReplicationGraph* ShooterGraph = CastChecked<UShooterReplicationGraph>(GetOuter());
+
+	Params.OutGatheredReplicationLists.AddReplicationActorList(ReplicationActorList);
+
+	// Looked up again rather than cached: the map may have been modified since the lists were prepared
+	for (const FName& StreamingLevel : PreparedStreamingLevels)
+	{
+		if (FActorRepListRefView* RepList = ShooterGraph->AlwaysRelevantStreamingLevelActors.Find(StreamingLevel))
+		{
+			Params.OutGatheredReplicationLists.AddReplicationActorList(*RepList);
+		}
 	}
-#endif
 }
 
 void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::OnClientLevelVisibilityAdd(FName LevelName, UWorld* StreamingWorld)
@@ -750,6 +1107,486 @@ void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::LogNode(FReplica
 
 // ------------------------------------------------------------------------------
 
+void UShooterReplicationGraphNode_TeamVisibility_ForConnection::ResetGameWorldState()
+{
+	EnemyVisibility.Empty();
+	PendingTraces.Empty();
+	TraceCursor = 0;
+}
+
+void UShooterReplicationGraphNode_TeamVisibility_ForConnection::PrepareForConnection(const FShooterConnectionPrepareParams& Params)
+{
+	QUICK_SCOPE_CYCLE_COUNTER( UShooterReplicationGraphNode_TeamVisibility_ForConnection_PrepareForConnection );
+
+	UShooterReplicationGraph* ShooterGraph = CastChecked<UShooterReplicationGraph>(GetOuter());
+	UWorld* World = GetWorld();
+
+	PreparedPawns.Reset();
+	TraceRequests.Reset();
+	NumHiddenEnemies = 0;
+
+	if (World == nullptr || Params.Viewers.Num() == 0)
+	{
+		return;
+	}
+
+	const APlayerController* ViewerPC = Cast<APlayerController>(Params.Viewers[0].InViewer);
+	const AShooterPlayerState* ViewerPS = ViewerPC ? Cast<AShooterPlayerState>(ViewerPC->PlayerState) : nullptr;
+	const AShooterGameState* GameState = World->GetGameState<AShooterGameState>();
+	const bool bTeamGame = GameState && GameState->NumTeams > 1;
+
+	const bool bOcclusionEnabled = CVar_ShooterRepGraph_Occlusion_Enable > 0;
+	const float Now = World->GetTimeSeconds();
+	int32 TraceBudget = CVar_ShooterRepGraph_Occlusion_TracesPerConnection;
+
+	const FGlobalActorReplicationInfoMap& GlobalActorReplicationInfoMap = *GraphGlobals->GlobalActorReplicationInfoMap;
+
+	const int32 NumCharacters = ShooterGraph->CharacterActors.Num();
+	for (int32 Offset = 0; Offset < NumCharacters; ++Offset)
+	{
+		AShooterCharacter* Character = Cast<AShooterCharacter>(ShooterGraph->CharacterActors[(TraceCursor + Offset) % NumCharacters]);
+		if (Character == nullptr || IsActorValidForReplicationGather(Character) == false)
+		{
+			continue;
+		}
+
+		// The viewer's own pawn and view target are handled by UShooterReplicationGraphNode_AlwaysRelevant_ForConnection
+		bool bIsViewer = false;
+		for (const FNetViewer& CurViewer : Params.Viewers)
+		{
+			const APlayerController* PC = Cast<APlayerController>(CurViewer.InViewer);
+			if (CurViewer.ViewTarget == Character || (PC && PC->GetPawn() == Character))
+			{
+				bIsViewer = true;
+				break;
+			}
+		}
+
+		if (bIsViewer)
+		{
+			continue;
+		}
+
+		const FGlobalActorReplicationInfo* GlobalInfo = GlobalActorReplicationInfoMap.Find(Character);
+		if (GlobalInfo == nullptr)
+		{
+			continue;
+		}
+
+		const AShooterPlayerState* PS = Cast<AShooterPlayerState>(Character->GetPlayerState());
+		if (bTeamGame && ViewerPS && PS && PS->GetTeamNum() == ViewerPS->GetTeamNum())
+		{
+			PreparedPawns.Add({ Character, 0.f, GlobalInfo->Settings.ReplicationPeriodFrame, true });
+			continue;
+		}
+
+		FShooterPreparedPawnSettings& PawnSettings = PreparedPawns[PreparedPawns.Add({ Character, GlobalInfo->Settings.GetCullDistanceSquared(), GlobalInfo->Settings.ReplicationPeriodFrame, false })];
+
+		if (!bOcclusionEnabled)
+		{
+			continue;
+		}
+
+		// Only enemies the grid can return are worth tracing
+		const FVector TargetLocation = Character->GetPawnViewLocation();
+		const FNetViewer* ClosestViewer = nullptr;
+		float ClosestDistSq = MAX_flt;
+		for (const FNetViewer& CurViewer : Params.Viewers)
+		{
+			const float DistSq = FVector::DistSquared(CurViewer.ViewLocation, TargetLocation);
+			if (DistSq < ClosestDistSq)
+			{
+				ClosestDistSq = DistSq;
+				ClosestViewer = &CurViewer;
+			}
+		}
+
+		const float CullDistSq = GlobalInfo->Settings.GetCullDistanceSquared();
+		if (ClosestViewer == nullptr || (CullDistSq > 0.f && ClosestDistSq > CullDistSq))
+		{
+			continue;
+		}
+
+		// Read only here: enemies without an entry have no result yet, FinishPrepareForConnection adds one when their trace goes out
+		const FShooterEnemyVisibilityInfo DefaultVisibilityInfo;
+		const FShooterEnemyVisibilityInfo* FoundVisibilityInfo = EnemyVisibility.Find(FObjectKey(Character));
+		const FShooterEnemyVisibilityInfo& VisibilityInfo = FoundVisibilityInfo ? *FoundVisibilityInfo : DefaultVisibilityInfo;
+		const float ResultAge = Now - VisibilityInfo.LastResultTime;
+		const float Timeout = VisibilityInfo.bVisible ? CVar_ShooterRepGraph_Occlusion_VisibleTimeout : CVar_ShooterRepGraph_Occlusion_HiddenTimeout;
+		const bool bResultValid = VisibilityInfo.LastResultTime >= 0.f && ResultAge <= Timeout;
+
+		if (VisibilityInfo.PendingTraceId == 0 && TraceBudget > 0 && (!bResultValid || ResultAge >= CVar_ShooterRepGraph_Occlusion_RefreshInterval))
+		{
+			--TraceBudget;
+			TraceRequests.Add({ Character, ClosestViewer->ViewTarget, ClosestViewer->ViewLocation, TargetLocation });
+		}
+
+		if (bResultValid && !VisibilityInfo.bVisible)
+		{
+			PawnSettings.ReplicationPeriodFrame = FMath::Max<uint32>(GlobalInfo->Settings.ReplicationPeriodFrame * CVar_ShooterRepGraph_Occlusion_HiddenPeriodScale, 1);
+			++NumHiddenEnemies;
+		}
+	}
+}
+
+void UShooterReplicationGraphNode_TeamVisibility_ForConnection::FinishPrepareForConnection(const FShooterConnectionPrepareParams& Params)
+{
+	UShooterReplicationGraph* ShooterGraph = CastChecked<UShooterReplicationGraph>(GetOuter());
+	UWorld* World = GetWorld();
+
+	ReplicationActorList.Reset();
+
+	FPerConnectionActorInfoMap& ConnectionActorInfoMap = Params.ConnectionManager.ActorInfoMap;
+	for (const FShooterPreparedPawnSettings& PawnSettings : PreparedPawns)
+	{
+		FConnectionReplicationActorInfo& ConnectionActorInfo = ConnectionActorInfoMap.FindOrAdd(PawnSettings.Pawn);
+		ConnectionActorInfo.SetCullDistanceSquared(PawnSettings.CullDistanceSquared);
+		ConnectionActorInfo.ReplicationPeriodFrame = PawnSettings.ReplicationPeriodFrame;
+
+		if (PawnSettings.bTeammate)
+		{
+			ReplicationActorList.Add(PawnSettings.Pawn);
+		}
+	}
+
+	PreparedPawns.Reset();
+
+	const int32 NumCharacters = ShooterGraph->CharacterActors.Num();
+	TraceCursor = NumCharacters > 0 ? (TraceCursor + 1) % NumCharacters : 0;
+
+	if (World == nullptr)
+	{
+		TraceRequests.Reset();
+		return;
+	}
+
+	// Async traces can only be issued from the game thread
+	for (const FShooterVisibilityTraceRequest& Request : TraceRequests)
+	{
+		const uint32 TraceId = NextTraceId++;
+		if (NextTraceId == 0)
+		{
+			NextTraceId = 1;
+		}
+
+		FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(ShooterRepGraphVisibility), false);
+		TraceParams.AddIgnoredActor(Request.Enemy);
+		TraceParams.AddIgnoredActor(Request.ViewTarget);
+
+		FTraceDelegate TraceDelegate = FTraceDelegate::CreateUObject(this, &UShooterReplicationGraphNode_TeamVisibility_ForConnection::OnVisibilityTraceDone);
+		World->AsyncLineTraceByObjectType(EAsyncTraceType::Test, Request.Start, Request.End, FCollisionObjectQueryParams(ECC_WorldStatic), TraceParams, &TraceDelegate, TraceId);
+
+		EnemyVisibility.FindOrAdd(FObjectKey(Request.Enemy)).PendingTraceId = TraceId;
+		PendingTraces.Add(TraceId, FObjectKey(Request.Enemy));
+	}
+
+	TraceRequests.Reset();
+
+	// Forget about pawns that went away
+	if ((Params.ReplicationFrameNum % 64) == 0)
+	{
+		for (auto It = EnemyVisibility.CreateIterator(); It; ++It)
+		{
+			if (It.Key().ResolveObjectPtr() == nullptr)
+			{
+				PendingTraces.Remove(It.Value().PendingTraceId);
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	CSV_CUSTOM_STAT(ShooterRepGraph, HiddenEnemies, NumHiddenEnemies, ECsvCustomStatOp::Accumulate);
+}
+
+void UShooterReplicationGraphNode_TeamVisibility_ForConnection::GatherPreparedLists(const FConnectionGatherActorListParameters& Params)
+{
+	if (ReplicationActorList.Num() > 0)
+	{
+		Params.OutGatheredReplicationLists.AddReplicationActorList(ReplicationActorList);
+	}
+}
+
+void UShooterReplicationGraphNode_TeamVisibility_ForConnection::OnVisibilityTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	FObjectKey EnemyKey;
+	if (PendingTraces.RemoveAndCopyValue(TraceDatum.UserData, EnemyKey) == false)
+	{
+		return;
+	}
+
+	FShooterEnemyVisibilityInfo* VisibilityInfo = EnemyVisibility.Find(EnemyKey);
+	if (VisibilityInfo && VisibilityInfo->PendingTraceId == TraceDatum.UserData)
+	{
+		const bool bBlocked = TraceDatum.OutHits.Num() > 0 && TraceDatum.OutHits[0].bBlockingHit;
+
+		VisibilityInfo->PendingTraceId = 0;
+		VisibilityInfo->bVisible = !bBlocked;
+		VisibilityInfo->LastResultTime = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.f;
+	}
+}
+
+void UShooterReplicationGraphNode_TeamVisibility_ForConnection::LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const
+{
+	DebugInfo.Log(NodeName);
+	DebugInfo.PushIndent();
+	LogActorRepList(DebugInfo, TEXT("Teammates"), ReplicationActorList);
+	DebugInfo.Log(FString::Printf(TEXT("Hidden enemies: %d  Tracked enemies: %d  Pending traces: %d"), NumHiddenEnemies, EnemyVisibility.Num(), PendingTraces.Num()));
+	DebugInfo.PopIndent();
+}
+
+// ------------------------------------------------------------------------------
+
+void UShooterReplicationGraphNode_Projectiles_ForConnection::PrepareForConnection(const FShooterConnectionPrepareParams& Params)
+{
+	QUICK_SCOPE_CYCLE_COUNTER( UShooterReplicationGraphNode_Projectiles_ForConnection_PrepareForConnection );
+
+	UShooterReplicationGraph* ShooterGraph = CastChecked<UShooterReplicationGraph>(GetOuter());
+
+	Candidates.Reset();
+
+	const float MaxDistSq = CVar_ShooterRepGraph_Projectiles_MaxDist * CVar_ShooterRepGraph_Projectiles_MaxDist;
+	const float OpenChannelBiasSq = FMath::Square(FMath::Clamp(CVar_ShooterRepGraph_Projectiles_OpenChannelBias, 0.f, 1.f));
+	FPerConnectionActorInfoMap& ConnectionActorInfoMap = Params.ConnectionManager.ActorInfoMap;
+
+	for (FActorRepListType Actor : ShooterGraph->ProjectileActors)
+	{
+		AShooterProjectile* Projectile = Cast<AShooterProjectile>(Actor);
+		if (Projectile == nullptr || IsActorValidForReplicationGather(Projectile) == false)
+		{
+			continue;
+		}
+
+		// Exploded projectiles only finish replicating on channels that are already open. Everyone else got the explosion event.
+		const FConnectionReplicationActorInfo* ConnectionActorInfo = ConnectionActorInfoMap.Find(Projectile);
+		const bool bHasChannel = ConnectionActorInfo && ConnectionActorInfo->Channel;
+		if (Projectile->HasExploded() && !bHasChannel)
+		{
+			continue;
+		}
+
+		const FVector ProjectileLocation = Projectile->GetActorLocation();
+		float ClosestDistSq = MaxDistSq;
+		bool bInRange = false;
+		for (const FNetViewer& CurViewer : Params.Viewers)
+		{
+			const float DistSq = FVector::DistSquared(CurViewer.ViewLocation, ProjectileLocation);
+			if (DistSq <= ClosestDistSq)
+			{
+				ClosestDistSq = DistSq;
+				bInRange = true;
+			}
+		}
+
+		if (bInRange)
+		{
+			// Hysteresis: an open channel only loses its slot to a projectile that is clearly closer
+			Candidates.Emplace(bHasChannel ? ClosestDistSq * OpenChannelBiasSq : ClosestDistSq, Projectile);
+		}
+	}
+
+	// Prioritize what is near the viewer
+	const int32 MaxProjectiles = FMath::Max(CVar_ShooterRepGraph_Projectiles_MaxPerConnection, 0);
+	if (Candidates.Num() > MaxProjectiles)
+	{
+		Candidates.Sort([](const TPair<float, AActor*>& A, const TPair<float, AActor*>& B) { return A.Key < B.Key; });
+		Candidates.SetNum(MaxProjectiles, false);
+	}
+}
+
+void UShooterReplicationGraphNode_Projectiles_ForConnection::FinishPrepareForConnection(const FShooterConnectionPrepareParams& Params)
+{
+	UShooterReplicationGraph* ShooterGraph = CastChecked<UShooterReplicationGraph>(GetOuter());
+	FPerConnectionActorInfoMap& ConnectionActorInfoMap = Params.ConnectionManager.ActorInfoMap;
+
+	ReplicationActorList.Reset();
+	for (const TPair<float, AActor*>& Candidate : Candidates)
+	{
+		ReplicationActorList.Add(Candidate.Value);
+	}
+
+	// Count real channel transitions since the last frame rather than list changes: a projectile can leave the list and come back
+	// within ActorChannelFrameTimeout without its channel ever closing, and a gathered projectile may take a few frames to get one.
+	int32 NumOpens = 0;
+	int32 NumCloses = 0;
+	for (int32 Idx = ChannelActors.Num() - 1; Idx >= 0; --Idx)
+	{
+		const FConnectionReplicationActorInfo* ConnectionActorInfo = ConnectionActorInfoMap.Find(ChannelActors[Idx]);
+		if (ConnectionActorInfo == nullptr || ConnectionActorInfo->Channel == nullptr)
+		{
+			ChannelActors.RemoveAtSwap(Idx, 1, false);
+			++NumCloses;
+		}
+	}
+
+	for (const TPair<float, AActor*>& Candidate : Candidates)
+	{
+		const FConnectionReplicationActorInfo* ConnectionActorInfo = ConnectionActorInfoMap.Find(Candidate.Value);
+		if (ConnectionActorInfo && ConnectionActorInfo->Channel && ChannelActors.Contains(Candidate.Value) == false)
+		{
+			ChannelActors.Add(Candidate.Value);
+			++NumOpens;
+		}
+	}
+
+	NumChannelOpens = NumOpens;
+	NumChannelCloses = NumCloses;
+
+	ShooterGraph->NumProjectileChannelOpens += NumChannelOpens;
+	ShooterGraph->NumProjectileChannelCloses += NumChannelCloses;
+	CSV_CUSTOM_STAT(ShooterRepGraph, ProjectileChannelOpens, NumChannelOpens, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(ShooterRepGraph, ProjectileChannelCloses, NumChannelCloses, ECsvCustomStatOp::Accumulate);
+}
+
+void UShooterReplicationGraphNode_Projectiles_ForConnection::GatherPreparedLists(const FConnectionGatherActorListParameters& Params)
+{
+	if (ReplicationActorList.Num() > 0)
+	{
+		Params.OutGatheredReplicationLists.AddReplicationActorList(ReplicationActorList);
+	}
+}
+
+void UShooterReplicationGraphNode_Projectiles_ForConnection::LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const
+{
+	DebugInfo.Log(NodeName);
+	DebugInfo.PushIndent();
+	LogActorRepList(DebugInfo, NodeName, ReplicationActorList);
+	DebugInfo.PopIndent();
+}
+
+// ------------------------------------------------------------------------------
+
+/**
+ * Global PrepareForReplication runs before UNetReplicationGraphConnection::PrepareForReplication refreshes the connections' view targets for this frame.
+ * Work out the view target the same way but keep it in the viewer: the connection's ViewTarget is engine state and is left alone.
+ */
+static bool MakePrepareViewer(UNetConnection* Connection, FNetViewer& OutViewer)
+{
+	AActor* ViewTarget = Connection->PlayerController ? Connection->PlayerController->GetViewTarget() : Connection->OwningActor;
+	if (ViewTarget == nullptr || Connection->OwningActor == nullptr)
+	{
+		return false;
+	}
+
+	OutViewer = FNetViewer();
+	OutViewer.Connection = Connection;
+	OutViewer.InViewer = Connection->PlayerController ? Connection->PlayerController : Connection->OwningActor;
+	OutViewer.ViewTarget = ViewTarget;
+	OutViewer.ViewLocation = ViewTarget->GetActorLocation();
+
+	if (APlayerController* ViewingController = Connection->PlayerController)
+	{
+		FRotator ViewRotation = ViewingController->GetControlRotation();
+		ViewingController->GetPlayerViewPoint(OutViewer.ViewLocation, ViewRotation);
+		OutViewer.ViewDir = ViewRotation.Vector();
+	}
+
+	return true;
+}
+
+void UShooterReplicationGraph::PrepareConnectionsForReplication()
+{
+	QUICK_SCOPE_CYCLE_COUNTER( UShooterReplicationGraph_PrepareConnectionsForReplication );
+	CSV_SCOPED_TIMING_STAT(ShooterRepGraph, PrepareConnections);
+
+	LastPrepareConnectionsSeconds = 0.0;
+
+	if (CVar_ShooterRepGraph_ParallelGather <= 0)
+	{
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const uint32 FrameNum = GetReplicationGraphFrame();
+
+	// Game thread: building viewers calls into game code (view points)
+	ConnectionPrepareWork.SetNum(Connections.Num(), false);
+	int32 NumWork = 0;
+
+	for (UNetReplicationGraphConnection* ConnManager : Connections)
+	{
+		UNetConnection* NetConnection = ConnManager ? ConnManager->NetConnection : nullptr;
+		if (NetConnection == nullptr || NetConnection->State == USOCK_Closed)
+		{
+			continue;
+		}
+
+		FNetViewer ConnectionViewer;
+		if (!MakePrepareViewer(NetConnection, ConnectionViewer))
+		{
+			continue;
+		}
+
+		FConnectionPrepareWork& Work = ConnectionPrepareWork[NumWork++];
+		Work.ConnectionManager = ConnManager;
+
+		Work.Viewers.Reset();
+		Work.Viewers.Add(ConnectionViewer);
+		for (UChildConnection* Child : NetConnection->Children)
+		{
+			FNetViewer ChildViewer;
+			if (Child && MakePrepareViewer(Child, ChildViewer))
+			{
+				Work.Viewers.Add(ChildViewer);
+			}
+		}
+
+		Work.Nodes.Reset();
+		for (UReplicationGraphNode* ConnectionNode : ConnManager->GetConnectionGraphNodes())
+		{
+			if (UShooterReplicationGraphNode_PreparedForConnection* PreparedNode = Cast<UShooterReplicationGraphNode_PreparedForConnection>(ConnectionNode))
+			{
+				Work.Nodes.Add(PreparedNode);
+			}
+		}
+	}
+
+	// One task per connection. Tasks only read shared state and write their own nodes' scratch arrays (see PrepareForConnection).
+	{
+		CSV_SCOPED_TIMING_STAT(ShooterRepGraph, PrepareConnections_Parallel);
+
+		const bool bForceSingleThread = NumWork < CVar_ShooterRepGraph_ParallelGather_MinConnections;
+		ParallelFor(NumWork, [this, FrameNum](int32 WorkIdx)
+		{
+			FConnectionPrepareWork& Work = ConnectionPrepareWork[WorkIdx];
+			const FShooterConnectionPrepareParams Params(Work.Viewers, *Work.ConnectionManager, FrameNum);
+			for (UShooterReplicationGraphNode_PreparedForConnection* Node : Work.Nodes)
+			{
+				Node->PrepareForConnection(Params);
+			}
+		}, bForceSingleThread);
+	}
+
+	// Back on the game thread: rep lists, ActorInfoMaps and node state
+	{
+		CSV_SCOPED_TIMING_STAT(ShooterRepGraph, PrepareConnections_Finish);
+
+		for (int32 WorkIdx = 0; WorkIdx < NumWork; ++WorkIdx)
+		{
+			FConnectionPrepareWork& Work = ConnectionPrepareWork[WorkIdx];
+			const FShooterConnectionPrepareParams Params(Work.Viewers, *Work.ConnectionManager, FrameNum);
+			for (UShooterReplicationGraphNode_PreparedForConnection* Node : Work.Nodes)
+			{
+				Node->FinishPrepareForConnection(Params);
+				Node->MarkPrepared(FrameNum);
+			}
+		}
+	}
+
+	LastPrepareConnectionsSeconds = FPlatformTime::Seconds() - StartTime;
+}
+
+UShooterReplicationGraphNode_PrepareConnections::UShooterReplicationGraphNode_PrepareConnections()
+{
+	bRequiresPrepareForReplicationCall = true;
+}
+
+void UShooterReplicationGraphNode_PrepareConnections::PrepareForReplication()
+{
+	CastChecked<UShooterReplicationGraph>(GetOuter())->PrepareConnectionsForReplication();
+}
+
+// ------------------------------------------------------------------------------
+
 UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::UShooterReplicationGraphNode_PlayerStateFrequencyLimiter()
 {
 	bRequiresPrepareForReplicationCall = true;
@@ -835,6 +1672,37 @@ void UShooterReplicationGraph::PrintRepNodePolicies()
 	}
 }
 
+void UShooterReplicationGraph::PrintProjectileStats(bool bReset)
+{
+	const double Now = FPlatformTime::Seconds();
+	const double Elapsed = ProjectileStatsStartTime > 0.0 ? Now - ProjectileStatsStartTime : 0.0;
+
+	GLog->Logf(TEXT("===================================="));
+	GLog->Logf(TEXT("Shooter Projectile Channel Stats (%s)"), *GetNameSafe(NetDriver));
+	GLog->Logf(TEXT("===================================="));
+	GLog->Logf(TEXT("Live projectiles: %d  Connections: %d"), ProjectileActors.Num(), Connections.Num());
+	GLog->Logf(TEXT("Channel opens:  %d (%.2f/s)"), NumProjectileChannelOpens, Elapsed > 0.0 ? NumProjectileChannelOpens / Elapsed : 0.0);
+	GLog->Logf(TEXT("Channel closes: %d (%.2f/s)"), NumProjectileChannelCloses, Elapsed > 0.0 ? NumProjectileChannelCloses / Elapsed : 0.0);
+
+	if (bReset || ProjectileStatsStartTime == 0.0)
+	{
+		NumProjectileChannelOpens = 0;
+		NumProjectileChannelCloses = 0;
+		ProjectileStatsStartTime = Now;
+	}
+}
+
+FAutoConsoleCommandWithWorldAndArgs ShooterPrintProjectileStatsCmd(TEXT("ShooterRepGraph.Projectiles.Stats"),TEXT("Prints projectile actor channel open/close counts and rates. Pass 'reset' to restart the measurement."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const bool bReset = Args.Num() > 0 && Args[0] == TEXT("reset");
+		for (TObjectIterator<UShooterReplicationGraph> It; It; ++It)
+		{
+			It->PrintProjectileStats(bReset);
+		}
+	})
+);
+
 FAutoConsoleCommandWithWorldAndArgs ShooterPrintRepNodePoliciesCmd(TEXT("ShooterRepGraph.PrintRouting"),TEXT("Prints how actor classes are routed to RepGraph nodes"),
 	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
 	{
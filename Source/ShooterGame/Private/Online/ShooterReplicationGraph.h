@@ -8,7 +8,9 @@
 
 class AShooterCharacter;
 class AShooterWeapon;
+class AShooterProjectile;
 class UReplicationGraphNode_GridSpatialization2D;
+class UShooterReplicationGraphNode_PreparedForConnection;
 class AGameplayDebuggerCategoryReplicator;
 
 DECLARE_LOG_CATEGORY_EXTERN( LogShooterReplicationGraph, Display, All );
@@ -19,6 +21,7 @@ enum class EClassRepNodeMapping : uint32
 {
 	NotRouted,						// Doesn't map to any node. Used for special case actors that handled by special case nodes (UShooterReplicationGraphNode_PlayerStateFrequencyLimiter)
 	RelevantAllConnections,			// Routes to an AlwaysRelevantNode or AlwaysRelevantStreamingLevelNode node
+	Projectile,						// Routes to ProjectileActors: short lived, gathered per connection by distance in UShooterReplicationGraphNode_Projectiles_ForConnection
 	
 	// ONLY SPATIALIZED Enums below here! See UShooterReplicationGraph::IsSpatialized
 
@@ -44,6 +47,7 @@ public:
 	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
 	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
 	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual int32 ServerReplicateActors(float DeltaSeconds) override;
 	
 	UPROPERTY()
 	TArray<UClass*>	SpatializedClasses;
@@ -62,26 +66,104 @@ public:
 
 	TMap<FName, FActorRepListRefView> AlwaysRelevantStreamingLevelActors;
 
+	/** All AShooterCharacters, in addition to whatever node they are routed to. Used for team and visibility aware gathering. */
+	FActorRepListRefView CharacterActors;
+
+	/** All live projectiles. Never spatialized: each connection picks the closest ones itself. */
+	FActorRepListRefView ProjectileActors;
+
+	/** Projectile actor channel churn since the last ShooterRepGraph.Projectiles.Stats reset */
+	int32 NumProjectileChannelOpens = 0;
+	int32 NumProjectileChannelCloses = 0;
+	double ProjectileStatsStartTime = 0.0;
+
+	/** Wall time spent in the last ServerReplicateActors call. Read by the replication graph load test (UShooterTestControllerReplicationGraphLoad). */
+	double LastServerReplicateActorsSeconds = 0.0;
+
+	/** Wall time spent in the last PrepareConnectionsForReplication call, 0 when ShooterRepGraph.ParallelGather is off. Read by the load test too. */
+	double LastPrepareConnectionsSeconds = 0.0;
+
 	void OnCharacterEquipWeapon(AShooterCharacter* Character, AShooterWeapon* NewWeapon);
 	void OnCharacterUnEquipWeapon(AShooterCharacter* Character, AShooterWeapon* OldWeapon);
 
+	void OnProjectileExploded(AShooterProjectile* Projectile, const FHitResult& Impact);
+
 #if WITH_GAMEPLAY_DEBUGGER
 	void OnGameplayDebuggerOwnerChange(AGameplayDebuggerCategoryReplicator* Debugger, APlayerController* OldOwner);
 #endif
 
 	void PrintRepNodePolicies();
 
-private:
+	void PrintProjectileStats(bool bReset);
+
+	/** Runs PrepareForConnection on the ShooterGame nodes of every connection, in parallel if ShooterRepGraph.ParallelGather is set */
+	void PrepareConnectionsForReplication();
+
+protected:
 
 	EClassRepNodeMapping GetMappingPolicy(UClass* Class);
 
 	bool IsSpatialized(EClassRepNodeMapping Mapping) const { return Mapping >= EClassRepNodeMapping::Spatialize_Static; }
 
+private:
+
+	/** Per connection scratch data for PrepareConnectionsForReplication. Persistent so the allocations are reused. */
+	struct FConnectionPrepareWork
+	{
+		UNetReplicationGraphConnection* ConnectionManager = nullptr;
+		FNetViewerArray Viewers;
+		TArray<UShooterReplicationGraphNode_PreparedForConnection*, TInlineAllocator<4>> Nodes;
+	};
+
+	TArray<FConnectionPrepareWork> ConnectionPrepareWork;
+
 	TClassMap<EClassRepNodeMapping> ClassRepNodePolicies;
 };
 
-UCLASS()
-class UShooterReplicationGraphNode_AlwaysRelevant_ForConnection : public UReplicationGraphNode
+/**
+ * Replication graph for the demo net driver (replay recording). Replays can be scrubbed and watched from anywhere, so nothing is spatialized:
+ * every routed actor goes into one list for the single demo connection. Class replication periods are recomputed for the demo record rate
+ * and scaled down (ShooterRepGraph.Replay.*) so recording stays cheap next to the live graph.
+ */
+UCLASS(transient, config=Engine)
+class UShooterReplayReplicationGraph : public UShooterReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void InitGlobalActorClassSettings() override;
+	virtual void InitGlobalGraphNodes() override;
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual int32 ServerReplicateActors(float DeltaSeconds) override;
+
+	/** Everything the live graph would spatialize or gather per connection (characters, pickups, projectiles...) */
+	UPROPERTY()
+	UReplicationGraphNode_ActorList* ReplayActorsNode;
+};
+
+/** What a connection node needs to build its lists outside of GatherActorListsForConnection */
+struct FShooterConnectionPrepareParams
+{
+	FShooterConnectionPrepareParams(const FNetViewerArray& InViewers, UNetReplicationGraphConnection& InConnectionManager, uint32 InReplicationFrameNum)
+		: Viewers(InViewers), ConnectionManager(InConnectionManager), ReplicationFrameNum(InReplicationFrameNum) { }
+
+	const FNetViewerArray& Viewers;
+	UNetReplicationGraphConnection& ConnectionManager;
+	uint32 ReplicationFrameNum;
+};
+
+/**
+ * Base class for the ShooterGame connection specific nodes.
+ * UShooterReplicationGraph::PrepareConnectionsForReplication runs PrepareForConnection for every connection in parallel before gathering starts, then
+ * FinishPrepareForConnection for each on the game thread. PrepareForConnection only reads shared state and fills arrays owned by the node; the rep lists
+ * and the connection's ActorInfoMap are only written in FinishPrepareForConnection.
+ * GatherActorListsForConnection then only hands out the prepared lists (or prepares inline if that did not happen this frame).
+ */
+UCLASS(abstract)
+class UShooterReplicationGraphNode_PreparedForConnection : public UReplicationGraphNode
 {
 	GENERATED_BODY()
 
@@ -93,6 +175,38 @@ public:
 
 	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
 
+	/**
+	 * Works out this frame's lists. May run on a worker thread: only read graph, world and ActorInfoMap state, and only write this node's own TArray and POD members
+	 * (GC cannot run while the game thread waits on the tasks, so UPROPERTY arrays are fine).
+	 * No FActorRepListRefView (their storage comes from a global, game thread only allocator), no maps.
+	 */
+	virtual void PrepareForConnection(const FShooterConnectionPrepareParams& Params) { }
+
+	/** Game thread follow up to PrepareForConnection: copies the scratch results into the rep lists, ActorInfoMap and node state, issues async traces, stats */
+	virtual void FinishPrepareForConnection(const FShooterConnectionPrepareParams& Params) { }
+
+	void MarkPrepared(uint32 ReplicationFrameNum) { PreparedFrameNum = ReplicationFrameNum; }
+
+protected:
+
+	/** Adds the lists built by PrepareForConnection to the gather output */
+	virtual void GatherPreparedLists(const FConnectionGatherActorListParameters& Params) { }
+
+private:
+
+	uint32 PreparedFrameNum = MAX_uint32;
+};
+
+UCLASS()
+class UShooterReplicationGraphNode_AlwaysRelevant_ForConnection : public UShooterReplicationGraphNode_PreparedForConnection
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void PrepareForConnection(const FShooterConnectionPrepareParams& Params) override;
+	virtual void FinishPrepareForConnection(const FShooterConnectionPrepareParams& Params) override;
+
 	virtual void LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const override;
 
 	void OnClientLevelVisibilityAdd(FName LevelName, UWorld* StreamingWorld);
@@ -104,10 +218,26 @@ public:
 	AGameplayDebuggerCategoryReplicator* GameplayDebugger = nullptr;
 #endif
 
+protected:
+
+	virtual void GatherPreparedLists(const FConnectionGatherActorListParameters& Params) override;
+
 private:
 
 	TArray<FName, TInlineAllocator<64> > AlwaysRelevantStreamingLevelsNeedingReplication;
 
+	/** Streaming levels whose always relevant lists go out this frame */
+	TArray<FName, TInlineAllocator<64> > PreparedStreamingLevels;
+
+	/** Built by PrepareForConnection, copied into ReplicationActorList on the game thread */
+	TArray<AActor*> PreparedActors;
+
+	/** New pawns and view targets whose cull distance is zeroed in the ActorInfoMap on the game thread */
+	TArray<AActor*> PreparedCullDistanceResets;
+
+	/** Player state set to replicate every frame on the game thread, the first time one is seen */
+	APlayerState* PreparedPlayerStateInit = nullptr;
+
 	FActorRepListRefView ReplicationActorList;
 
 	UPROPERTY()
@@ -120,6 +250,134 @@ private:
 	bool bInitializedPlayerState = false;
 };
 
+/** Connection specific node for projectiles. Returns only the closest projectiles within a short range of the viewers, so far connections never open channels for them. */
+UCLASS()
+class UShooterReplicationGraphNode_Projectiles_ForConnection : public UShooterReplicationGraphNode_PreparedForConnection
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void PrepareForConnection(const FShooterConnectionPrepareParams& Params) override;
+	virtual void FinishPrepareForConnection(const FShooterConnectionPrepareParams& Params) override;
+
+	virtual void LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const override;
+
+protected:
+
+	virtual void GatherPreparedLists(const FConnectionGatherActorListParameters& Params) override;
+
+private:
+
+	FActorRepListRefView ReplicationActorList;
+
+	/** Scratch list of (distance squared, projectile), filled by PrepareForConnection and reused every frame */
+	TArray<TPair<float, AActor*>> Candidates;
+
+	/** Projectiles that had an open channel on this connection last frame. Used to count channel churn. */
+	TArray<AActor*> ChannelActors;
+
+	int32 NumChannelOpens = 0;
+	int32 NumChannelCloses = 0;
+};
+
+/** Cached visibility of one enemy pawn for one connection */
+struct FShooterEnemyVisibilityInfo
+{
+	/** World time the last trace result arrived */
+	float LastResultTime = -1.f;
+
+	/** Id of the async trace in flight, 0 if none */
+	uint32 PendingTraceId = 0;
+
+	/** Result of the last trace. Unknown enemies are treated as visible. */
+	bool bVisible = true;
+};
+
+/** Visibility trace queued by PrepareForConnection, issued on the game thread */
+struct FShooterVisibilityTraceRequest
+{
+	AActor* Enemy;
+	AActor* ViewTarget;
+	FVector Start;
+	FVector End;
+};
+
+/** Per connection replication settings PrepareForConnection picked for one pawn, applied on the game thread */
+struct FShooterPreparedPawnSettings
+{
+	AActor* Pawn;
+	float CullDistanceSquared;
+	uint32 ReplicationPeriodFrame;
+	bool bTeammate;
+};
+
+/**
+ * Connection specific node keeping a coarse potentially-visible set of enemy pawns.
+ * Enemies in grid range whose view is blocked by world geometry replicate at a reduced rate. Teammates are always gathered.
+ * Visibility comes from a small per-frame budget of async traces, and results are only trusted for a short time.
+ */
+UCLASS()
+class UShooterReplicationGraphNode_TeamVisibility_ForConnection : public UShooterReplicationGraphNode_PreparedForConnection
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void PrepareForConnection(const FShooterConnectionPrepareParams& Params) override;
+	virtual void FinishPrepareForConnection(const FShooterConnectionPrepareParams& Params) override;
+
+	virtual void LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const override;
+
+	void ResetGameWorldState();
+
+protected:
+
+	virtual void GatherPreparedLists(const FConnectionGatherActorListParameters& Params) override;
+
+private:
+
+	void OnVisibilityTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	/** Teammate pawns, gathered regardless of distance */
+	FActorRepListRefView ReplicationActorList;
+
+	TMap<FObjectKey, FShooterEnemyVisibilityInfo> EnemyVisibility;
+
+	/** Pawn settings worked out by PrepareForConnection this frame */
+	TArray<FShooterPreparedPawnSettings> PreparedPawns;
+
+	/** Traces requested by PrepareForConnection this frame */
+	TArray<FShooterVisibilityTraceRequest> TraceRequests;
+
+	/** Async trace id -> enemy it was issued for */
+	TMap<uint32, FObjectKey> PendingTraces;
+
+	uint32 NextTraceId = 1;
+
+	/** Rotates where trace budget starts so every enemy gets its turn */
+	int32 TraceCursor = 0;
+
+	int32 NumHiddenEnemies = 0;
+};
+
+/** Global node that gives UShooterReplicationGraph a PrepareForReplication hook to prepare the connection nodes. Never gathers anything itself. */
+UCLASS()
+class UShooterReplicationGraphNode_PrepareConnections : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+	UShooterReplicationGraphNode_PrepareConnections();
+
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& Actor) override { }
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound=true) override { return false; }
+	virtual void NotifyResetAllNetworkActors() override { }
+
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override { }
+
+	virtual void PrepareForReplication() override;
+};
+
 /** This is a specialized node for handling PlayerState replication in a frequency limited fashion. It tracks all player states but only returns a subset of them to the replication driver each frame. */
 UCLASS()
 class UShooterReplicationGraphNode_PlayerStateFrequencyLimiter : public UReplicationGraphNode
@@ -0,0 +1,205 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Online/ShooterSpawnManager.h"
+#include "Online/ShooterPlayerState.h"
+#include "Bots/ShooterAIController.h"
+#include "Player/ShooterCharacterSpatialIndex.h"
+#include "GameFramework/PlayerStart.h"
+
+static float ShooterSpawnSafeDistance = 3000.f;
+static FAutoConsoleVariableRef CVarShooterSpawnSafeDistance(
+	TEXT("ShooterGame.Spawn.SafeDistance"),
+	ShooterSpawnSafeDistance,
+	TEXT("Spawn points with no living enemy within this distance are all considered equally safe."),
+	ECVF_Default);
+
+static float ShooterSpawnRecentUseTime = 5.f;
+static FAutoConsoleVariableRef CVarShooterSpawnRecentUseTime(
+	TEXT("ShooterGame.Spawn.RecentUseTime"),
+	ShooterSpawnRecentUseTime,
+	TEXT("Seconds after a spawn point was used during which it scores lower."),
+	ECVF_Default);
+
+void UShooterSpawnManager::Init(UWorld* World)
+{
+	SpawnPoints.Reset();
+	GatherSpawnPoints(World);
+
+	if (!LevelAddedHandle.IsValid())
+	{
+		LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UShooterSpawnManager::OnLevelChanged);
+		LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &UShooterSpawnManager::OnLevelChanged);
+	}
+}
+
+void UShooterSpawnManager::BeginDestroy()
+{
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+	LevelAddedHandle.Reset();
+	LevelRemovedHandle.Reset();
+
+	Super::BeginDestroy();
+}
+
+void UShooterSpawnManager::GatherSpawnPoints(UWorld* World)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(UShooterSpawnManager_GatherSpawnPoints);
+
+	TArray<FSpawnPoint> OldSpawnPoints = MoveTemp(SpawnPoints);
+	SpawnPoints.Reset();
+	AllowedSpawns.Reset();
+	EnemyDistances.Reset();
+	bSpawnPointsDirty = false;
+
+	for (APlayerStart* PlayerStart : TActorRange<APlayerStart>(World))
+	{
+		const FSpawnPoint* OldSpawnPoint = OldSpawnPoints.FindByPredicate([PlayerStart](const FSpawnPoint& Test) { return Test.PlayerStart == PlayerStart; });
+
+		FSpawnPoint& SpawnPoint = SpawnPoints.AddDefaulted_GetRef();
+		SpawnPoint.PlayerStart = PlayerStart;
+		SpawnPoint.Location = PlayerStart->GetActorLocation();
+		SpawnPoint.LastUseTime = OldSpawnPoint ? OldSpawnPoint->LastUseTime : -MAX_FLT;
+		SpawnPoint.LastUseFrame = OldSpawnPoint ? OldSpawnPoint->LastUseFrame : 0;
+	}
+}
+
+void UShooterSpawnManager::OnLevelChanged(ULevel* Level, UWorld* World)
+{
+	if (World != nullptr && World == GetWorld())
+	{
+		bSpawnPointsDirty = true;
+	}
+}
+
+int32 UShooterSpawnManager::GetSpawnTeam(AController* Player) const
+{
+	const AShooterGameState* MyGameState = Player->GetWorld()->GetGameState<AShooterGameState>();
+	const AShooterPlayerState* MyPlayerState = Cast<AShooterPlayerState>(Player->PlayerState);
+	return (MyGameState && MyGameState->NumTeams > 1 && MyPlayerState) ? MyPlayerState->GetTeamNum() : INDEX_NONE;
+}
+
+const TArray<float>& UShooterSpawnManager::GetEnemyDistances(int32 Team)
+{
+	FEnemyDistances& TeamDistances = EnemyDistances.FindOrAdd(Team);
+	if (TeamDistances.Frame == GFrameCounter)
+	{
+		return TeamDistances.DistSq;
+	}
+
+	QUICK_SCOPE_CYCLE_COUNTER(UShooterSpawnManager_GetEnemyDistances);
+
+	TeamDistances.Frame = GFrameCounter;
+	TeamDistances.DistSq.Reset(SpawnPoints.Num());
+
+	UShooterCharacterSpatialIndex* CharacterIndex = GetWorld()->GetSubsystem<UShooterCharacterSpatialIndex>();
+
+	FShooterCharacterQuery Query;
+	Query.ExcludeTeam = Team;
+	Query.MaxDistance = ShooterSpawnSafeDistance;
+
+	for (const FSpawnPoint& SpawnPoint : SpawnPoints)
+	{
+		const AShooterCharacter* Enemy = CharacterIndex ? CharacterIndex->FindNearest(SpawnPoint.Location, Query) : nullptr;
+		TeamDistances.DistSq.Add(Enemy ? FVector::DistSquared(Enemy->GetActorLocation(), SpawnPoint.Location) : FMath::Square(ShooterSpawnSafeDistance));
+	}
+
+	return TeamDistances.DistSq;
+}
+
+float UShooterSpawnManager::GetScore(int32 SpawnIndex, float EnemyDistSq, float Now) const
+{
+	// 0 with an enemy on top of it, 1 with none within the safe distance
+	float Score = FMath::Sqrt(EnemyDistSq) / FMath::Max(ShooterSpawnSafeDistance, 1.f);
+
+	const float TimeSinceUse = Now - SpawnPoints[SpawnIndex].LastUseTime;
+	if (TimeSinceUse < ShooterSpawnRecentUseTime)
+	{
+		Score -= 0.5f * (1.f - TimeSinceUse / ShooterSpawnRecentUseTime);
+	}
+
+	// Spread players over equally good spawns
+	return Score + FMath::FRand() * 0.1f;
+}
+
+APlayerStart* UShooterSpawnManager::ChooseSpawn(AController* Player, TFunctionRef<bool(APlayerStart*)> IsAllowed, TFunctionRef<bool(APlayerStart*)> IsPreferred)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(UShooterSpawnManager_ChooseSpawn);
+
+	if (Player == nullptr)
+	{
+		return nullptr;
+	}
+
+	if (bSpawnPointsDirty)
+	{
+		GatherSpawnPoints(GetWorld());
+	}
+
+	const AShooterPlayerState* MyPlayerState = Cast<AShooterPlayerState>(Player->PlayerState);
+	const TPair<int32, bool> AllowedKey(MyPlayerState ? MyPlayerState->GetTeamNum() : INDEX_NONE, Player->IsA<AShooterAIController>());
+
+	TArray<int32>* Allowed = AllowedSpawns.Find(AllowedKey);
+	if (Allowed == nullptr)
+	{
+		Allowed = &AllowedSpawns.Add(AllowedKey);
+		for (int32 i = 0; i < SpawnPoints.Num(); ++i)
+		{
+			APlayerStart* PlayerStart = SpawnPoints[i].PlayerStart.Get();
+			if (PlayerStart && IsAllowed(PlayerStart))
+			{
+				Allowed->Add(i);
+			}
+		}
+	}
+
+	const TArray<float>& EnemyDistSq = GetEnemyDistances(GetSpawnTeam(Player));
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	// Best free spawn, falling back to the best occupied one
+	int32 BestPreferred = INDEX_NONE;
+	int32 BestFallback = INDEX_NONE;
+	float BestPreferredScore = -MAX_FLT;
+	float BestFallbackScore = -MAX_FLT;
+
+	for (int32 SpawnIndex : *Allowed)
+	{
+		APlayerStart* PlayerStart = SpawnPoints[SpawnIndex].PlayerStart.Get();
+		if (PlayerStart == nullptr)
+		{
+			continue;
+		}
+
+		const float Score = GetScore(SpawnIndex, EnemyDistSq[SpawnIndex], Now);
+		const bool bFree = SpawnPoints[SpawnIndex].LastUseFrame != GFrameCounter && IsPreferred(PlayerStart);
+		if (bFree && Score > BestPreferredScore)
+		{
+			BestPreferredScore = Score;
+			BestPreferred = SpawnIndex;
+		}
+		else if (!bFree && Score > BestFallbackScore)
+		{
+			BestFallbackScore = Score;
+			BestFallback = SpawnIndex;
+		}
+	}
+
+	const int32 BestIndex = BestPreferred != INDEX_NONE ? BestPreferred : BestFallback;
+	if (BestIndex == INDEX_NONE)
+	{
+		return nullptr;
+	}
+
+	return SpawnPoints[BestIndex].PlayerStart.Get();
+}
+
+void UShooterSpawnManager::MarkSpawnUsed(APlayerStart* PlayerStart)
+{
+	FSpawnPoint* SpawnPoint = PlayerStart ? SpawnPoints.FindByPredicate([PlayerStart](const FSpawnPoint& Test) { return Test.PlayerStart == PlayerStart; }) : nullptr;
+	if (SpawnPoint)
+	{
+		SpawnPoint->LastUseTime = GetWorld()->GetTimeSeconds();
+		SpawnPoint->LastUseFrame = GFrameCounter;
+	}
+}
@@ -2,6 +2,7 @@
 
 #include "ShooterGame.h"
 #include "Pickups/ShooterPickup.h"
+#include "Pickups/ShooterPickupIndex.h"
 #include "Particles/ParticleSystemComponent.h"
 
 AShooterPickup::AShooterPickup(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
@@ -41,6 +42,26 @@ void AShooterPickup::BeginPlay()
 	}
 }
 
+void AShooterPickup::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+
+	UShooterPickupIndex* PickupIndex = GetWorld()->GetSubsystem<UShooterPickupIndex>();
+	if (PickupIndex && GetLocalRole() == ROLE_Authority)
+	{
+		PickupIndex->RemovePickup(this);
+	}
+}
+
+void AShooterPickup::UpdatePickupIndex()
+{
+	UShooterPickupIndex* PickupIndex = GetWorld()->GetSubsystem<UShooterPickupIndex>();
+	if (PickupIndex && GetLocalRole() == ROLE_Authority)
+	{
+		PickupIndex->UpdatePickup(this);
+	}
+}
+
 void AShooterPickup::NotifyActorBeginOverlap(class AActor* Other)
 {
 	Super::NotifyActorBeginOverlap(Other);
@@ -106,6 +127,8 @@ void AShooterPickup::OnPickedUp()
 		PickupPSC->DeactivateSystem();
 	}
 
+	UpdatePickupIndex();
+
 	if (PickupSound && PickedUpBy)
 	{
 		UGameplayStatics::SpawnSoundAttached(PickupSound, PickedUpBy->GetRootComponent());
@@ -126,6 +149,8 @@ void AShooterPickup::OnRespawned()
 		PickupPSC->DeactivateSystem();
 	}
 
+	UpdatePickupIndex();
+
 	const bool bJustSpawned = CreationTime <= (GetWorld()->GetTimeSeconds() + 5.0f);
 	if (RespawnSound && !bJustSpawned)
 	{
@@ -0,0 +1,240 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Pickups/ShooterPickupIndex.h"
+#include "Pickups/ShooterPickup.h"
+#include "Pickups/ShooterPickup_Ammo.h"
+#include "NavigationSystem.h"
+
+static int32 ShooterPickupIndexPathCandidates = 4;
+static FAutoConsoleVariableRef CVarShooterPickupIndexPathCandidates(
+	TEXT("ShooterGame.PickupIndex.PathCandidates"),
+	ShooterPickupIndexPathCandidates,
+	TEXT("How many of the closest pickups (in straight-line distance) get a path length query when a pickup search uses path costs."),
+	ECVF_Default);
+
+static float ShooterPickupIndexPathCostMaxAge = 5.f;
+static FAutoConsoleVariableRef CVarShooterPickupIndexPathCostMaxAge(
+	TEXT("ShooterGame.PickupIndex.PathCostMaxAge"),
+	ShooterPickupIndexPathCostMaxAge,
+	TEXT("Seconds a cached path length to a pickup is reused."),
+	ECVF_Default);
+
+/** Pickups are sparse and never move, one fixed cell size is fine */
+static const float PickupIndexCellSize = 2000.f;
+
+/** Path lengths are cached per 200uu cell of the origin */
+static const float PickupPathCostQuantization = 200.f;
+
+void UShooterPickupIndex::UpdatePickup(AShooterPickup* Pickup)
+{
+	if (Pickup == nullptr)
+	{
+		return;
+	}
+
+	FBucket& Bucket = FindOrAddBucket(Pickup);
+
+	if (const FIntPoint* OldCell = PickupCells.Find(Pickup))
+	{
+		if (FCellPickups* CellPickups = Bucket.Cells.Find(*OldCell))
+		{
+			CellPickups->Remove(Pickup);
+		}
+	}
+
+	const FIntPoint Cell = GetCell(Pickup->GetActorLocation());
+	PickupCells.Add(Pickup, Cell);
+	MinCell = FIntPoint(FMath::Min(MinCell.X, Cell.X), FMath::Min(MinCell.Y, Cell.Y));
+	MaxCell = FIntPoint(FMath::Max(MaxCell.X, Cell.X), FMath::Max(MaxCell.Y, Cell.Y));
+
+	if (Pickup->IsActive())
+	{
+		Bucket.Cells.FindOrAdd(Cell).Add(Pickup);
+	}
+}
+
+void UShooterPickupIndex::RemovePickup(AShooterPickup* Pickup)
+{
+	FIntPoint Cell;
+	if (PickupCells.RemoveAndCopyValue(Pickup, Cell))
+	{
+		if (FCellPickups* CellPickups = FindOrAddBucket(Pickup).Cells.Find(Cell))
+		{
+			CellPickups->Remove(Pickup);
+		}
+	}
+}
+
+UShooterPickupIndex::FBucket& UShooterPickupIndex::FindOrAddBucket(AShooterPickup* Pickup)
+{
+	UClass* PickupClass = Pickup->GetClass();
+	AShooterPickup_Ammo* AmmoPickup = Cast<AShooterPickup_Ammo>(Pickup);
+	UClass* WeaponType = AmmoPickup ? *AmmoPickup->GetWeaponType() : nullptr;
+
+	// Few kinds of pickups, so a linear search is fine
+	FBucket* Bucket = Buckets.FindByPredicate([PickupClass, WeaponType](const FBucket& Test) { return Test.PickupClass == PickupClass && Test.WeaponType == WeaponType; });
+	if (Bucket == nullptr)
+	{
+		Bucket = &Buckets.AddDefaulted_GetRef();
+		Bucket->PickupClass = PickupClass;
+		Bucket->WeaponType = WeaponType;
+	}
+
+	return *Bucket;
+}
+
+FIntPoint UShooterPickupIndex::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / PickupIndexCellSize), FMath::FloorToInt(Location.Y / PickupIndexCellSize));
+}
+
+void UShooterPickupIndex::GatherCell(const FIntPoint& Cell, const FVector& Origin, const FShooterPickupQuery& Query, FCandidateArray& Candidates) const
+{
+	for (const FBucket& Bucket : Buckets)
+	{
+		if ((Query.PickupClass && !Bucket.PickupClass->IsChildOf(Query.PickupClass)) || (Query.WeaponClass && !(Bucket.WeaponType && Bucket.WeaponType->IsChildOf(Query.WeaponClass))))
+		{
+			continue;
+		}
+
+		const FCellPickups* CellPickups = Bucket.Cells.Find(Cell);
+		if (CellPickups == nullptr)
+		{
+			continue;
+		}
+
+		for (const TWeakObjectPtr<AShooterPickup>& PickupPtr : *CellPickups)
+		{
+			AShooterPickup* Pickup = PickupPtr.Get();
+			if (Pickup && (Query.Pawn == nullptr || Pickup->CanBePickedUp(Query.Pawn)))
+			{
+				Candidates.Emplace(FVector::DistSquared(Pickup->GetActorLocation(), Origin), Pickup);
+			}
+		}
+	}
+}
+
+AShooterPickup* UShooterPickupIndex::FindNearest(const FVector& Origin, const FShooterPickupQuery& Query)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(UShooterPickupIndex_FindNearest);
+
+	if (PickupCells.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	const int32 NumWanted = Query.bUsePathCost ? FMath::Max(ShooterPickupIndexPathCandidates, 1) : 1;
+	const FIntPoint OriginCell = GetCell(Origin);
+	const int32 MaxRing = FMath::Max(FMath::Max(OriginCell.X - MinCell.X, MaxCell.X - OriginCell.X), FMath::Max(OriginCell.Y - MinCell.Y, MaxCell.Y - OriginCell.Y));
+
+	auto SortCandidates = [](FCandidateArray& Candidates) { Candidates.Sort([](const TPair<float, AShooterPickup*>& A, const TPair<float, AShooterPickup*>& B) { return A.Key < B.Key; }); };
+
+	// Rings of cells around the origin cell, until we have enough candidates that nothing further out can beat
+	FCandidateArray Candidates;
+	for (int32 Ring = 0; Ring <= MaxRing; ++Ring)
+	{
+		if (Ring == 0)
+		{
+			GatherCell(OriginCell, Origin, Query, Candidates);
+		}
+		else
+		{
+			for (int32 Offset = -Ring; Offset <= Ring; ++Offset)
+			{
+				GatherCell(FIntPoint(OriginCell.X + Offset, OriginCell.Y - Ring), Origin, Query, Candidates);
+				GatherCell(FIntPoint(OriginCell.X + Offset, OriginCell.Y + Ring), Origin, Query, Candidates);
+			}
+			for (int32 Offset = -Ring + 1; Offset <= Ring - 1; ++Offset)
+			{
+				GatherCell(FIntPoint(OriginCell.X - Ring, OriginCell.Y + Offset), Origin, Query, Candidates);
+				GatherCell(FIntPoint(OriginCell.X + Ring, OriginCell.Y + Offset), Origin, Query, Candidates);
+			}
+		}
+
+		if (Candidates.Num() >= NumWanted)
+		{
+			SortCandidates(Candidates);
+			if (Candidates[NumWanted - 1].Key <= FMath::Square(Ring * PickupIndexCellSize))
+			{
+				break;
+			}
+		}
+	}
+
+	if (Candidates.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	SortCandidates(Candidates);
+
+	if (!Query.bUsePathCost)
+	{
+		return Candidates[0].Value;
+	}
+
+	// A path is never shorter than the straight line, so once a candidate is further away than the best path length we are done
+	AShooterPickup* BestPickup = nullptr;
+	float BestLength = MAX_FLT;
+	for (int32 i = 0; i < Candidates.Num() && i < NumWanted; ++i)
+	{
+		if (BestPickup && Candidates[i].Key >= FMath::Square(BestLength))
+		{
+			break;
+		}
+
+		const float Length = GetPathCost(Origin, Candidates[i].Value);
+		if (Length >= 0.f && Length < BestLength)
+		{
+			BestLength = Length;
+			BestPickup = Candidates[i].Value;
+		}
+	}
+
+	// No path to any of them, fall back to the closest one
+	return BestPickup ? BestPickup : Candidates[0].Value;
+}
+
+float UShooterPickupIndex::GetPathCost(const FVector& Origin, AShooterPickup* Pickup)
+{
+	FPathCostKey Key;
+	Key.Origin = FIntVector(
+		FMath::RoundToInt(Origin.X / PickupPathCostQuantization),
+		FMath::RoundToInt(Origin.Y / PickupPathCostQuantization),
+		FMath::RoundToInt(Origin.Z / PickupPathCostQuantization));
+	Key.Pickup = Pickup;
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	if (const FPathCost* Cached = PathCosts.Find(Key))
+	{
+		if (Now - Cached->Time < ShooterPickupIndexPathCostMaxAge)
+		{
+			return Cached->Length;
+		}
+	}
+
+	if (PathCosts.Num() > 1024)
+	{
+		for (auto It = PathCosts.CreateIterator(); It; ++It)
+		{
+			if (Now - It.Value().Time >= ShooterPickupIndexPathCostMaxAge)
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	FPathCost& PathCost = PathCosts.Add(Key);
+	PathCost.Length = -1.f;
+	PathCost.Time = Now;
+
+	const UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	float PathLength = 0.f;
+	if (NavSys && NavSys->GetPathLength(Origin, Pickup->GetActorLocation(), PathLength) == ENavigationQueryResult::Success)
+	{
+		PathCost.Length = PathLength;
+	}
+
+	return PathCost.Length;
+}
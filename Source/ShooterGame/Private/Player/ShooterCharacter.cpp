@@ -5,6 +5,7 @@
 #include "Weapons/ShooterDamageType.h"
 #include "UI/ShooterHUD.h"
 #include "Online/ShooterPlayerState.h"
+#include "Player/ShooterDemoSpectator.h"
 #include "Animation/AnimMontage.h"
 #include "Animation/AnimInstance.h"
 #include "Sound/SoundNodeLocalPlayer.h"
@@ -112,7 +113,7 @@ void AShooterCharacter::PostInitializeComponents()
 	}
 
 	// play respawn effects
-	if (GetNetMode() != NM_DedicatedServer)
+	if (GetNetMode() != NM_DedicatedServer && !AShooterDemoSpectator::ShouldSkipCosmetics(GetWorld()))
 	{
 		if (RespawnFX)
 		{
@@ -409,7 +410,7 @@ void AShooterCharacter::OnDeath(float KillingDamage, struct FDamageEvent const&
 	}
 
 	// cannot use IsLocallyControlled here, because even local client's controller may be NULL here
-	if (GetNetMode() != NM_DedicatedServer && DeathSound && Mesh1P && Mesh1P->IsVisible())
+	if (GetNetMode() != NM_DedicatedServer && DeathSound && Mesh1P && Mesh1P->IsVisible() && !AShooterDemoSpectator::ShouldSkipCosmetics(GetWorld()))
 	{
 		UGameplayStatics::PlaySoundAtLocation(this, DeathSound, GetActorLocation());
 	}
@@ -1415,7 +1416,7 @@ void AShooterCharacter::Tick(float DeltaSeconds)
 
 		HidePlayerInGame();
 
-		if (GetNetMode() != NM_DedicatedServer)
+		if (GetNetMode() != NM_DedicatedServer && !AShooterDemoSpectator::ShouldSkipCosmetics(GetWorld()))
 			if (NS_AbilityEffect)
 				UNiagaraFunctionLibrary::SpawnSystemAtLocation(this, NS_AbilityEffect, GetActorLocation());
 	}
@@ -1521,7 +1522,7 @@ void AShooterCharacter::OnRep_Teleport() {
 }
 
 void AShooterCharacter::SimulateTeleport() {
-	if (GetNetMode() == NM_DedicatedServer)
+	if (GetNetMode() == NM_DedicatedServer || AShooterDemoSpectator::ShouldSkipCosmetics(GetWorld()))
 	{
 		return;
 	}
@@ -1661,7 +1662,7 @@ void AShooterCharacter::SetTimeRewind(bool timeRewind) {
 	if (!timeRewind)
 		StartTimeRewindCooldown();
 	else {
-		if (GetNetMode() != NM_DedicatedServer)
+		if (GetNetMode() != NM_DedicatedServer && !AShooterDemoSpectator::ShouldSkipCosmetics(GetWorld()))
 			if (SB_TimeRewindSound)
 				UGameplayStatics::PlaySoundAtLocation(this, SB_TimeRewindSound, GetActorLocation(), 2.0f, 2.0f);
 	}
@@ -0,0 +1,216 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Player/ShooterCharacterSpatialIndex.h"
+#include "Online/ShooterPlayerState.h"
+
+static float ShooterCharacterIndexCellSize = 2000.f;
+static FAutoConsoleVariableRef CVarShooterCharacterIndexCellSize(
+	TEXT("ShooterGame.CharacterIndex.CellSize"),
+	ShooterCharacterIndexCellSize,
+	TEXT("Cell size of the character spatial index grid used by bots and spawn selection."),
+	ECVF_Default);
+
+void UShooterCharacterSpatialIndex::UpdateIndex()
+{
+	if (IndexedFrame == GFrameCounter)
+	{
+		return;
+	}
+
+	QUICK_SCOPE_CYCLE_COUNTER(UShooterCharacterSpatialIndex_UpdateIndex);
+
+	IndexedFrame = GFrameCounter;
+	CellSize = FMath::Max(ShooterCharacterIndexCellSize, 100.f);
+	MaxCapsuleRadius = 0.f;
+	MinCell = FIntPoint(MAX_int32, MAX_int32);
+	MaxCell = FIntPoint(MIN_int32, MIN_int32);
+
+	Entries.Reset();
+	for (FTeamGrid& TeamGrid : TeamGrids)
+	{
+		TeamGrid.Cells.Reset();
+	}
+
+	for (AShooterCharacter* Character : TActorRange<AShooterCharacter>(GetWorld()))
+	{
+		const AShooterPlayerState* PlayerState = Cast<AShooterPlayerState>(Character->GetPlayerState());
+
+		const int32 EntryIndex = Entries.AddUninitialized();
+		FEntry& Entry = Entries[EntryIndex];
+		Entry.Character = Character;
+		Entry.Location = Character->GetActorLocation();
+		Entry.TeamNum = PlayerState ? PlayerState->GetTeamNum() : INDEX_NONE;
+		Entry.bAlive = Character->IsAlive();
+
+		FTeamGrid* TeamGrid = TeamGrids.FindByPredicate([&Entry](const FTeamGrid& Grid) { return Grid.TeamNum == Entry.TeamNum; });
+		if (TeamGrid == nullptr)
+		{
+			TeamGrid = &TeamGrids.AddDefaulted_GetRef();
+			TeamGrid->TeamNum = Entry.TeamNum;
+		}
+
+		const FIntPoint Cell = GetCell(Entry.Location);
+		TeamGrid->Cells.FindOrAdd(Cell).Add(EntryIndex);
+
+		MinCell = FIntPoint(FMath::Min(MinCell.X, Cell.X), FMath::Min(MinCell.Y, Cell.Y));
+		MaxCell = FIntPoint(FMath::Max(MaxCell.X, Cell.X), FMath::Max(MaxCell.Y, Cell.Y));
+		MaxCapsuleRadius = FMath::Max(MaxCapsuleRadius, Character->GetCapsuleComponent()->GetScaledCapsuleRadius());
+	}
+}
+
+FIntPoint UShooterCharacterSpatialIndex::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+void UShooterCharacterSpatialIndex::GatherCell(const FIntPoint& Cell, const FVector& Origin, float MaxDistSq, const FShooterCharacterQuery& Query, FCandidateArray& Candidates) const
+{
+	for (const FTeamGrid& TeamGrid : TeamGrids)
+	{
+		if ((Query.ExcludeTeam != INDEX_NONE && TeamGrid.TeamNum == Query.ExcludeTeam) || (Query.OnlyTeam != INDEX_NONE && TeamGrid.TeamNum != Query.OnlyTeam))
+		{
+			continue;
+		}
+
+		const TArray<int32, TInlineAllocator<4>>* CellEntries = TeamGrid.Cells.Find(Cell);
+		if (CellEntries == nullptr)
+		{
+			continue;
+		}
+
+		for (int32 EntryIndex : *CellEntries)
+		{
+			const FEntry& Entry = Entries[EntryIndex];
+			if (Query.bAliveOnly && !Entry.bAlive)
+			{
+				continue;
+			}
+
+			const float DistSq = Query.bDistance2D ? FVector::DistSquared2D(Entry.Location, Origin) : FVector::DistSquared(Entry.Location, Origin);
+			if (DistSq > MaxDistSq)
+			{
+				continue;
+			}
+
+			const AShooterCharacter* Character = Entry.Character.Get();
+			if (Character == nullptr || Character == Query.IgnoreActor || (Query.Filter && !Query.Filter(Character)))
+			{
+				continue;
+			}
+
+			Candidates.Emplace(DistSq, EntryIndex);
+		}
+	}
+}
+
+void UShooterCharacterSpatialIndex::FindInRadius(const FVector& Origin, float Radius, const FShooterCharacterQuery& Query, TArray<AShooterCharacter*>& OutCharacters)
+{
+	OutCharacters.Reset();
+	UpdateIndex();
+
+	if (Entries.Num() == 0)
+	{
+		return;
+	}
+
+	Radius = FMath::Min(Radius, Query.MaxDistance);
+	const FIntPoint OriginCell = GetCell(Origin);
+	const int32 CellRadius = FMath::CeilToInt(FMath::Min(Radius / CellSize, (float)MAX_int16));
+	const FIntPoint FirstCell = OriginCell - FIntPoint(CellRadius, CellRadius);
+	const FIntPoint LastCell = OriginCell + FIntPoint(CellRadius, CellRadius);
+
+	FCandidateArray Candidates;
+	for (int32 X = FMath::Max(FirstCell.X, MinCell.X); X <= FMath::Min(LastCell.X, MaxCell.X); ++X)
+	{
+		for (int32 Y = FMath::Max(FirstCell.Y, MinCell.Y); Y <= FMath::Min(LastCell.Y, MaxCell.Y); ++Y)
+		{
+			GatherCell(FIntPoint(X, Y), Origin, Radius < MAX_FLT ? FMath::Square(Radius) : MAX_FLT, Query, Candidates);
+		}
+	}
+
+	Candidates.Sort([](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key < B.Key; });
+
+	OutCharacters.Reserve(Candidates.Num());
+	for (const TPair<float, int32>& Candidate : Candidates)
+	{
+		OutCharacters.Add(Entries[Candidate.Value].Character.Get());
+	}
+}
+
+void UShooterCharacterSpatialIndex::FindNearest(const FVector& Origin, int32 NumCharacters, const FShooterCharacterQuery& Query, TArray<AShooterCharacter*>& OutCharacters)
+{
+	OutCharacters.Reset();
+	UpdateIndex();
+
+	if (Entries.Num() == 0 || NumCharacters <= 0)
+	{
+		return;
+	}
+
+	const float MaxDistSq = Query.MaxDistance < MAX_FLT ? FMath::Square(Query.MaxDistance) : MAX_FLT;
+	const FIntPoint OriginCell = GetCell(Origin);
+
+	// Rings of cells around the origin cell, until no cell is left or the rest is out of range
+	int32 MaxRing = FMath::Max(FMath::Max(OriginCell.X - MinCell.X, MaxCell.X - OriginCell.X), FMath::Max(OriginCell.Y - MinCell.Y, MaxCell.Y - OriginCell.Y));
+	if (Query.MaxDistance < MAX_FLT)
+	{
+		MaxRing = FMath::Min(MaxRing, FMath::FloorToInt(Query.MaxDistance / CellSize) + 1);
+	}
+
+	auto SortCandidates = [](FCandidateArray& Candidates) { Candidates.Sort([](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key < B.Key; }); };
+
+	FCandidateArray Candidates;
+	for (int32 Ring = 0; Ring <= MaxRing; ++Ring)
+	{
+		if (Ring == 0)
+		{
+			GatherCell(OriginCell, Origin, MaxDistSq, Query, Candidates);
+		}
+		else
+		{
+			for (int32 Offset = -Ring; Offset <= Ring; ++Offset)
+			{
+				GatherCell(FIntPoint(OriginCell.X + Offset, OriginCell.Y - Ring), Origin, MaxDistSq, Query, Candidates);
+				GatherCell(FIntPoint(OriginCell.X + Offset, OriginCell.Y + Ring), Origin, MaxDistSq, Query, Candidates);
+			}
+			for (int32 Offset = -Ring + 1; Offset <= Ring - 1; ++Offset)
+			{
+				GatherCell(FIntPoint(OriginCell.X - Ring, OriginCell.Y + Offset), Origin, MaxDistSq, Query, Candidates);
+				GatherCell(FIntPoint(OriginCell.X + Ring, OriginCell.Y + Offset), Origin, MaxDistSq, Query, Candidates);
+			}
+		}
+
+		// Anything in the next ring is at least Ring * CellSize away (in 2D, so also in 3D)
+		if (Candidates.Num() >= NumCharacters)
+		{
+			SortCandidates(Candidates);
+			if (Candidates[NumCharacters - 1].Key <= FMath::Square(Ring * CellSize))
+			{
+				break;
+			}
+		}
+	}
+
+	SortCandidates(Candidates);
+
+	const int32 NumResults = FMath::Min(NumCharacters, Candidates.Num());
+	OutCharacters.Reserve(NumResults);
+	for (int32 i = 0; i < NumResults; ++i)
+	{
+		OutCharacters.Add(Entries[Candidates[i].Value].Character.Get());
+	}
+}
+
+AShooterCharacter* UShooterCharacterSpatialIndex::FindNearest(const FVector& Origin, const FShooterCharacterQuery& Query)
+{
+	TArray<AShooterCharacter*> Nearest;
+	FindNearest(Origin, 1, Query, Nearest);
+	return Nearest.Num() > 0 ? Nearest[0] : nullptr;
+}
+
+float UShooterCharacterSpatialIndex::GetMaxCapsuleRadius()
+{
+	UpdateIndex();
+	return MaxCapsuleRadius;
+}
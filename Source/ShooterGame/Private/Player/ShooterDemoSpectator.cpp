@@ -5,12 +5,22 @@
 #include "UI/Menu/ShooterDemoPlaybackMenu.h"
 #include "UI/Widgets/SShooterDemoHUD.h"
 #include "Engine/DemoNetDriver.h"
+#include "Misc/FileHelper.h"
+
+static float ShooterReplayFastForwardSpeed = 4.f;
+static FAutoConsoleVariableRef CVarShooterReplayFastForwardSpeed(
+	TEXT("ShooterGame.Replay.FastForwardSpeed"),
+	ShooterReplayFastForwardSpeed,
+	TEXT("Replay playback speed at or above which cosmetic effects are skipped. 0 to never skip them."),
+	ECVF_Default);
 
 AShooterDemoSpectator::AShooterDemoSpectator(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 	bShowMouseCursor = true;
 	PrimaryActorTick.bTickEvenWhenPaused = true;
 	bShouldPerformFullTickWhenPaused = true;
+	BenchmarkSeeksLeft = 0;
+	BenchmarkNumSeeks = 0;
 }
 
 void AShooterDemoSpectator::SetupInputComponent()
@@ -67,22 +77,116 @@ void AShooterDemoSpectator::OnToggleInGameMenu()
 	}
 }
 
-static float PlaybackSpeedLUT[5] = { 0.1f, 0.5f, 1.0f, 2.0f, 4.0f };
+static float PlaybackSpeedLUT[7] = { 0.1f, 0.5f, 1.0f, 2.0f, 4.0f, 8.0f, 16.0f };
 
 void AShooterDemoSpectator::OnIncreasePlaybackSpeed()
 {
-	PlaybackSpeed = FMath::Clamp( PlaybackSpeed + 1, 0, 4 );
-
-	GetWorldSettings()->DemoPlayTimeDilation = PlaybackSpeedLUT[ PlaybackSpeed ];
+	SetPlaybackSpeed( PlaybackSpeed + 1 );
 }
 
 void AShooterDemoSpectator::OnDecreasePlaybackSpeed()
 {
-	PlaybackSpeed = FMath::Clamp( PlaybackSpeed - 1, 0, 4 );
+	SetPlaybackSpeed( PlaybackSpeed - 1 );
+}
+
+void AShooterDemoSpectator::SetPlaybackSpeed(int32 NewPlaybackSpeed)
+{
+	PlaybackSpeed = FMath::Clamp( NewPlaybackSpeed, 0, (int32)UE_ARRAY_COUNT(PlaybackSpeedLUT) - 1 );
 
 	GetWorldSettings()->DemoPlayTimeDilation = PlaybackSpeedLUT[ PlaybackSpeed ];
 }
 
+bool AShooterDemoSpectator::ShouldSkipCosmetics(const UWorld* World)
+{
+	if (World == nullptr || !World->IsPlayingReplay())
+	{
+		return false;
+	}
+
+	const UDemoNetDriver* DemoDriver = World->GetDemoNetDriver();
+	if (DemoDriver && DemoDriver->IsFastForwarding())
+	{
+		return true;
+	}
+
+	const AWorldSettings* WorldSettings = World->GetWorldSettings();
+	return ShooterReplayFastForwardSpeed > 0.f && WorldSettings && WorldSettings->DemoPlayTimeDilation >= ShooterReplayFastForwardSpeed;
+}
+
+void AShooterDemoSpectator::ReplaySeekBenchmark(int32 NumSeeks)
+{
+	const UDemoNetDriver* DemoDriver = GetWorld()->GetDemoNetDriver();
+	if (DemoDriver == nullptr || DemoDriver->IsServer() || BenchmarkSeeksLeft > 0)
+	{
+		UE_LOG(LogShooter, Warning, TEXT("ReplaySeekBenchmark needs a replay playing and no benchmark running"));
+		return;
+	}
+
+	BenchmarkNumSeeks = FMath::Max(NumSeeks, 1);
+	BenchmarkSeeksLeft = BenchmarkNumSeeks;
+	BenchmarkSeekMs.Reset(BenchmarkNumSeeks);
+	BenchmarkCsvRows.Reset(BenchmarkNumSeeks + 1);
+	BenchmarkCsvRows.Add(TEXT("Seek,TargetTime,SeekMs,Succeeded"));
+
+	UE_LOG(LogShooter, Log, TEXT("Replay seek benchmark: %d seeks over %.1fs of replay"), BenchmarkNumSeeks, DemoDriver->GetDemoTotalTime());
+	NextBenchmarkSeek();
+}
+
+void AShooterDemoSpectator::NextBenchmarkSeek()
+{
+	UDemoNetDriver* DemoDriver = GetWorld()->GetDemoNetDriver();
+	if (DemoDriver && BenchmarkSeeksLeft > 0)
+	{
+		// Golden ratio steps spread the targets over the replay and mix short, long, forward and backward seeks
+		const int32 SeekIndex = BenchmarkNumSeeks - BenchmarkSeeksLeft;
+		const float TargetTime = FMath::Frac(0.5f + SeekIndex * 0.618034f) * DemoDriver->GetDemoTotalTime();
+
+		BenchmarkSeeksLeft--;
+		DemoDriver->GotoTimeInSeconds(TargetTime, FOnGotoTimeDelegate::CreateUObject(this, &AShooterDemoSpectator::OnBenchmarkSeekComplete, FPlatformTime::Seconds(), TargetTime));
+		return;
+	}
+
+	BenchmarkSeeksLeft = 0;
+
+	const FString CsvFilename = FPaths::ProfilingDir() / TEXT("ReplaySeek") / FString::Printf(TEXT("ReplaySeek-%s.csv"), *FDateTime::Now().ToString());
+	if (!FFileHelper::SaveStringArrayToFile(BenchmarkCsvRows, *CsvFilename))
+	{
+		UE_LOG(LogShooter, Warning, TEXT("Failed to write replay seek benchmark to %s"), *CsvFilename);
+	}
+
+	const int32 NumSucceeded = BenchmarkSeekMs.Num();
+	if (NumSucceeded == 0)
+	{
+		UE_LOG(LogShooter, Warning, TEXT("Replay seek benchmark: no seek succeeded"));
+		return;
+	}
+
+	BenchmarkSeekMs.Sort();
+	float TotalMs = 0.f;
+	for (float Ms : BenchmarkSeekMs)
+	{
+		TotalMs += Ms;
+	}
+
+	UE_LOG(LogShooter, Log, TEXT("Replay seek benchmark: %d of %d seeks succeeded, avg %.0f ms, p95 %.0f ms, max %.0f ms. Report: %s"),
+		NumSucceeded, BenchmarkNumSeeks, TotalMs / NumSucceeded, BenchmarkSeekMs[FMath::Min(NumSucceeded - 1, (int32)(NumSucceeded * 0.95f))], BenchmarkSeekMs.Last(), *CsvFilename);
+}
+
+void AShooterDemoSpectator::OnBenchmarkSeekComplete(bool bWasSuccessful, double StartTime, float TargetTime)
+{
+	const float SeekMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	if (bWasSuccessful)
+	{
+		BenchmarkSeekMs.Add(SeekMs);
+	}
+
+	const int32 SeekIndex = BenchmarkNumSeeks - BenchmarkSeeksLeft - 1;
+	BenchmarkCsvRows.Add(FString::Printf(TEXT("%d,%.1f,%.1f,%d"), SeekIndex, TargetTime, SeekMs, bWasSuccessful ? 1 : 0));
+
+	// Not from inside the demo driver's seek callback
+	GetWorldTimerManager().SetTimerForNextTick(this, &AShooterDemoSpectator::NextBenchmarkSeek);
+}
+
 void AShooterDemoSpectator::Destroyed()
 {
 	if (GEngine != nullptr && GEngine->GameViewport != nullptr && DemoHUD.IsValid())
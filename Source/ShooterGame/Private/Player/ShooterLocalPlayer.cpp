@@ -35,7 +35,8 @@ void UShooterLocalPlayer::LoadPersistentUser()
 	// if we changed controllerid / user, then we need to load the appropriate persistent user.
 	if (PersistentUser != nullptr && ( GetControllerId() != PersistentUser->GetUserIndex() || SaveGameName != PersistentUser->GetName() ) )
 	{
-		PersistentUser->SaveIfDirty();
+		// Written before the next user's save is read, which may be the same slot
+		FlushPersistentUser();
 		PersistentUser = nullptr;
 	}
 
@@ -54,6 +55,15 @@ void UShooterLocalPlayer::LoadPersistentUser()
 	}
 }
 
+void UShooterLocalPlayer::FlushPersistentUser()
+{
+	if (PersistentUser != nullptr)
+	{
+		PersistentUser->SaveIfDirty();
+		PersistentUser->FlushSave();
+	}
+}
+
 void UShooterLocalPlayer::SetControllerId(int32 NewControllerId)
 {
 	ULocalPlayer::SetControllerId(NewControllerId);
@@ -68,7 +78,8 @@ void UShooterLocalPlayer::SetControllerId(int32 NewControllerId)
 	// if we changed controllerid / user, then we need to load the appropriate persistent user.
 	if (PersistentUser != nullptr && ( GetControllerId() != PersistentUser->GetUserIndex() || SaveGameName != PersistentUser->GetName() ) )
 	{
-		PersistentUser->SaveIfDirty();
+		// Written before the next user's save is read, which may be the same slot
+		FlushPersistentUser();
 		PersistentUser = nullptr;
 	}
 
@@ -0,0 +1,215 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Player/ShooterMatchHistory.h"
+#include "Algo/Reverse.h"
+#include "Async/Async.h"
+#include "Async/MappedFileHandle.h"
+
+namespace ShooterMatchHistory
+{
+	/** Start of the file. Bump Version whenever FShooterMatchRecord changes, logs of other versions are moved aside */
+	struct FHeader
+	{
+		uint32 Magic;
+		uint16 Version;
+		uint16 RecordSize;
+	};
+
+	static const uint32 Magic = 0x53484D48;
+	static const uint16 Version = 1;
+	static const uint32 RecordEndMarker = 0x52454E44;
+	static const int64 HeaderSize = sizeof(FHeader);
+	static const int64 RecordSize = sizeof(FShooterMatchRecord);
+
+	/** Size of the log if it exists and has a current header, -1 otherwise */
+	static int64 GetValidFileSize(const FString& Filename)
+	{
+		TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Filename, FILEREAD_Silent));
+		if (!Reader || Reader->TotalSize() < HeaderSize)
+		{
+			return -1;
+		}
+
+		FHeader Header;
+		Reader->Serialize(&Header, HeaderSize);
+		const bool bValid = !Reader->IsError() && Header.Magic == Magic && Header.Version == Version && Header.RecordSize == RecordSize;
+
+		return bValid ? Reader->TotalSize() : -1;
+	}
+
+	/** Number of whole records in a log of FileSize */
+	static int32 GetNumRecords(int64 FileSize)
+	{
+		return FileSize >= HeaderSize ? (int32)((FileSize - HeaderSize) / RecordSize) : 0;
+	}
+
+	/** Appends one record, creating the log or padding out a record cut short by a crash first */
+	static void AppendRecord(const FString& Filename, const FShooterMatchRecord& Record)
+	{
+		IFileManager& FileManager = IFileManager::Get();
+
+		int64 FileSize = GetValidFileSize(Filename);
+		if (FileSize < 0 && FileManager.FileExists(*Filename))
+		{
+			UE_LOG(LogShooter, Warning, TEXT("Match history %s is from another version, starting a new one"), *Filename);
+			FileManager.Move(*(Filename + TEXT(".old")), *Filename, true);
+		}
+
+		TUniquePtr<FArchive> Writer(FileManager.CreateFileWriter(*Filename, FILEWRITE_Append));
+		if (!Writer)
+		{
+			UE_LOG(LogShooter, Warning, TEXT("Failed to open match history %s"), *Filename);
+			return;
+		}
+
+		if (FileSize < 0)
+		{
+			FHeader Header;
+			Header.Magic = Magic;
+			Header.Version = Version;
+			Header.RecordSize = RecordSize;
+			Writer->Serialize(&Header, HeaderSize);
+			FileSize = HeaderSize;
+		}
+
+		// The padded record has no end marker, readers skip it
+		const int64 PartialRecordSize = (FileSize - HeaderSize) % RecordSize;
+		if (PartialRecordSize > 0)
+		{
+			uint8 Padding[sizeof(FShooterMatchRecord)] = {};
+			Writer->Serialize(Padding, RecordSize - PartialRecordSize);
+		}
+
+		FShooterMatchRecord RecordToWrite = Record;
+		Writer->Serialize(&RecordToWrite, RecordSize);
+
+		if (!Writer->Close())
+		{
+			UE_LOG(LogShooter, Warning, TEXT("Failed to write match history %s"), *Filename);
+		}
+	}
+}
+
+FShooterMatchHistory::FShooterMatchHistory(const FString& SlotName)
+	: Filename(FPaths::ProjectSavedDir() / TEXT("SaveGames") / SlotName + TEXT(".matches"))
+{
+}
+
+FShooterMatchHistory::~FShooterMatchHistory()
+{
+	WaitForPendingAppend();
+}
+
+void FShooterMatchHistory::AddMatch(const FShooterMatchRecord& Record)
+{
+	// Keep appends in order
+	WaitForPendingAppend();
+
+	FShooterMatchRecord RecordToWrite = Record;
+	RecordToWrite.EndMarker = ShooterMatchHistory::RecordEndMarker;
+
+	const FString LogFilename = Filename;
+	PendingAppend = Async(EAsyncExecution::ThreadPool, [LogFilename, RecordToWrite]()
+	{
+		ShooterMatchHistory::AppendRecord(LogFilename, RecordToWrite);
+	});
+}
+
+int32 FShooterMatchHistory::GetNumMatches()
+{
+	WaitForPendingAppend();
+
+	return ShooterMatchHistory::GetNumRecords(ShooterMatchHistory::GetValidFileSize(Filename));
+}
+
+void FShooterMatchHistory::GetRecentMatches(int32 Count, TArray<FShooterMatchRecord>& OutMatches)
+{
+	const int32 NumMatches = GetNumMatches();
+	Count = FMath::Clamp(Count, 0, NumMatches);
+
+	ReadRecords(NumMatches - Count, Count, OutMatches);
+	Algo::Reverse(OutMatches);
+}
+
+void FShooterMatchHistory::GetKillDeathTrend(int32 WindowSize, int32 NumWindows, TArray<float>& OutRatios)
+{
+	OutRatios.Reset();
+	if (WindowSize <= 0 || NumWindows <= 0)
+	{
+		return;
+	}
+
+	TArray<FShooterMatchRecord> Matches;
+	GetRecentMatches(WindowSize * NumWindows, Matches);
+
+	for (int32 WindowStart = 0; WindowStart < Matches.Num(); WindowStart += WindowSize)
+	{
+		int32 Kills = 0;
+		int32 Deaths = 0;
+		for (int32 i = WindowStart; i < FMath::Min(WindowStart + WindowSize, Matches.Num()); ++i)
+		{
+			Kills += Matches[i].Kills;
+			Deaths += Matches[i].Deaths;
+		}
+
+		OutRatios.Add((float)Kills / FMath::Max(Deaths, 1));
+	}
+}
+
+void FShooterMatchHistory::ReadRecords(int32 FirstRecord, int32 Count, TArray<FShooterMatchRecord>& OutRecords) const
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_ShooterMatchHistory_ReadRecords);
+
+	OutRecords.Reset();
+	if (Count <= 0)
+	{
+		return;
+	}
+
+	const int64 Offset = ShooterMatchHistory::HeaderSize + FirstRecord * ShooterMatchHistory::RecordSize;
+	const int64 NumBytes = Count * ShooterMatchHistory::RecordSize;
+	OutRecords.SetNumUninitialized(Count);
+
+	// Only the pages holding the requested records are read in
+	bool bRead = false;
+	TUniquePtr<IMappedFileHandle> MappedFile(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+	if (MappedFile)
+	{
+		TUniquePtr<IMappedFileRegion> MappedRegion(MappedFile->MapRegion(Offset, NumBytes));
+		if (MappedRegion && MappedRegion->GetMappedSize() == NumBytes)
+		{
+			FMemory::Memcpy(OutRecords.GetData(), MappedRegion->GetMappedPtr(), NumBytes);
+			bRead = true;
+		}
+	}
+
+	// Platforms without mapped files
+	if (!bRead)
+	{
+		TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Filename, FILEREAD_Silent));
+		if (Reader && Reader->TotalSize() >= Offset + NumBytes)
+		{
+			Reader->Seek(Offset);
+			Reader->Serialize(OutRecords.GetData(), NumBytes);
+			bRead = !Reader->IsError();
+		}
+	}
+
+	if (!bRead)
+	{
+		OutRecords.Reset();
+		return;
+	}
+
+	OutRecords.RemoveAll([](const FShooterMatchRecord& Record) { return Record.EndMarker != ShooterMatchHistory::RecordEndMarker; });
+}
+
+void FShooterMatchHistory::WaitForPendingAppend()
+{
+	if (PendingAppend.IsValid())
+	{
+		PendingAppend.Wait();
+		PendingAppend = TFuture<void>();
+	}
+}
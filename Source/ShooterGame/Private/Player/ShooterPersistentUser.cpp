@@ -3,6 +3,42 @@
 #include "ShooterGame.h"
 #include "Player/ShooterPersistentUser.h"
 #include "ShooterLocalPlayer.h"
+#include "Player/ShooterMatchHistory.h"
+#include "Async/Async.h"
+#include "PlatformFeatures.h"
+#include "SaveGameSystem.h"
+
+static float ShooterPersistentUserSaveDelay = 2.0f;
+static FAutoConsoleVariableRef CVarShooterPersistentUserSaveDelay(
+	TEXT("ShooterGame.PersistentUser.SaveDelay"),
+	ShooterPersistentUserSaveDelay,
+	TEXT("Seconds a persistent user save waits for further changes before it is written."),
+	ECVF_Default);
+
+namespace ShooterPersistentUser
+{
+#if PLATFORM_DESKTOP
+	/** Where the generic save game system keeps a slot */
+	static FString GetSaveFilename(const FString& SlotName)
+	{
+		return FPaths::ProjectSavedDir() / TEXT("SaveGames") / SlotName + TEXT(".sav");
+	}
+#endif
+
+	/** Writes serialized save data to the slot, may be called from any thread */
+	static bool WriteSaveData(const TArray<uint8>& Data, const FString& SlotName, int32 UserIndex)
+	{
+#if PLATFORM_DESKTOP
+		// Write next to the save and rename over it, so a crash mid-write leaves the old save (or the new one in the .tmp) intact
+		const FString Filename = GetSaveFilename(SlotName);
+		const FString TempFilename = Filename + TEXT(".tmp");
+		return FFileHelper::SaveArrayToFile(Data, *TempFilename) && IFileManager::Get().Move(*Filename, *TempFilename, true);
+#else
+		ISaveGameSystem* SaveSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem();
+		return SaveSystem && SaveSystem->SaveGame(false, *SlotName, UserIndex, Data);
+#endif
+	}
+}
 
 UShooterPersistentUser::UShooterPersistentUser(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -100,8 +136,81 @@ bool UShooterPersistentUser::IsInvertedYAxisDirty() const
 
 void UShooterPersistentUser::SavePersistentUser()
 {
-	UGameplayStatics::SaveGameToSlot(this, SlotName, UserIndex);
+	if (!ScheduledSaveHandle.IsValid())
+	{
+		ScheduledSaveHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UShooterPersistentUser::HandleScheduledSave), ShooterPersistentUserSaveDelay);
+	}
+}
+
+bool UShooterPersistentUser::HandleScheduledSave(float DeltaTime)
+{
+	// Keep writes in order, try again after another delay
+	if (PendingWrite.IsValid() && !PendingWrite.IsReady())
+	{
+		return true;
+	}
+
+	ScheduledSaveHandle.Reset();
+
+	TArray<uint8> Data;
+	const double SerializeStartTime = FPlatformTime::Seconds();
+	{
+		QUICK_SCOPE_CYCLE_COUNTER(STAT_ShooterPersistentUser_Serialize);
+		if (!UGameplayStatics::SaveGameToMemory(this, Data))
+		{
+			UE_LOG(LogShooter, Warning, TEXT("Failed to serialize persistent user %s"), *SlotName);
+			return false;
+		}
+	}
+	const double SerializeMs = (FPlatformTime::Seconds() - SerializeStartTime) * 1000.0;
 	bIsDirty = false;
+
+	const FString WriteSlotName = SlotName;
+	const int32 WriteUserIndex = UserIndex;
+	PendingWrite = Async(EAsyncExecution::ThreadPool, [Data = MoveTemp(Data), WriteSlotName, WriteUserIndex, SerializeMs]()
+	{
+		const double WriteStartTime = FPlatformTime::Seconds();
+		const bool bSuccess = ShooterPersistentUser::WriteSaveData(Data, WriteSlotName, WriteUserIndex);
+		if (!bSuccess)
+		{
+			UE_LOG(LogShooter, Warning, TEXT("Failed to write persistent user %s"), *WriteSlotName);
+		}
+		else
+		{
+			UE_LOG(LogShooter, Log, TEXT("Saved persistent user %s (%d bytes): serializing took %.2f ms on the game thread, writing %.2f ms in the background"),
+				*WriteSlotName, Data.Num(), SerializeMs, (FPlatformTime::Seconds() - WriteStartTime) * 1000.0);
+		}
+		return bSuccess;
+	});
+
+	return false;
+}
+
+void UShooterPersistentUser::FlushSave()
+{
+	if (ScheduledSaveHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(ScheduledSaveHandle);
+		ScheduledSaveHandle.Reset();
+
+		if (PendingWrite.IsValid())
+		{
+			PendingWrite.Wait();
+		}
+		HandleScheduledSave(0.0f);
+	}
+
+	if (PendingWrite.IsValid())
+	{
+		PendingWrite.Wait();
+	}
+}
+
+void UShooterPersistentUser::BeginDestroy()
+{
+	FlushSave();
+
+	Super::BeginDestroy();
 }
 
 UShooterPersistentUser* UShooterPersistentUser::LoadPersistentUser(FString SlotName, const int32 UserIndex)
@@ -112,6 +221,16 @@ UShooterPersistentUser* UShooterPersistentUser::LoadPersistentUser(FString SlotN
 	// Persistent users aren't valid in this state.
 	if (SlotName.Len() > 0)
 	{
+#if PLATFORM_DESKTOP
+		// A crash between writing a save and renaming it leaves only the new save, in the .tmp
+		const FString Filename = ShooterPersistentUser::GetSaveFilename(SlotName);
+		const FString TempFilename = Filename + TEXT(".tmp");
+		if (!IFileManager::Get().FileExists(*Filename) && IFileManager::Get().FileExists(*TempFilename))
+		{
+			IFileManager::Get().Move(*Filename, *TempFilename);
+		}
+#endif
+
 		if (!GIsBuildMachine && UGameplayStatics::DoesSaveGameExist(SlotName, UserIndex))
 		{
 			Result = Cast<UShooterPersistentUser>(UGameplayStatics::LoadGameFromSlot(SlotName, UserIndex));
@@ -156,6 +275,28 @@ void UShooterPersistentUser::AddMatchResult(int32 MatchKills, int32 MatchDeaths,
 	}
 
 	bIsDirty = true;
+
+	if (FShooterMatchHistory* History = GetMatchHistory())
+	{
+		FShooterMatchRecord Record;
+		Record.Timestamp = FDateTime::UtcNow().GetTicks();
+		Record.Kills = MatchKills;
+		Record.Deaths = MatchDeaths;
+		Record.BulletsFired = MatchBulletsFired;
+		Record.RocketsFired = MatchRocketsFired;
+		Record.Flags = bIsMatchWinner ? FShooterMatchRecord::Flag_Won : 0;
+		History->AddMatch(Record);
+	}
+}
+
+FShooterMatchHistory* UShooterPersistentUser::GetMatchHistory()
+{
+	if (!MatchHistory.IsValid() && SlotName.Len() > 0)
+	{
+		MatchHistory = MakeShared<FShooterMatchHistory>(SlotName);
+	}
+
+	return MatchHistory.Get();
 }
 
 void UShooterPersistentUser::TellInputAboutKeybindings()
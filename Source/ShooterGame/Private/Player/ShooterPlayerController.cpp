@@ -7,6 +7,7 @@
 #include "Player/ShooterLocalPlayer.h"
 #include "Online/ShooterPlayerState.h"
 #include "Weapons/ShooterWeapon.h"
+#include "Weapons/ShooterProjectile.h"
 #include "UI/Menu/ShooterIngameMenu.h"
 #include "UI/Style/ShooterStyle.h"
 #include "UI/ShooterHUD.h"
@@ -48,6 +49,20 @@ static const int32 LotsRocketsCount = 10;
 static const int32 GoodScoreCount = 10;
 static const int32 GreatScoreCount = 15;
 
+static int32 ShooterChatBurst = 5;
+static FAutoConsoleVariableRef CVarShooterChatBurst(
+	TEXT("ShooterGame.Chat.Burst"),
+	ShooterChatBurst,
+	TEXT("Number of chat messages a player can send at once before the rate limit applies. 0 for no limit."),
+	ECVF_Default);
+
+static float ShooterChatMessagesPerSecond = 0.5f;
+static FAutoConsoleVariableRef CVarShooterChatMessagesPerSecond(
+	TEXT("ShooterGame.Chat.MessagesPerSecond"),
+	ShooterChatMessagesPerSecond,
+	TEXT("Sustained number of chat messages per second a player can send, messages over the limit are dropped by the server."),
+	ECVF_Default);
+
 #if !defined(TRACK_STATS_LOCALLY)
 #define TRACK_STATS_LOCALLY 1
 #endif
@@ -61,6 +76,8 @@ AShooterPlayerController::AShooterPlayerController(const FObjectInitializer& Obj
 	LastDeathLocation = FVector::ZeroVector;
 
 	ServerSayString = TEXT("Say");
+	ChatTokens = 0.0f;
+	LastChatTime = -1.0;
 	ShooterFriendUpdateTimer = 0.0f;
 	bHasSentStartEvents = false;
 
@@ -362,6 +379,23 @@ void AShooterPlayerController::ClientSetSpectatorCamera_Implementation(FVector C
 	SetViewTarget(this);
 }
 
+void AShooterPlayerController::ClientPlayProjectileExplosion_Implementation(TSubclassOf<AShooterExplosionEffect> ExplosionTemplate, FVector_NetQuantize ImpactPoint, FVector_NetQuantizeNormal ImpactNormal)
+{
+	// find surface for decals, same as AShooterProjectile::OnRep_Exploded
+	const FVector StartTrace = ImpactPoint + ImpactNormal * 50.0f;
+	const FVector EndTrace = ImpactPoint - ImpactNormal * 50.0f;
+	FHitResult Impact;
+
+	if (!GetWorld()->LineTraceSingleByChannel(Impact, StartTrace, EndTrace, COLLISION_PROJECTILE, FCollisionQueryParams(SCENE_QUERY_STAT(ProjExplosionEvent), true)))
+	{
+		// failsafe
+		Impact.ImpactPoint = ImpactPoint;
+		Impact.ImpactNormal = ImpactNormal;
+	}
+
+	AShooterProjectile::SpawnExplosionEffect(GetWorld(), ExplosionTemplate, Impact);
+}
+
 bool AShooterPlayerController::FindDeathCameraSpot(FVector& CameraLocation, FRotator& CameraRotation)
 {
 	const FVector PawnLocation = GetPawn()->GetActorLocation();
@@ -966,7 +1000,7 @@ void AShooterPlayerController::GetLifetimeReplicatedProps( TArray< FLifetimeProp
 	DOREPLIFETIME_CONDITION( AShooterPlayerController, bInfiniteAmmo, COND_OwnerOnly );
 	DOREPLIFETIME_CONDITION( AShooterPlayerController, bInfiniteClip, COND_OwnerOnly );
 
-	DOREPLIFETIME(AShooterPlayerController, bHealthRegen);
+	DOREPLIFETIME_CONDITION( AShooterPlayerController, bHealthRegen, COND_SkipReplay );
 }
 
 void AShooterPlayerController::Suicide()
@@ -977,6 +1011,24 @@ void AShooterPlayerController::Suicide()
 	}
 }
 
+void AShooterPlayerController::PerfOverlay()
+{
+	AShooterHUD* ShooterHUD = GetShooterHUD();
+	if (ShooterHUD)
+	{
+		ShooterHUD->TogglePerfOverlay();
+	}
+}
+
+void AShooterPlayerController::PerfCapture(float Seconds)
+{
+	AShooterHUD* ShooterHUD = GetShooterHUD();
+	if (ShooterHUD && Seconds > 0.f)
+	{
+		ShooterHUD->StartPerfCapture(Seconds);
+	}
+}
+
 bool AShooterPlayerController::ServerSuicide_Validate()
 {
 	return true;
@@ -1060,7 +1112,43 @@ bool AShooterPlayerController::ServerSay_Validate( const FString& Msg )
 
 void AShooterPlayerController::ServerSay_Implementation( const FString& Msg )
 {
-	GetWorld()->GetAuthGameMode<AShooterGameMode>()->Broadcast(this, Msg, ServerSayString);
+	if (!ConsumeChatToken())
+	{
+		UE_LOG(LogShooter, Verbose, TEXT("Dropped chat message from %s, over the rate limit"), PlayerState ? *PlayerState->GetPlayerName() : *GetName());
+		return;
+	}
+
+	GetWorld()->GetAuthGameMode<AShooterGameMode>()->Broadcast(this, Msg.Left(128), ServerSayString);
+}
+
+bool AShooterPlayerController::ConsumeChatToken()
+{
+	if (ShooterChatBurst <= 0)
+	{
+		return true;
+	}
+
+	// Token bucket, refilled at MessagesPerSecond up to Burst.
+	// Platform time rather than world time: the controller survives seamless travel, the world's real time clock does not.
+	const double Now = FPlatformTime::Seconds();
+	if (LastChatTime < 0.0)
+	{
+		ChatTokens = ShooterChatBurst;
+	}
+	else
+	{
+		const float Elapsed = FMath::Max<float>(Now - LastChatTime, 0.0f);
+		ChatTokens = FMath::Min<float>(ChatTokens + Elapsed * ShooterChatMessagesPerSecond, ShooterChatBurst);
+	}
+	LastChatTime = Now;
+
+	if (ChatTokens < 1.0f)
+	{
+		return false;
+	}
+
+	ChatTokens -= 1.0f;
+	return true;
 }
 
 AShooterHUD* AShooterPlayerController::GetShooterHUD() const
@@ -1391,6 +1479,7 @@ void AShooterPlayerController::UpdateSaveFileOnGameEnd(bool bIsWinner)
 		UShooterPersistentUser* const PersistentUser = GetPersistentUser();
 		if (PersistentUser)
 		{
+			// Only schedules the save, HandleScheduledSave logs how long serializing and writing it take
 			PersistentUser->AddMatchResult(ShooterPlayerState->GetKills(), ShooterPlayerState->GetDeaths(), ShooterPlayerState->GetNumBulletsFired(), ShooterPlayerState->GetNumRocketsFired(), bIsWinner);
 			PersistentUser->SaveIfDirty();
 		}
@@ -15,11 +15,14 @@
 #include "ShooterMenuItemWidgetStyle.h"
 #include "ShooterGameViewportClient.h"
 #include "Player/ShooterPlayerController_Menu.h"
+#include "Player/ShooterLocalPlayer.h"
 #include "Online/ShooterPlayerState.h"
 #include "Online/ShooterGameSession.h"
 #include "Online/ShooterOnlineSessionClient.h"
 #include "OnlineSubsystemUtils.h"
 #include "ShooterGameUserSettings.h"
+#include "ShooterReplayIndex.h"
+#include "Engine/DemoNetDriver.h"
 
 #if !defined(CONTROLLER_SWAPPING)
 	#define CONTROLLER_SWAPPING 0
@@ -174,6 +177,15 @@ void UShooterGameInstance::Init()
 
 void UShooterGameInstance::Shutdown()
 {
+	// Saves still waiting out their delay would otherwise only be written when GC gets to them, if it does before exit
+	for (ULocalPlayer* LocalPlayer : LocalPlayers)
+	{
+		if (UShooterLocalPlayer* ShooterLocalPlayer = Cast<UShooterLocalPlayer>(LocalPlayer))
+		{
+			ShooterLocalPlayer->FlushPersistentUser();
+		}
+	}
+
 	Super::Shutdown();
 	
 	// Clear the activities delegate
@@ -254,6 +266,15 @@ void UShooterGameInstance::HandleSessionFailure( const FUniqueNetId& NetId, ESes
 
 void UShooterGameInstance::OnPreLoadMap(const FString& MapName)
 {
+	// Leaving a map we were recording, its replay is finished
+	UWorld* const World = GetWorld();
+	UDemoNetDriver* const DemoDriver = World ? World->GetDemoNetDriver() : nullptr;
+	if (DemoDriver && DemoDriver->IsRecording() && !IsRunningDedicatedServer())
+	{
+		GetReplayIndex()->AddRecording(DemoDriver->GetActiveReplayName(), UWorld::RemovePIEPrefix(World->GetMapName()));
+		GetReplayIndex()->SaveIfDirty();
+	}
+
 	if (bPendingEnableSplitscreen)
 	{
 		// Allow splitscreen
@@ -1116,6 +1137,15 @@ bool UShooterGameInstance::JoinSession(ULocalPlayer* LocalPlayer, const FOnlineS
 	return false;
 }
 
+UShooterReplayIndex* UShooterGameInstance::GetReplayIndex()
+{
+	if (ReplayIndex == nullptr)
+	{
+		ReplayIndex = UShooterReplayIndex::LoadReplayIndex();
+	}
+	return ReplayIndex;
+}
+
 bool UShooterGameInstance::PlayDemo(ULocalPlayer* LocalPlayer, const FString& DemoName)
 {
 	ShowLoadingScreen();
@@ -0,0 +1,142 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterReplayIndex.h"
+#include "Misc/NetworkVersion.h"
+
+namespace ShooterReplayIndex
+{
+	static const FString SlotName(TEXT("ReplayIndex"));
+}
+
+UShooterReplayIndex::UShooterReplayIndex(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, IndexVersion(CurrentIndexVersion)
+	, bIsDirty(false)
+{
+}
+
+UShooterReplayIndex* UShooterReplayIndex::LoadReplayIndex()
+{
+	UShooterReplayIndex* Result = nullptr;
+
+	if (UGameplayStatics::DoesSaveGameExist(ShooterReplayIndex::SlotName, 0))
+	{
+		Result = Cast<UShooterReplayIndex>(UGameplayStatics::LoadGameFromSlot(ShooterReplayIndex::SlotName, 0));
+	}
+
+	if (Result == nullptr || Result->IndexVersion != CurrentIndexVersion)
+	{
+		// Missing or out of date, the first Reconcile fills it
+		Result = Cast<UShooterReplayIndex>(UGameplayStatics::CreateSaveGameObject(UShooterReplayIndex::StaticClass()));
+	}
+	check(Result != nullptr);
+
+	return Result;
+}
+
+void UShooterReplayIndex::SaveIfDirty()
+{
+	if (bIsDirty)
+	{
+		// The index is serialized right away, only the file write happens on another thread
+		UGameplayStatics::AsyncSaveGameToSlot(this, ShooterReplayIndex::SlotName, 0);
+		bIsDirty = false;
+	}
+}
+
+void UShooterReplayIndex::AddRecording(const FString& Name, const FString& MapName)
+{
+	FShooterReplayIndexEntry* Entry = Entries.FindByPredicate([&Name](const FShooterReplayIndexEntry& Existing) { return Existing.Name == Name; });
+	if (Entry == nullptr)
+	{
+		Entry = &Entries.AddDefaulted_GetRef();
+		Entry->Name = Name;
+		Entry->Timestamp = FDateTime::UtcNow();
+	}
+
+	Entry->MapName = MapName;
+	Entry->NetworkVersion = FNetworkVersion::GetReplayVersion().NetworkVersion;
+
+	SortEntries();
+	bIsDirty = true;
+}
+
+void UShooterReplayIndex::RemoveReplay(const FString& Name)
+{
+	if (Entries.RemoveAll([&Name](const FShooterReplayIndexEntry& Entry) { return Entry.Name == Name; }) > 0)
+	{
+		bIsDirty = true;
+	}
+}
+
+bool UShooterReplayIndex::Reconcile(const TArray<FNetworkReplayStreamInfo>& AllStreams, const TArray<FNetworkReplayStreamInfo>& CurrentVersionStreams)
+{
+	const uint32 CurrentNetworkVersion = FNetworkVersion::GetReplayVersion().NetworkVersion;
+
+	TSet<FString> CurrentVersionNames;
+	for (const FNetworkReplayStreamInfo& StreamInfo : CurrentVersionStreams)
+	{
+		CurrentVersionNames.Add(StreamInfo.Name);
+	}
+
+	TMap<FString, int32> EntryIndices;
+	for (int32 i = 0; i < Entries.Num(); ++i)
+	{
+		EntryIndices.Add(Entries[i].Name, i);
+	}
+
+	bool bChanged = false;
+	TSet<FString> StreamNames;
+
+	for (const FNetworkReplayStreamInfo& StreamInfo : AllStreams)
+	{
+		StreamNames.Add(StreamInfo.Name);
+
+		const int32* EntryIndex = EntryIndices.Find(StreamInfo.Name);
+		FShooterReplayIndexEntry NewEntry = EntryIndex ? Entries[*EntryIndex] : FShooterReplayIndexEntry();
+		NewEntry.Name = StreamInfo.Name;
+		NewEntry.FriendlyName = StreamInfo.FriendlyName;
+		NewEntry.Timestamp = StreamInfo.Timestamp;
+		NewEntry.LengthInMS = StreamInfo.LengthInMS;
+		NewEntry.SizeInBytes = StreamInfo.SizeInBytes;
+		NewEntry.NetworkVersion = CurrentVersionNames.Contains(StreamInfo.Name) ? CurrentNetworkVersion : 0;
+		NewEntry.bIsLive = StreamInfo.bIsLive;
+		NewEntry.NumViewers = StreamInfo.NumViewers;
+
+		if (EntryIndex == nullptr)
+		{
+			Entries.Add(NewEntry);
+			bChanged = true;
+		}
+		else
+		{
+			FShooterReplayIndexEntry& Entry = Entries[*EntryIndex];
+			if (Entry.FriendlyName != NewEntry.FriendlyName || Entry.Timestamp != NewEntry.Timestamp || Entry.LengthInMS != NewEntry.LengthInMS || Entry.SizeInBytes != NewEntry.SizeInBytes ||
+				Entry.NetworkVersion != NewEntry.NetworkVersion || Entry.bIsLive != NewEntry.bIsLive || Entry.NumViewers != NewEntry.NumViewers)
+			{
+				Entry = NewEntry;
+				bChanged = true;
+			}
+		}
+	}
+
+	// Replays deleted outside of the game
+	if (Entries.RemoveAll([&StreamNames](const FShooterReplayIndexEntry& Entry) { return !StreamNames.Contains(Entry.Name); }) > 0)
+	{
+		bChanged = true;
+	}
+
+	if (bChanged)
+	{
+		SortEntries();
+		bIsDirty = true;
+	}
+
+	return bChanged;
+}
+
+void UShooterReplayIndex::SortEntries()
+{
+	Entries.StableSort([](const FShooterReplayIndexEntry& A, const FShooterReplayIndexEntry& B) { return A.Timestamp > B.Timestamp; });
+}
@@ -0,0 +1,84 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Online/ShooterGameSession.h"
+#include "OnlineSubsystemSessionSettings.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ShooterMatchmakingTest
+{
+	/** Session info of a made up search result, the way the Null subsystem reports LAN sessions */
+	class FTestSessionInfo : public FOnlineSessionInfo
+	{
+	public:
+		explicit FTestSessionInfo(const FString& InSessionId)
+			: SessionId(InSessionId, FName(TEXT("ShooterMatchmakingTest")))
+		{
+		}
+
+		virtual const uint8* GetBytes() const override { return nullptr; }
+		virtual int32 GetSize() const override { return sizeof(FTestSessionInfo); }
+		virtual bool IsValid() const override { return true; }
+		virtual FString ToString() const override { return SessionId.ToString(); }
+		virtual FString ToDebugString() const override { return SessionId.ToString(); }
+		virtual const FUniqueNetId& GetSessionId() const override { return SessionId; }
+
+	private:
+		FUniqueNetIdString SessionId;
+	};
+
+	static FOnlineSessionSearchResult MakeSearchResult(const FString& SessionId, int32 PingInMs, int32 MaxPlayers, int32 NumPlayers, int32 BuildUniqueId = GetBuildUniqueId())
+	{
+		FOnlineSessionSearchResult SearchResult;
+		SearchResult.PingInMs = PingInMs;
+		SearchResult.Session.SessionInfo = MakeShared<FTestSessionInfo>(SessionId);
+		SearchResult.Session.SessionSettings.BuildUniqueId = BuildUniqueId;
+		SearchResult.Session.SessionSettings.NumPublicConnections = MaxPlayers;
+		SearchResult.Session.SessionSettings.NumPrivateConnections = 0;
+		SearchResult.Session.NumOpenPublicConnections = MaxPlayers - NumPlayers;
+		SearchResult.Session.NumOpenPrivateConnections = 0;
+		return SearchResult;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterMatchmakingRankTest, "ShooterGame.Online.Matchmaking.Rank", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShooterMatchmakingRankTest::RunTest(const FString& Parameters)
+{
+	using namespace ShooterMatchmakingTest;
+
+	TArray<FOnlineSessionSearchResult> SearchResults;
+	SearchResults.Add(MakeSearchResult(TEXT("FarQuiet"), 200, 8, 2));
+	SearchResults.Add(MakeSearchResult(TEXT("NearBusy"), 30, 8, 6));
+	SearchResults.Add(MakeSearchResult(TEXT("NearLastSlot"), 30, 8, 7));
+	SearchResults.Add(MakeSearchResult(TEXT("Full"), 10, 8, 8));
+	SearchResults.Add(MakeSearchResult(TEXT("OtherBuild"), 10, 8, 2, GetBuildUniqueId() + 1));
+
+	TestTrue(TEXT("A full session is never tried"), AShooterGameSession::ScoreSearchResult(SearchResults[3]) < 0.f);
+	TestTrue(TEXT("A session from another build is never tried"), AShooterGameSession::ScoreSearchResult(SearchResults[4]) < 0.f);
+
+	const double Now = 1000000.0;
+	TMap<FString, double> JoinFailureTimes;
+	TArray<int32> Candidates;
+
+	AShooterGameSession::RankSearchResults(SearchResults, JoinFailureTimes, Now, Candidates);
+	TestTrue(TEXT("Low ping and busy first, a last slot after, high ping last"), Candidates == TArray<int32>({ 1, 2, 0 }));
+
+	// Session ids are what the Null subsystem would hand back for the same search result
+	JoinFailureTimes.Add(SearchResults[1].GetSessionIdStr(), Now - 1.0);
+	AShooterGameSession::RankSearchResults(SearchResults, JoinFailureTimes, Now, Candidates);
+	TestTrue(TEXT("A session that just failed to join is skipped"), Candidates == TArray<int32>({ 2, 0 }));
+
+	JoinFailureTimes.Add(SearchResults[1].GetSessionIdStr(), 0.0);
+	AShooterGameSession::RankSearchResults(SearchResults, JoinFailureTimes, Now, Candidates);
+	TestTrue(TEXT("A session that failed to join long ago is tried again"), Candidates == TArray<int32>({ 1, 2, 0 }));
+
+	AShooterGameSession::RankSearchResults(TArray<FOnlineSessionSearchResult>(), JoinFailureTimes, Now, Candidates);
+	TestEqual(TEXT("No search results, no candidates"), Candidates.Num(), 0);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
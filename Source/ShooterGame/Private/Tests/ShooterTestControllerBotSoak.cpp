@@ -0,0 +1,273 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+#include "ShooterTestControllerBotSoak.h"
+#include "ShooterGame.h"
+#include "Online/ShooterGameMode.h"
+#include "Bots/ShooterAIController.h"
+#include "Misc/FileHelper.h"
+
+void UShooterTestControllerBotSoak::OnInit()
+{
+	Super::OnInit();
+
+	NumBots = 32;
+	NumMatches = 3;
+	WarmupTime = 5;
+	RoundTime = 120;
+	TimeBetweenMatches = 5;
+	Timeout = 3600.0f;
+
+	FParse::Value(FCommandLine::Get(), TEXT("BotSoakBots="), NumBots);
+	FParse::Value(FCommandLine::Get(), TEXT("BotSoakMatches="), NumMatches);
+	FParse::Value(FCommandLine::Get(), TEXT("BotSoakWarmup="), WarmupTime);
+	FParse::Value(FCommandLine::Get(), TEXT("BotSoakRoundTime="), RoundTime);
+	FParse::Value(FCommandLine::Get(), TEXT("BotSoakTimeBetweenMatches="), TimeBetweenMatches);
+	FParse::Value(FCommandLine::Get(), TEXT("BotSoakTimeout="), Timeout);
+	FParse::Value(FCommandLine::Get(), TEXT("BotSoakCsv="), CsvFilename);
+
+	// The game mode's timer only moves on when RemainingTime counts down to 0, so 0 would never leave the state
+	WarmupTime = FMath::Max(WarmupTime, 1);
+	RoundTime = FMath::Max(RoundTime, 1);
+	TimeBetweenMatches = FMath::Max(TimeBetweenMatches, 1);
+
+	bBotsAdded = false;
+	bSoakFinished = false;
+	LastMatchState = NAME_None;
+	NumMatchesFinished = 0;
+	StartTime = FPlatformTime::Seconds();
+	WorldTickStartTime = 0.0;
+	LastTickMs = 0.0f;
+	GCStartTime = 0.0;
+	FrameGCMs = 0.0f;
+	NumGCs = 0;
+	MaxGCMs = 0.0f;
+	LastMemorySampleTime = 0.0;
+	UsedPhysical = 0;
+	PeakUsedPhysical = 0;
+	MaxFrameMs = 0.0f;
+
+	OnWorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &UShooterTestControllerBotSoak::OnWorldTickStart);
+	OnWorldPostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UShooterTestControllerBotSoak::OnWorldPostActorTick);
+	OnPreGarbageCollectHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(this, &UShooterTestControllerBotSoak::OnPreGarbageCollect);
+	OnPostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &UShooterTestControllerBotSoak::OnPostGarbageCollect);
+
+	UE_LOG(LogGauntlet, Display, TEXT("Bot soak test: %d bots, %d matches (%ds warmup, %ds rounds, %ds between matches)."), NumBots, NumMatches, WarmupTime, RoundTime, TimeBetweenMatches);
+}
+
+void UShooterTestControllerBotSoak::OnPostMapChange(UWorld* World)
+{
+	// Each match cycle travels to a new world with a new game mode, which needs its own bots
+	if (World && World->GetNetMode() == NM_DedicatedServer && World->GetAuthGameMode<AShooterGameMode>())
+	{
+		SoakWorld = World;
+		bBotsAdded = false;
+		LastMatchState = NAME_None;
+	}
+}
+
+void UShooterTestControllerBotSoak::BeginDestroy()
+{
+	RemoveDelegates();
+
+	Super::BeginDestroy();
+}
+
+void UShooterTestControllerBotSoak::OnTick(float TimeDelta)
+{
+	if (bSoakFinished)
+	{
+		return;
+	}
+
+	if (FPlatformTime::Seconds() - StartTime > Timeout)
+	{
+		UE_LOG(LogGauntlet, Error, TEXT("Failing bot soak test: only %d of %d matches finished after %.0f secs!"), NumMatchesFinished, NumMatches, Timeout);
+		FinishTest(false);
+		return;
+	}
+
+	UWorld* World = SoakWorld.Get();
+	if (World == nullptr || World->GetAuthGameMode<AShooterGameMode>() == nullptr)
+	{
+		// Traveling between matches
+		return;
+	}
+
+	if (!bBotsAdded)
+	{
+		AddBots(World);
+		bBotsAdded = true;
+	}
+
+	SampleFrame(World, TimeDelta);
+	UpdateMatch(World);
+}
+
+void UShooterTestControllerBotSoak::AddBots(UWorld* World)
+{
+	AShooterGameMode* GameMode = World->GetAuthGameMode<AShooterGameMode>();
+
+	GameMode->SetAllowBots(true, NumBots);
+	GameMode->CreateBotControllers();
+
+	// StartBots has already run if the match is in progress
+	if (GameMode->IsMatchInProgress())
+	{
+		for (FConstControllerIterator It = World->GetControllerIterator(); It; ++It)
+		{
+			AShooterAIController* AIC = Cast<AShooterAIController>(*It);
+			if (AIC && AIC->GetPawn() == nullptr)
+			{
+				GameMode->RestartPlayer(AIC);
+			}
+		}
+	}
+}
+
+void UShooterTestControllerBotSoak::UpdateMatch(UWorld* World)
+{
+	AShooterGameMode* GameMode = World->GetAuthGameMode<AShooterGameMode>();
+	AShooterGameState* MyGameState = GameMode->GetGameState<AShooterGameState>();
+	if (MyGameState == nullptr)
+	{
+		return;
+	}
+
+	const FName CurrentMatchState = GameMode->GetMatchState();
+	const bool bNewMatchState = CurrentMatchState != LastMatchState;
+	LastMatchState = CurrentMatchState;
+
+	if (CurrentMatchState == MatchState::WaitingToStart)
+	{
+		MyGameState->RemainingTime = FMath::Clamp(MyGameState->RemainingTime, 1, WarmupTime);
+	}
+	else if (CurrentMatchState == MatchState::InProgress && bNewMatchState)
+	{
+		MyGameState->RemainingTime = RoundTime;
+	}
+	else if (CurrentMatchState == MatchState::WaitingPostMatch && bNewMatchState)
+	{
+		++NumMatchesFinished;
+		UE_LOG(LogGauntlet, Display, TEXT("Bot soak test: match %d of %d finished."), NumMatchesFinished, NumMatches);
+
+		if (NumMatchesFinished >= NumMatches)
+		{
+			FinishTest(true);
+			return;
+		}
+
+		MyGameState->RemainingTime = FMath::Clamp(MyGameState->RemainingTime, 1, TimeBetweenMatches);
+	}
+}
+
+void UShooterTestControllerBotSoak::SampleFrame(UWorld* World, float TimeDelta)
+{
+	const double Now = FPlatformTime::Seconds();
+	if (Now - LastMemorySampleTime >= 1.0)
+	{
+		LastMemorySampleTime = Now;
+
+		const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+		UsedPhysical = MemoryStats.UsedPhysical;
+		PeakUsedPhysical = FMath::Max<uint64>(PeakUsedPhysical, FMath::Max<uint64>(MemoryStats.PeakUsedPhysical, MemoryStats.UsedPhysical));
+	}
+
+	int32 NumLiveBots = 0;
+	for (FConstControllerIterator It = World->GetControllerIterator(); It; ++It)
+	{
+		const AShooterAIController* AIC = Cast<AShooterAIController>(*It);
+		const AShooterCharacter* Bot = AIC ? Cast<AShooterCharacter>(AIC->GetPawn()) : nullptr;
+		if (Bot && Bot->IsAlive())
+		{
+			++NumLiveBots;
+		}
+	}
+
+	const float FrameMs = TimeDelta * 1000.0f;
+
+	// Bot think pass of the game mode tick this frame
+	const AShooterGameMode* GameMode = World->GetAuthGameMode<AShooterGameMode>();
+	const float BotThinkMs = GameMode ? GameMode->GetLastBotThinkSeconds() * 1000.0 : 0.0f;
+	const int32 NumThinkBots = GameMode ? GameMode->GetLastBotThinkBots() : 0;
+
+	CsvRows.Add(FString::Printf(TEXT("%llu,%.3f,%d,%s,%.3f,%.3f,%d,%.3f,%d,%.3f,%.1f,%.1f"),
+		(uint64)GFrameCounter, Now - StartTime, NumMatchesFinished + 1, *LastMatchState.ToString(), FrameMs, LastTickMs, NumLiveBots, BotThinkMs, NumThinkBots, FrameGCMs,
+		UsedPhysical / (1024.0 * 1024.0), PeakUsedPhysical / (1024.0 * 1024.0)));
+
+	TickTimesMs.Add(LastTickMs);
+	MaxFrameMs = FMath::Max(MaxFrameMs, FrameMs);
+	FrameGCMs = 0.0f;
+}
+
+void UShooterTestControllerBotSoak::OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World == SoakWorld.Get())
+	{
+		WorldTickStartTime = FPlatformTime::Seconds();
+	}
+}
+
+void UShooterTestControllerBotSoak::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World == SoakWorld.Get())
+	{
+		LastTickMs = (FPlatformTime::Seconds() - WorldTickStartTime) * 1000.0;
+	}
+}
+
+void UShooterTestControllerBotSoak::OnPreGarbageCollect()
+{
+	GCStartTime = FPlatformTime::Seconds();
+}
+
+void UShooterTestControllerBotSoak::OnPostGarbageCollect()
+{
+	const float GCMs = (FPlatformTime::Seconds() - GCStartTime) * 1000.0;
+	FrameGCMs += GCMs;
+	MaxGCMs = FMath::Max(MaxGCMs, GCMs);
+	++NumGCs;
+}
+
+void UShooterTestControllerBotSoak::RemoveDelegates()
+{
+	FWorldDelegates::OnWorldTickStart.Remove(OnWorldTickStartHandle);
+	FWorldDelegates::OnWorldPostActorTick.Remove(OnWorldPostActorTickHandle);
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(OnPreGarbageCollectHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(OnPostGarbageCollectHandle);
+}
+
+void UShooterTestControllerBotSoak::FinishTest(bool bSuccess)
+{
+	bSoakFinished = true;
+	RemoveDelegates();
+
+	if (CsvFilename.IsEmpty())
+	{
+		CsvFilename = FPaths::ProfilingDir() / TEXT("BotSoak") / FString::Printf(TEXT("BotSoak-%s.csv"), *FDateTime::Now().ToString());
+	}
+
+	CsvRows.Insert(TEXT("Frame,Time,Match,MatchState,FrameMs,TickMs,Bots,BotThinkMs,ThinkBots,GCMs,UsedPhysicalMB,PeakUsedPhysicalMB"), 0);
+
+	const bool bSaved = FFileHelper::SaveStringArrayToFile(CsvRows, *CsvFilename);
+	if (!bSaved)
+	{
+		UE_LOG(LogGauntlet, Error, TEXT("Failed to write bot soak report to %s"), *CsvFilename);
+	}
+
+	const int32 NumFrames = TickTimesMs.Num();
+	if (NumFrames > 0)
+	{
+		TickTimesMs.Sort();
+
+		float TotalMs = 0.0f;
+		for (float Ms : TickTimesMs)
+		{
+			TotalMs += Ms;
+		}
+
+		UE_LOG(LogGauntlet, Display, TEXT("Bot soak: %d matches, %d frames, tick avg %.3fms p95 %.3fms max %.3fms, max frame %.3fms, %d GCs (max %.3fms), peak memory %.1fMB. Report: %s"),
+			NumMatchesFinished, NumFrames, TotalMs / NumFrames, TickTimesMs[FMath::Min(NumFrames - 1, (int32)(NumFrames * 0.95f))], TickTimesMs.Last(),
+			MaxFrameMs, NumGCs, MaxGCMs, PeakUsedPhysical / (1024.0 * 1024.0), *CsvFilename);
+	}
+
+	EndTest(bSuccess && bSaved && NumFrames > 0 ? 0 : -1);
+}
@@ -0,0 +1,427 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+#include "ShooterTestControllerReplicationGraphLoad.h"
+#include "ShooterGame.h"
+#include "Online/ShooterGameMode.h"
+#include "Online/ShooterReplicationGraph.h"
+#include "Weapons/ShooterProjectile.h"
+#include "Bots/ShooterAIController.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "GameFramework/PlayerStart.h"
+#include "Misc/FileHelper.h"
+#include "EngineUtils.h"
+
+void UShooterTestControllerReplicationGraphLoad::OnInit()
+{
+	Super::OnInit();
+
+	NumConnections = 32;
+	NumBots = 16;
+	NumProjectiles = 32;
+	WarmupTime = 5.0f;
+	Duration = 60.0f;
+	ViewerSpeed = 600.0f;
+
+	FParse::Value(FCommandLine::Get(), TEXT("RepGraphLoadConnections="), NumConnections);
+	FParse::Value(FCommandLine::Get(), TEXT("RepGraphLoadBots="), NumBots);
+	FParse::Value(FCommandLine::Get(), TEXT("RepGraphLoadProjectiles="), NumProjectiles);
+	FParse::Value(FCommandLine::Get(), TEXT("RepGraphLoadWarmup="), WarmupTime);
+	FParse::Value(FCommandLine::Get(), TEXT("RepGraphLoadDuration="), Duration);
+	FParse::Value(FCommandLine::Get(), TEXT("RepGraphLoadViewerSpeed="), ViewerSpeed);
+	FParse::Value(FCommandLine::Get(), TEXT("RepGraphLoadCsv="), CsvFilename);
+
+	ProjectileClass = nullptr;
+	PatrolLength = 0.0f;
+	MapLoadTime = FPlatformTime::Seconds();
+	bLoadStarted = false;
+	bLoadFinished = false;
+	LoadStartTime = 0.0;
+	LastSampledFrame = 0;
+	TotalActorsReplicated = 0;
+	TotalBytesSent = 0;
+	WorldTickStartTime = 0.0;
+	LastActorTickMs = 0.0f;
+	TotalActorTickMs = 0.0;
+}
+
+void UShooterTestControllerReplicationGraphLoad::OnPostMapChange(UWorld* World)
+{
+	if (bLoadStarted)
+	{
+		UE_LOG(LogGauntlet, Error, TEXT("Map changed during the replication graph load test!"));
+		EndTest(-1);
+		return;
+	}
+
+	if (World && World->GetNetMode() == NM_DedicatedServer && World->GetAuthGameMode<AShooterGameMode>())
+	{
+		LoadWorld = World;
+		MapLoadTime = FPlatformTime::Seconds();
+	}
+}
+
+void UShooterTestControllerReplicationGraphLoad::OnTick(float TimeDelta)
+{
+	if (bLoadFinished)
+	{
+		return;
+	}
+
+	UWorld* World = LoadWorld.Get();
+
+	if (!bLoadStarted)
+	{
+		AShooterGameMode* GameMode = World ? World->GetAuthGameMode<AShooterGameMode>() : nullptr;
+		if (GameMode == nullptr || !GameMode->IsMatchInProgress())
+		{
+			if (FPlatformTime::Seconds() - MapLoadTime > 300.0)
+			{
+				UE_LOG(LogGauntlet, Error, TEXT("Failing replication graph load test: no match in progress on a dedicated server after 300 secs!"));
+				EndTest(-1);
+			}
+			return;
+		}
+
+		UNetDriver* NetDriver = World->GetNetDriver();
+		UShooterReplicationGraph* Graph = NetDriver ? NetDriver->GetReplicationDriver<UShooterReplicationGraph>() : nullptr;
+		if (Graph == nullptr)
+		{
+			UE_LOG(LogGauntlet, Error, TEXT("Failing replication graph load test: the net driver is not using UShooterReplicationGraph! Set ReplicationDriverClassName for %s (e.g. -ini:Engine:[/Script/OnlineSubsystemUtils.IpNetDriver]:ReplicationDriverClassName=/Script/ShooterGame.ShooterReplicationGraph)."), NetDriver ? *NetDriver->GetClass()->GetPathName() : TEXT("the game net driver"));
+			EndTest(-1);
+			return;
+		}
+
+		FString ProjectileClassName = TEXT("/Game/Blueprints/Weapons/ProjRocket.ProjRocket_C");
+		FParse::Value(FCommandLine::Get(), TEXT("RepGraphLoadProjectileClass="), ProjectileClassName);
+		ProjectileClass = LoadClass<AShooterProjectile>(nullptr, *ProjectileClassName);
+		if (ProjectileClass == nullptr && NumProjectiles > 0)
+		{
+			UE_LOG(LogGauntlet, Warning, TEXT("Could not load projectile class %s, no projectiles will be spawned."), *ProjectileClassName);
+		}
+
+		// Viewers patrol a closed loop through the player starts, so they sweep the whole playable area
+		PatrolPoints.Reset();
+		for (APlayerStart* PlayerStart : TActorRange<APlayerStart>(World))
+		{
+			PatrolPoints.Add(PlayerStart->GetActorLocation() + FVector(0.0f, 0.0f, 64.0f));
+		}
+
+		if (PatrolPoints.Num() < 2)
+		{
+			const FVector Center = PatrolPoints.Num() > 0 ? PatrolPoints[0] : FVector::ZeroVector;
+			PatrolPoints.Reset();
+			for (int32 i = 0; i < 8; ++i)
+			{
+				PatrolPoints.Add(Center + FRotator(0.0f, i * 45.0f, 0.0f).Vector() * 2000.0f);
+			}
+		}
+
+		PatrolLength = 0.0f;
+		for (int32 i = 0; i < PatrolPoints.Num(); ++i)
+		{
+			PatrolLength += FVector::Dist(PatrolPoints[i], PatrolPoints[(i + 1) % PatrolPoints.Num()]);
+		}
+
+		CreateSimulatedConnections(World);
+		SpawnBots(World);
+
+		UE_LOG(LogGauntlet, Display, TEXT("Replication graph load test started: %d connections, %d bots, %d projectiles, %.0fs warmup, %.0fs duration."), SimulatedConnections.Num(), NumBots, NumProjectiles, WarmupTime, Duration);
+
+		OnWorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &UShooterTestControllerReplicationGraphLoad::OnWorldTickStart);
+		OnWorldPostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UShooterTestControllerReplicationGraphLoad::OnWorldPostActorTick);
+
+		bLoadStarted = true;
+		LoadStartTime = FPlatformTime::Seconds();
+		LastSampledFrame = Graph->GetReplicationGraphFrame();
+		return;
+	}
+
+	if (World == nullptr)
+	{
+		UE_LOG(LogGauntlet, Error, TEXT("Lost the world during the replication graph load test!"));
+		EndTest(-1);
+		return;
+	}
+
+	SampleReplicationFrame(World);
+	UpdateViewers(TimeDelta);
+	UpdateProjectiles(World);
+
+	if (FPlatformTime::Seconds() - LoadStartTime >= WarmupTime + Duration)
+	{
+		FinishTest();
+	}
+}
+
+void UShooterTestControllerReplicationGraphLoad::CreateSimulatedConnections(UWorld* World)
+{
+	UNetDriver* NetDriver = World->GetNetDriver();
+	AShooterGameMode* GameMode = World->GetAuthGameMode<AShooterGameMode>();
+
+	for (int32 i = 0; i < NumConnections; ++i)
+	{
+		// Simulated connections absorb all traffic and ack every packet, so no socket or client is needed
+		USimulatedClientNetConnection* Connection = NewObject<USimulatedClientNetConnection>();
+		Connection->InitConnection(NetDriver, USOCK_Open, World->URL, 1000000);
+		Connection->InitSendBuffer();
+		Connection->SetClientWorldPackageName(World->GetOutermost()->GetFName());
+		Connection->SetClientLoginState(EClientLoginState::Welcomed);
+		NetDriver->AddClientConnection(Connection);
+
+		FActorSpawnParameters SpawnInfo;
+		SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		APlayerController* PC = World->SpawnActor<APlayerController>(GameMode->PlayerControllerClass, SpawnInfo);
+		if (PC == nullptr)
+		{
+			UE_LOG(LogGauntlet, Warning, TEXT("Failed to spawn a player controller for simulated connection %d."), i);
+			continue;
+		}
+
+		PC->SetRole(ROLE_Authority);
+		PC->SetReplicates(true);
+		PC->SetAutonomousProxy(true);
+		PC->SetPlayer(Connection);
+
+		// Spectating server side controllers use the last synced spectator location as their view point
+		PC->ChangeState(NAME_Spectating);
+
+		SimulatedConnections.Add(Connection);
+		SimulatedControllers.Add(PC);
+		ViewerDistances.Add(PatrolLength * i / FMath::Max(NumConnections, 1));
+		LastOutTotalBytes.Add(Connection->OutTotalBytes);
+	}
+
+	UpdateViewers(0.0f);
+}
+
+void UShooterTestControllerReplicationGraphLoad::SpawnBots(UWorld* World)
+{
+	AShooterGameMode* GameMode = World->GetAuthGameMode<AShooterGameMode>();
+
+	int32 ExistingBots = 0;
+	for (FConstControllerIterator It = World->GetControllerIterator(); It; ++It)
+	{
+		if (Cast<AShooterAIController>(*It))
+		{
+			++ExistingBots;
+		}
+	}
+
+	for (int32 i = 0; i < NumBots; ++i)
+	{
+		if (AShooterAIController* AIC = GameMode->CreateBot(ExistingBots + i))
+		{
+			GameMode->RestartPlayer(AIC);
+		}
+	}
+}
+
+FVector UShooterTestControllerReplicationGraphLoad::GetPatrolLocation(float Distance) const
+{
+	if (PatrolLength <= 0.0f)
+	{
+		return PatrolPoints.Num() > 0 ? PatrolPoints[0] : FVector::ZeroVector;
+	}
+
+	Distance = FMath::Fmod(Distance, PatrolLength);
+	for (int32 i = 0; i < PatrolPoints.Num(); ++i)
+	{
+		const FVector& Start = PatrolPoints[i];
+		const FVector& End = PatrolPoints[(i + 1) % PatrolPoints.Num()];
+		const float SegmentLength = FVector::Dist(Start, End);
+		if (Distance <= SegmentLength && SegmentLength > 0.0f)
+		{
+			return FMath::Lerp(Start, End, Distance / SegmentLength);
+		}
+		Distance -= SegmentLength;
+	}
+
+	return PatrolPoints[0];
+}
+
+void UShooterTestControllerReplicationGraphLoad::UpdateViewers(float TimeDelta)
+{
+	for (int32 i = 0; i < SimulatedControllers.Num(); ++i)
+	{
+		APlayerController* PC = SimulatedControllers[i];
+		if (PC == nullptr || PC->IsPendingKill())
+		{
+			continue;
+		}
+
+		ViewerDistances[i] += ViewerSpeed * TimeDelta;
+
+		const FVector Location = GetPatrolLocation(ViewerDistances[i]);
+		const FVector LookAt = GetPatrolLocation(ViewerDistances[i] + 100.0f);
+		const FRotator Rotation = (LookAt - Location).Rotation();
+
+		PC->SetActorLocation(Location);
+		PC->SetControlRotation(Rotation);
+		PC->LastSpectatorSyncLocation = Location;
+		PC->LastSpectatorSyncRotation = Rotation;
+	}
+}
+
+void UShooterTestControllerReplicationGraphLoad::UpdateProjectiles(UWorld* World)
+{
+	if (ProjectileClass == nullptr || NumProjectiles <= 0)
+	{
+		return;
+	}
+
+	int32 NumLive = 0;
+	for (AShooterProjectile* Projectile : TActorRange<AShooterProjectile>(World))
+	{
+		if (!Projectile->HasExploded())
+		{
+			++NumLive;
+		}
+	}
+
+	FActorSpawnParameters SpawnInfo;
+	SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	for (; NumLive < NumProjectiles; ++NumLive)
+	{
+		const FVector Origin = PatrolPoints[FMath::RandHelper(PatrolPoints.Num())];
+		FVector ShootDir = FRotator(FMath::FRandRange(-10.0f, 10.0f), FMath::FRandRange(0.0f, 360.0f), 0.0f).Vector();
+
+		AShooterProjectile* Projectile = World->SpawnActor<AShooterProjectile>(ProjectileClass, Origin, ShootDir.Rotation(), SpawnInfo);
+		if (Projectile)
+		{
+			Projectile->InitVelocity(ShootDir);
+		}
+	}
+}
+
+void UShooterTestControllerReplicationGraphLoad::SampleReplicationFrame(UWorld* World)
+{
+	UNetDriver* NetDriver = World->GetNetDriver();
+	UShooterReplicationGraph* Graph = NetDriver ? NetDriver->GetReplicationDriver<UShooterReplicationGraph>() : nullptr;
+	if (Graph == nullptr)
+	{
+		return;
+	}
+
+	const uint32 FrameNum = Graph->GetReplicationGraphFrame();
+	if (FrameNum == LastSampledFrame)
+	{
+		return;
+	}
+	LastSampledFrame = FrameNum;
+
+	int32 FrameActors = 0;
+	int32 MaxActors = 0;
+	int32 FrameBytes = 0;
+	int32 MaxBytes = 0;
+
+	for (int32 i = 0; i < SimulatedConnections.Num(); ++i)
+	{
+		UNetConnection* Connection = SimulatedConnections[i];
+
+		// Actors whose last replication was this frame
+		int32 NumActors = 0;
+		if (UNetReplicationGraphConnection* ConnectionManager = Cast<UNetReplicationGraphConnection>(Connection->GetReplicationConnectionDriver()))
+		{
+			for (auto It = ConnectionManager->ActorInfoMap.CreateIterator(); It; ++It)
+			{
+				if (It.Value()->LastRepFrameNum == FrameNum)
+				{
+					++NumActors;
+				}
+			}
+		}
+
+		// Simulated connections drop the packets, but still count what would have been sent
+		const int32 NumBytes = Connection->OutTotalBytes - LastOutTotalBytes[i];
+		LastOutTotalBytes[i] = Connection->OutTotalBytes;
+
+		FrameActors += NumActors;
+		MaxActors = FMath::Max(MaxActors, NumActors);
+		FrameBytes += NumBytes;
+		MaxBytes = FMath::Max(MaxBytes, NumBytes);
+	}
+
+	const double Elapsed = FPlatformTime::Seconds() - LoadStartTime;
+	if (Elapsed < WarmupTime)
+	{
+		return;
+	}
+
+	const int32 NumConnectionsSampled = FMath::Max(SimulatedConnections.Num(), 1);
+	const float ReplicateMs = Graph->LastServerReplicateActorsSeconds * 1000.0;
+	const float PrepareMs = Graph->LastPrepareConnectionsSeconds * 1000.0;
+
+	static IConsoleVariable* ParallelGatherCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("ShooterRepGraph.ParallelGather"));
+	const int32 ParallelGather = ParallelGatherCVar ? ParallelGatherCVar->GetInt() : 0;
+
+	CsvRows.Add(FString::Printf(TEXT("%u,%.3f,%.3f,%.3f,%d,%.3f,%d,%d,%d,%.2f,%d,%.1f,%d,%d"),
+		FrameNum, Elapsed - WarmupTime, ReplicateMs, LastActorTickMs, ParallelGather, PrepareMs, SimulatedConnections.Num(), Graph->CharacterActors.Num(), Graph->ProjectileActors.Num(),
+		(float)FrameActors / NumConnectionsSampled, MaxActors, (float)FrameBytes / NumConnectionsSampled, MaxBytes, FrameBytes));
+
+	ReplicateTimesMs.Add(ReplicateMs);
+	TotalActorTickMs += LastActorTickMs;
+	TotalActorsReplicated += FrameActors;
+	TotalBytesSent += FrameBytes;
+}
+
+void UShooterTestControllerReplicationGraphLoad::OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World == LoadWorld.Get())
+	{
+		WorldTickStartTime = FPlatformTime::Seconds();
+	}
+}
+
+void UShooterTestControllerReplicationGraphLoad::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World == LoadWorld.Get())
+	{
+		LastActorTickMs = (FPlatformTime::Seconds() - WorldTickStartTime) * 1000.0;
+	}
+}
+
+void UShooterTestControllerReplicationGraphLoad::FinishTest()
+{
+	bLoadFinished = true;
+
+	FWorldDelegates::OnWorldTickStart.Remove(OnWorldTickStartHandle);
+	FWorldDelegates::OnWorldPostActorTick.Remove(OnWorldPostActorTickHandle);
+
+	if (CsvFilename.IsEmpty())
+	{
+		CsvFilename = FPaths::ProfilingDir() / TEXT("RepGraphLoad") / FString::Printf(TEXT("RepGraphLoad-%s.csv"), *FDateTime::Now().ToString());
+	}
+
+	CsvRows.Insert(TEXT("Frame,Time,ReplicateMs,ActorTickMs,ParallelGather,PrepareMs,Connections,Characters,Projectiles,AvgActorsPerConnection,MaxActorsPerConnection,AvgBytesPerConnection,MaxBytesPerConnection,TotalBytes"), 0);
+
+	const bool bSaved = FFileHelper::SaveStringArrayToFile(CsvRows, *CsvFilename);
+	if (!bSaved)
+	{
+		UE_LOG(LogGauntlet, Error, TEXT("Failed to write replication graph load report to %s"), *CsvFilename);
+	}
+
+	const int32 NumFrames = ReplicateTimesMs.Num();
+	if (NumFrames > 0)
+	{
+		ReplicateTimesMs.Sort();
+
+		float TotalMs = 0.0f;
+		for (float Ms : ReplicateTimesMs)
+		{
+			TotalMs += Ms;
+		}
+
+		const int32 NumConnectionsSampled = FMath::Max(SimulatedConnections.Num(), 1);
+		UE_LOG(LogGauntlet, Display, TEXT("Replication graph load: %d frames, ServerReplicateActors avg %.3fms p95 %.3fms max %.3fms, actor tick avg %.3fms, %.2f actors and %.1f bytes per connection per frame. Report: %s"),
+			NumFrames, TotalMs / NumFrames, ReplicateTimesMs[FMath::Min(NumFrames - 1, (int32)(NumFrames * 0.95f))], ReplicateTimesMs.Last(), TotalActorTickMs / NumFrames,
+			(double)TotalActorsReplicated / NumFrames / NumConnectionsSampled, (double)TotalBytesSent / NumFrames / NumConnectionsSampled, *CsvFilename);
+	}
+	else
+	{
+		UE_LOG(LogGauntlet, Error, TEXT("Replication graph load test recorded no replication frames!"));
+	}
+
+	EndTest(bSaved && NumFrames > 0 ? 0 : -1);
+}
@@ -10,6 +10,7 @@
 #include "SlateExtras.h"
 #include "GenericPlatformChunkInstall.h"
 #include "Online/ShooterOnlineGameSettings.h"
+#include "Online/ShooterGameSession.h"
 #include "OnlineSubsystemSessionSettings.h"
 #include "SShooterConfirmationDialog.h"
 #include "ShooterMenuItemWidgetStyle.h"
@@ -91,8 +92,6 @@ void FShooterMainMenu::Construct(TWeakObjectPtr<UShooterGameInstance> _GameInsta
 	GameInstance = _GameInstance;
 	PlayerOwner = _PlayerOwner;
 
-	OnCancelMatchmakingCompleteDelegate = FOnCancelMatchmakingCompleteDelegate::CreateSP(this, &FShooterMainMenu::OnCancelMatchmakingComplete);
-	
 	// read user settings
 #if SHOOTER_CONSOLE_UI
 	bIsLanMatch = FParse::Param(FCommandLine::Get(), TEXT("forcelan"));
@@ -355,6 +354,10 @@ void FShooterMainMenu::Construct(TWeakObjectPtr<UShooterGameInstance> _GameInsta
 		MenuHelper::AddMenuItemSP(RootMenuItem, LOCTEXT("Leaderboards", "LEADERBOARDS"), this, &FShooterMainMenu::OnShowLeaderboard);
 		MenuHelper::AddCustomMenuItem(LeaderboardItem,SAssignNew(LeaderboardWidget,SShooterLeaderboard).OwnerWidget(MenuWidget).PlayerOwner(GetPlayerOwner()));
 
+		// Match history
+		MenuHelper::AddMenuItemSP(RootMenuItem, LOCTEXT("MatchHistory", "MATCH HISTORY"), this, &FShooterMainMenu::OnShowMatchHistory);
+		MenuHelper::AddCustomMenuItem(MatchHistoryItem,SAssignNew(MatchHistoryWidget,SShooterMatchHistory).OwnerWidget(MenuWidget).PlayerOwner(GetPlayerOwner()));
+
 #if ONLINE_STORE_ENABLED
 		// Purchases
 		MenuHelper::AddMenuItemSP(RootMenuItem, LOCTEXT("Store", "ONLINE STORE"), this, &FShooterMainMenu::OnShowOnlineStore);
@@ -586,10 +589,10 @@ FReply FShooterMainMenu::OnConfirmGeneric()
 
 void FShooterMainMenu::BeginQuickMatchSearch()
 {
-	IOnlineSessionPtr Sessions = Online::GetSessionInterface(GetTickableGameObjectWorld());
-	if(!Sessions.IsValid())
+	AShooterGameSession* const GameSession = GameInstance.IsValid() ? GameInstance->GetGameSession() : nullptr;
+	if (GameSession == nullptr)
 	{
-		UE_LOG(LogOnline, Warning, TEXT("Quick match is not supported: couldn't find online session interface."));
+		UE_LOG(LogOnline, Warning, TEXT("Quick match is not supported: couldn't find game session."));
 		return;
 	}
 
@@ -599,42 +602,42 @@ void FShooterMainMenu::BeginQuickMatchSearch()
 		return;
 	}
 
-	QuickMatchSearchSettings = MakeShared<FShooterOnlineSearchSettings>(false, true);
-	QuickMatchSearchSettings->QuerySettings.Set(SEARCH_MATCHMAKING_QUEUE, FString("TeamDeathmatch"), EOnlineComparisonOp::Equals);
-	QuickMatchSearchSettings->QuerySettings.Set(SEARCH_XBOX_LIVE_HOPPER_NAME, FString("TeamDeathmatch"), EOnlineComparisonOp::Equals);
-	QuickMatchSearchSettings->QuerySettings.Set(SEARCH_XBOX_LIVE_SESSION_TEMPLATE_NAME, FString("MatchSession"), EOnlineComparisonOp::Equals);
-	QuickMatchSearchSettings->TimeoutInSeconds = 120.0f;
+	DisplayQuickmatchSearchingUI();
 
-	FShooterOnlineSessionSettings SessionSettings(false, true, 8);
-	SessionSettings.Set(SETTING_GAMEMODE, FString("TDM"), EOnlineDataAdvertisementType::ViaOnlineService);
-	SessionSettings.Set(SETTING_MATCHING_HOPPER, FString("TeamDeathmatch"), EOnlineDataAdvertisementType::DontAdvertise);
-	SessionSettings.Set(SETTING_MATCHING_TIMEOUT, 120.0f, EOnlineDataAdvertisementType::ViaOnlineService);
-	SessionSettings.Set(SETTING_SESSION_TEMPLATE_NAME, FString("GameSession"), EOnlineDataAdvertisementType::DontAdvertise);
+	// Search, then let the game session's matchmaking join the best session it found
+	GameSession->OnFindSessionsComplete().RemoveAll(this);
+	OnQuickMatchFindSessionsCompleteDelegateHandle = GameSession->OnFindSessionsComplete().AddSP(this, &FShooterMainMenu::OnQuickMatchFindSessionsComplete);
+	GameSession->FindSessions(GetPlayerOwner()->GetPreferredUniqueNetId().GetUniqueNetId(), NAME_GameSession, false, true);
+}
 
-	TSharedRef<FOnlineSessionSearch> QuickMatchSearchSettingsRef = QuickMatchSearchSettings.ToSharedRef();
-	
-	DisplayQuickmatchSearchingUI();
+void FShooterMainMenu::OnQuickMatchFindSessionsComplete(bool bWasSuccessful)
+{
+	AShooterGameSession* const GameSession = GameInstance.IsValid() ? GameInstance->GetGameSession() : nullptr;
+	if (GameSession == nullptr)
+	{
+		return;
+	}
+	GameSession->OnFindSessionsComplete().Remove(OnQuickMatchFindSessionsCompleteDelegateHandle);
 
-	// Perform matchmaking with all local players
-	TArray<FSessionMatchmakingUser> LocalPlayers;
-	for (auto It = GameInstance->GetLocalPlayerIterator(); It; ++It)
+	if (bQuickmatchSearchRequestCanceled && bUsedInputToCancelQuickmatchSearch)
 	{
-		FUniqueNetIdRepl PlayerId = (*It)->GetPreferredUniqueNetId();
-		if (PlayerId.IsValid())
-		{
-			FSessionMatchmakingUser LocalPlayer = {(*PlayerId).AsShared()};
-			LocalPlayers.Emplace(LocalPlayer);
-		}
+		bQuickmatchSearchRequestCanceled = false;
+		OnQuickMatchCanceled();
+		return;
 	}
 
-	FOnStartMatchmakingComplete CompletionDelegate;
-	CompletionDelegate.BindSP(this, &FShooterMainMenu::OnMatchmakingComplete);
-	if (!Sessions->StartMatchmaking(LocalPlayers, NAME_GameSession, SessionSettings, QuickMatchSearchSettingsRef, CompletionDelegate))
+	if (!bWasSuccessful)
 	{
-		OnMatchmakingComplete(NAME_GameSession, FOnlineError(false), FSessionMatchmakingResults());
+		// The search itself failed, so we don't know there is nothing to join: show the failure UI rather than hosting
+		UE_LOG(LogOnline, Warning, TEXT("Quick match session search failed."));
+		OnQuickMatchComplete(EOnJoinSessionCompleteResult::UnknownError);
+		return;
 	}
-}
 
+	GameSession->OnJoinSessionComplete().RemoveAll(this);
+	OnQuickMatchJoinSessionCompleteDelegateHandle = GameSession->OnJoinSessionComplete().AddSP(this, &FShooterMainMenu::OnQuickMatchComplete);
+	GameSession->StartMatchmaking();
+}
 
 void FShooterMainMenu::OnSplitScreenSelectedHostOnlineLoginRequired()
 {
@@ -875,19 +878,13 @@ void FShooterMainMenu::SplitScreenBackedOut()
 
 void FShooterMainMenu::HelperQuickMatchSearchingUICancel(bool bShouldRemoveSession)
 {
-	IOnlineSessionPtr Sessions = Online::GetSessionInterface(GetTickableGameObjectWorld());
-	if (bShouldRemoveSession && Sessions.IsValid())
+	if (bShouldRemoveSession)
 	{
-		if (PlayerOwner.IsValid() && PlayerOwner->GetPreferredUniqueNetId().IsValid())
-		{
-			UGameViewportClient* const GVC = GEngine->GameViewport;
-			GVC->RemoveViewportWidgetContent(QuickMatchSearchingWidgetContainer.ToSharedRef());
-			GVC->AddViewportWidgetContent(QuickMatchStoppingWidgetContainer.ToSharedRef());
-			FSlateApplication::Get().SetKeyboardFocus(QuickMatchStoppingWidgetContainer);
-			
-			OnCancelMatchmakingCompleteDelegateHandle = Sessions->AddOnCancelMatchmakingCompleteDelegate_Handle(OnCancelMatchmakingCompleteDelegate);
-			Sessions->CancelMatchmaking(*PlayerOwner->GetPreferredUniqueNetId(), NAME_GameSession);
-		}
+		// The search or join in flight finishes first, then OnQuickMatchCanceled takes the stopping UI down
+		UGameViewportClient* const GVC = GEngine->GameViewport;
+		GVC->RemoveViewportWidgetContent(QuickMatchSearchingWidgetContainer.ToSharedRef());
+		GVC->AddViewportWidgetContent(QuickMatchStoppingWidgetContainer.ToSharedRef());
+		FSlateApplication::Get().SetKeyboardFocus(QuickMatchStoppingWidgetContainer);
 	}
 	else
 	{
@@ -934,27 +931,28 @@ void FShooterMainMenu::DisplayQuickmatchSearchingUI()
 	bAnimateQuickmatchSearchingUI = true;
 }
 
-void FShooterMainMenu::OnMatchmakingComplete(FName SessionName, const FOnlineError& ErrorDetails, const FSessionMatchmakingResults& Results)
+void FShooterMainMenu::OnQuickMatchComplete(EOnJoinSessionCompleteResult::Type Result)
 {
-	const bool bWasSuccessful = ErrorDetails.WasSuccessful();
-	IOnlineSessionPtr SessionInterface = Online::GetSessionInterface(GetTickableGameObjectWorld());
-	if (!SessionInterface.IsValid())
+	AShooterGameSession* const GameSession = GameInstance.IsValid() ? GameInstance->GetGameSession() : nullptr;
+	if (GameSession)
 	{
-		UE_LOG(LogOnline, Warning, TEXT("OnMatchmakingComplete: Couldn't find session interface."));
-		return;
+		GameSession->OnJoinSessionComplete().Remove(OnQuickMatchJoinSessionCompleteDelegateHandle);
 	}
 
+	const bool bWasSuccessful = Result == EOnJoinSessionCompleteResult::Success;
 	if (bQuickmatchSearchRequestCanceled && bUsedInputToCancelQuickmatchSearch)
 	{
 		bQuickmatchSearchRequestCanceled = false;
 		// Clean up the session in case we get this event after canceling
 		if (bWasSuccessful)
 		{
-			if (PlayerOwner.IsValid() && PlayerOwner->GetPreferredUniqueNetId().IsValid())
+			IOnlineSessionPtr SessionInterface = Online::GetSessionInterface(GetTickableGameObjectWorld());
+			if (SessionInterface.IsValid())
 			{
 				SessionInterface->DestroySession(NAME_GameSession);
 			}
 		}
+		OnQuickMatchCanceled();
 		return;
 	}
 
@@ -969,58 +967,38 @@ void FShooterMainMenu::OnMatchmakingComplete(FName SessionName, const FOnlineErr
 		return;
 	}
 
-	if (!bWasSuccessful)
+	if (GetPlayerOwner() == NULL || !ensure(GameInstance.IsValid()))
 	{
-		UE_LOG(LogOnline, Warning, TEXT("Matchmaking was unsuccessful."));
-		DisplayQuickmatchFailureUI();
+		UE_LOG(LogOnline, Warning, TEXT("OnQuickMatchComplete: No owner."));
 		return;
 	}
 
-	UE_LOG(LogOnline, Log, TEXT("Matchmaking successful! Session name is %s."), *SessionName.ToString());
-
-	if (GetPlayerOwner() == NULL)
+	if (bWasSuccessful)
 	{
-		UE_LOG(LogOnline, Warning, TEXT("OnMatchmakingComplete: No owner."));
-		return;
-	}
+		UE_LOG(LogOnline, Log, TEXT("Quick match joined a session."));
 
-	FNamedOnlineSession* MatchmadeSession = SessionInterface->GetNamedSession(SessionName);
-
-	if (!MatchmadeSession)
-	{
-		UE_LOG(LogOnline, Warning, TEXT("OnMatchmakingComplete: No session."));
+		MenuWidget->LockControls(true);
+		GameInstance->TravelToSession(NAME_GameSession);
 		return;
 	}
 
-	if(!MatchmadeSession->OwningUserId.IsValid())
+	// Only host when matchmaking went through every search result without a join (see AShooterGameSession::OnNoMatchesAvailable).
+	// Anything else is a failure we can't fix by hosting.
+	if (Result != EOnJoinSessionCompleteResult::SessionDoesNotExist)
 	{
-		UE_LOG(LogOnline, Warning, TEXT("OnMatchmakingComplete: No session owner/host."));
+		UE_LOG(LogOnline, Warning, TEXT("Quick match failed (%s)."), LexToString(Result));
+		DisplayQuickmatchFailureUI();
 		return;
 	}
 
-	if (GEngine && GEngine->GameViewport)
-	{
-		GEngine->GameViewport->RemoveViewportWidgetContent(QuickMatchSearchingWidgetContainer.ToSharedRef());
-	}
-	bAnimateQuickmatchSearchingUI = false;
-
-	UE_LOG(LogOnline, Log, TEXT("OnMatchmakingComplete: Session host is %d."), *MatchmadeSession->OwningUserId->ToString());
-
-	if (ensure(GameInstance.IsValid()))
+	// Nothing to join, host one for the next players looking for a match
+	UE_LOG(LogOnline, Log, TEXT("Quick match found no session to join, hosting one."));
+	MenuWidget->LockControls(true);
+	if (!GameInstance->HostGame(GetPlayerOwner(), TEXT("TDM"), UShooterGameInstance::GetQuickMatchUrl()))
 	{
-		MenuWidget->LockControls(true);
-
-		IOnlineSubsystem* Subsystem = Online::GetSubsystem(GetTickableGameObjectWorld());
-		if (Subsystem != nullptr && Subsystem->IsLocalPlayer(*MatchmadeSession->OwningUserId))
-		{
-			// This console is the host, start the map.
-			GameInstance->BeginHostingQuickMatch();
-		}
-		else
-		{
-			// We are the client, join the host.
-			GameInstance->TravelToSession(SessionName);
-		}
+		UE_LOG(LogOnline, Warning, TEXT("Quick match failed to host a session."));
+		MenuWidget->LockControls(false);
+		DisplayQuickmatchFailureUI();
 	}
 }
 
@@ -1363,6 +1341,13 @@ void FShooterMainMenu::OnShowLeaderboard()
 	MenuWidget->EnterSubMenu();
 }
 
+void FShooterMainMenu::OnShowMatchHistory()
+{
+	MenuWidget->NextMenu = MatchHistoryItem->SubMenu;
+	MatchHistoryWidget->ReadMatchHistory();
+	MenuWidget->EnterSubMenu();
+}
+
 void FShooterMainMenu::OnShowOnlineStore()
 {
 	MenuWidget->NextMenu = OnlineStoreItem->SubMenu;
@@ -1466,14 +1451,9 @@ FString FShooterMainMenu::GetMapName() const
 	return MapNames[(int)GetSelectedMap()];
 }
 
-void FShooterMainMenu::OnCancelMatchmakingComplete(FName SessionName, bool bWasSuccessful)
+void FShooterMainMenu::OnQuickMatchCanceled()
 {
-	IOnlineSessionPtr Sessions = Online::GetSessionInterface(GetTickableGameObjectWorld());
-	if (Sessions.IsValid())
-	{
-		Sessions->ClearOnCancelMatchmakingCompleteDelegate_Handle(OnCancelMatchmakingCompleteDelegateHandle);
-	}
-
+	bUsedInputToCancelQuickmatchSearch = false;
 	bAnimateQuickmatchSearchingUI = false;
 	UGameViewportClient* const GVC = GEngine->GameViewport;
 	GVC->RemoveViewportWidgetContent(QuickMatchStoppingWidgetContainer.ToSharedRef());
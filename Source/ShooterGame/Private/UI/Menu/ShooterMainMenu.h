@@ -7,6 +7,7 @@
 #include "Widgets/SShooterServerList.h"
 #include "Widgets/SShooterDemoList.h"
 #include "Widgets/SShooterLeaderboard.h"
+#include "Widgets/SShooterMatchHistory.h"
 #include "Widgets/SShooterOnlineStore.h"
 #include "Widgets/SShooterSplitScreenLobbyWidget.h"
 #include "ShooterOptions.h"
@@ -88,6 +89,9 @@ protected:
 	/** leaderboard widget */
 	TSharedPtr<class SShooterLeaderboard> LeaderboardWidget;
 
+	/** match history widget */
+	TSharedPtr<class SShooterMatchHistory> MatchHistoryWidget;
+
 	/** online store widget */
 	TSharedPtr<class SShooterOnlineStore> OnlineStoreWidget;
 
@@ -97,6 +101,9 @@ protected:
 	/** yet another custom menu */
 	TSharedPtr<class FShooterMenuItem> LeaderboardItem;
 
+	/** Custom match history menu */
+	TSharedPtr<class FShooterMenuItem> MatchHistoryItem;
+
 	/** yet another custom menu */
 	TSharedPtr<class FShooterMenuItem> OnlineStoreItem;
 
@@ -113,9 +120,6 @@ protected:
 	/** Record demo option */
 	TSharedPtr<class FShooterMenuItem> RecordDemoItem;
 
-	/** Settings and storage for quickmatch searching */
-	TSharedPtr<FOnlineSessionSearch> QuickMatchSearchSettings;
-
 	/** Map selection widget */
 	TSharedPtr<FShooterMenuItem> HostOfflineMapOption;
 	TSharedPtr<FShooterMenuItem> HostOnlineMapOption;
@@ -169,7 +173,11 @@ protected:
 
 	FReply OnSplitScreenPlay();
 
-	void OnMatchmakingComplete(FName SessionName, const FOnlineError& ErrorDetails, const FSessionMatchmakingResults& Results);
+	/** Quick match search done, starts the game session's matchmaking over the results */
+	void OnQuickMatchFindSessionsComplete(bool bWasSuccessful);
+
+	/** Quick match matchmaking done: travels to the joined session, hosts one if the search found nothing to join, shows the failure UI otherwise */
+	void OnQuickMatchComplete(EOnJoinSessionCompleteResult::Type Result);
 
 	/** bot count option changed callback */
 	void BotCountOptionChanged(TSharedPtr<FShooterMenuItem> MenuItem, int32 MultiOptionIndex);			
@@ -219,6 +227,9 @@ protected:
 	/** Show leaderboard */
 	void OnShowLeaderboard();
 
+	/** Show match history */
+	void OnShowMatchHistory();
+
 	/** Show online store */
 	void OnShowOnlineStore();
 
@@ -237,7 +248,7 @@ protected:
 	/** Display the loading screen. */
 	void DisplayLoadingScreen();
 
-	/** Begins searching for a quick match (matchmaking) */
+	/** Begins searching for a quick match, through the game session's FindSessions and StartMatchmaking */
 	void BeginQuickMatchSearch();
 
 	/** Checks the ChunkInstaller to see if the selected map is ready for play */
@@ -273,8 +284,8 @@ protected:
 	// Generic confirmation handling (just hide the dialog)
 	FReply OnConfirmGeneric();	
 
-	/** Delegate function executed when the quick match async cancel operation is complete */
-	void OnCancelMatchmakingComplete(FName SessionName, bool bWasSuccessful);
+	/** Takes the stopping UI down once the quick match step that was in flight when it got canceled is complete */
+	void OnQuickMatchCanceled();
 
 	/** Delegate function executed when login completes after constructing the menu */
 	void OnLoginCompleteConstruct(int32 LocalUserNum, bool bWasSuccessful, const FUniqueNetId& UserId, const FString& Error);
@@ -288,9 +299,6 @@ protected:
 	/** Delegate function executed when login completes before quickmatch is started */
 	void OnLoginCompleteQuickmatch(int32 LocalUserNum, bool bWasSuccessful, const FUniqueNetId& UserId, const FString& Error);
 
-	/** Delegate for canceling matchmaking */
-	FOnCancelMatchmakingCompleteDelegate OnCancelMatchmakingCompleteDelegate;
-
 	/** number of bots in game */
 	int32 BotsCountOpt;
 
@@ -349,7 +357,8 @@ protected:
 	void HelperQuickMatchSearchingUICancel(bool bShouldRemoveSession); //helper for removing QuickMatch Searching UI
 	FReply OnQuickMatchSearchingUICancel();
 
-	FDelegateHandle OnCancelMatchmakingCompleteDelegateHandle;
+	FDelegateHandle OnQuickMatchFindSessionsCompleteDelegateHandle;
+	FDelegateHandle OnQuickMatchJoinSessionCompleteDelegateHandle;
 	FDelegateHandle OnLoginCompleteConstructDelegateHandle;
 	FDelegateHandle OnLoginCompleteQuickmatchDelegateHandle;
 	FDelegateHandle OnLoginCompleteHostOnlineDelegateHandle;
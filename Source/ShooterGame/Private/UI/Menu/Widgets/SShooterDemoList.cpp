@@ -9,15 +9,15 @@
 #include "ShooterGameInstance.h"
 #include "NetworkReplayStreaming.h"
 #include "ShooterGameViewportClient.h"
+#include "ShooterReplayIndex.h"
 
 #define LOCTEXT_NAMESPACE "ShooterGame.HUD.Menu"
 
 struct FDemoEntry
 {
-	FNetworkReplayStreamInfo StreamInfo;
+	FShooterReplayIndexEntry StreamInfo;
 	FString		Date;
 	FString		Size;
-	int32		ResultsIndex;
 };
 
 void SShooterDemoList::Construct(const FArguments& InArgs)
@@ -25,13 +25,15 @@ void SShooterDemoList::Construct(const FArguments& InArgs)
 	PlayerOwner			= InArgs._PlayerOwner;
 	OwnerWidget			= InArgs._OwnerWidget;
 	bUpdatingDemoList	= false;
+	bCheckingReplayIndex = false;
 	StatusText			= FText::GetEmpty();
 	
 	EnumerateStreamsVersion = FNetworkVersion::GetReplayVersion();
 
-	const int32 NameWidth		= 280;
+	const int32 NameWidth		= 200;
+	const int32 MapWidth		= 100;
 	const int32 ViewersWidth	= 64;
-	const int32 DateWidth		= 210;
+	const int32 DateWidth		= 190;
 	const int32 LengthWidth		= 64;
 
 	ChildSlot
@@ -70,6 +72,7 @@ void SShooterDemoList::Construct(const FArguments& InArgs)
 				.HeaderRow(
 					SNew(SHeaderRow)
 					+ SHeaderRow::Column("DemoName").FixedWidth(NameWidth).DefaultLabel(NSLOCTEXT("DemoList", "DemoNameColumn", "Demo Name"))
+					+ SHeaderRow::Column("Map").FixedWidth(MapWidth).DefaultLabel(NSLOCTEXT("DemoList", "MapColumn", "Map"))
 					+ SHeaderRow::Column("Viewers").FixedWidth(ViewersWidth).DefaultLabel(NSLOCTEXT("Viewers", "ViewersColumn", "Viewers"))
 					+ SHeaderRow::Column("Date").FixedWidth(DateWidth).DefaultLabel(NSLOCTEXT("DemoList", "DateColumn", "Date"))
 					+ SHeaderRow::Column("Length").FixedWidth(LengthWidth).DefaultLabel(NSLOCTEXT("Length", "LengthColumn", "Length"))
@@ -96,43 +99,75 @@ void SShooterDemoList::Construct(const FArguments& InArgs)
 	BuildDemoList();
 }
 
-void SShooterDemoList::OnEnumerateStreamsComplete(const FEnumerateStreamsResult& Result )
+void SShooterDemoList::FillDemoListFromIndex()
 {
-	check(bUpdatingDemoList); // should not be called otherwise
+	UShooterGameInstance* const GI = Cast<UShooterGameInstance>(PlayerOwner->GetGameInstance());
+	if (GI == nullptr)
+	{
+		return;
+	}
 
-	bool bFinished = true;
+	const FString SelectedName = SelectedItem.IsValid() ? SelectedItem->StreamInfo.Name : FString();
+	DemoList.Reset();
 
-	for ( const auto& StreamInfo : Result.FoundStreams )
+	// The index is kept sorted by date, most recent first
+	for (const FShooterReplayIndexEntry& Replay : GI->GetReplayIndex()->GetEntries())
 	{
-		float SizeInKilobytes = StreamInfo.SizeInBytes / 1024.0f;
+		if (EnumerateStreamsVersion.NetworkVersion != 0 && Replay.NetworkVersion != EnumerateStreamsVersion.NetworkVersion)
+		{
+			continue;
+		}
+
+		float SizeInKilobytes = Replay.SizeInBytes / 1024.0f;
 
 		TSharedPtr<FDemoEntry> NewDemoEntry = MakeShareable( new FDemoEntry() );
 
-		NewDemoEntry->StreamInfo	= StreamInfo;
-		NewDemoEntry->Date			= StreamInfo.Timestamp.ToString( TEXT( "%m/%d/%Y %h:%M %A" ) );	// UTC time
+		NewDemoEntry->StreamInfo	= Replay;
+		NewDemoEntry->Date			= Replay.Timestamp.ToString( TEXT( "%m/%d/%Y %h:%M %A" ) );	// UTC time
 		NewDemoEntry->Size			= SizeInKilobytes >= 1024.0f ? FString::Printf( TEXT("%2.2f MB" ), SizeInKilobytes / 1024.0f ) : FString::Printf( TEXT("%i KB" ), (int)SizeInKilobytes );
 
 		DemoList.Add( NewDemoEntry );
-	}
 
-	// Sort demo names by date
-	struct FCompareDateTime
-	{
-		FORCEINLINE bool operator()( const TSharedPtr<FDemoEntry> & A, const TSharedPtr<FDemoEntry> & B ) const
+		if (Replay.Name == SelectedName)
 		{
-			return A->StreamInfo.Timestamp.GetTicks() > B->StreamInfo.Timestamp.GetTicks();
+			SelectedItem = NewDemoEntry;
 		}
-	};
+	}
+}
 
-	Sort( DemoList.GetData(), DemoList.Num(), FCompareDateTime() );
+void SShooterDemoList::OnEnumerateAllStreamsComplete(const FEnumerateStreamsResult& Result)
+{
+	if (!Result.WasSuccessful() || !ReplayStreamer.IsValid())
+	{
+		// Keep showing the index as it is
+		bCheckingReplayIndex = false;
+		return;
+	}
 
-	//StatusText = "";
-	StatusText = LOCTEXT("DemoSelectionInfo","Press ENTER to Play. Press DEL to delete.");
+	AllStreams = Result.FoundStreams;
+
+	// Then the streams this version can play, the only way to tell replay versions apart
+	ReplayStreamer->EnumerateStreams(FNetworkVersion::GetReplayVersion(), INDEX_NONE, FString(), TArray<FString>(), FEnumerateStreamsCallback::CreateSP(this, &SShooterDemoList::OnEnumerateStreamsComplete));
+}
 
-	if ( bFinished )
-	{		
-		OnBuildDemoListFinished();
+void SShooterDemoList::OnEnumerateStreamsComplete(const FEnumerateStreamsResult& Result )
+{
+	bCheckingReplayIndex = false;
+
+	UShooterGameInstance* const GI = Cast<UShooterGameInstance>(PlayerOwner->GetGameInstance());
+	if (Result.WasSuccessful() && GI)
+	{
+		UShooterReplayIndex* ReplayIndex = GI->GetReplayIndex();
+		if (ReplayIndex->Reconcile(AllStreams, Result.FoundStreams))
+		{
+			ReplayIndex->SaveIfDirty();
+
+			FillDemoListFromIndex();
+			OnBuildDemoListFinished();
+		}
 	}
+
+	AllStreams.Empty();
 }
 
 FText SShooterDemoList::GetBottomText() const
@@ -174,18 +209,33 @@ void SShooterDemoList::OnShowAllReplaysChecked(ECheckBoxState NewCheckedState)
 		EnumerateStreamsVersion.NetworkVersion = 0;
 	}
 
-	BuildDemoList();
+	// The index knows every replay's version, no need to ask the streamer again
+	FillDemoListFromIndex();
+	OnBuildDemoListFinished();
 }
 
 /** Populates the demo list */
 void SShooterDemoList::BuildDemoList()
 {
 	bUpdatingDemoList = true;
-	DemoList.Empty();
 
-	if ( ReplayStreamer.IsValid() )
+	FillDemoListFromIndex();
+
+	//StatusText = "";
+	StatusText = LOCTEXT("DemoSelectionInfo","Press ENTER to Play. Press DEL to delete.");
+
+	OnBuildDemoListFinished();
+
+	// The index may be missing replays recorded or deleted elsewhere
+	if ( ReplayStreamer.IsValid() && !bCheckingReplayIndex )
 	{
-		ReplayStreamer->EnumerateStreams(EnumerateStreamsVersion, INDEX_NONE, FString(), TArray<FString>(), FEnumerateStreamsCallback::CreateSP(this, &SShooterDemoList::OnEnumerateStreamsComplete));
+		bCheckingReplayIndex = true;
+
+		FNetworkReplayVersion AllVersions = FNetworkVersion::GetReplayVersion();
+		AllVersions.NetworkVersion = 0;
+		AllVersions.Changelist = 0;
+
+		ReplayStreamer->EnumerateStreams(AllVersions, INDEX_NONE, FString(), TArray<FString>(), FEnumerateStreamsCallback::CreateSP(this, &SShooterDemoList::OnEnumerateAllStreamsComplete));
 	}
 }
 
@@ -263,7 +313,6 @@ FReply SShooterDemoList::OnDemoDeleteConfirm()
 	if (SelectedItem.IsValid() && ReplayStreamer.IsValid())
 	{
 		bUpdatingDemoList = true;
-		DemoList.Empty();
 
 		ReplayStreamer->DeleteFinishedStream(SelectedItem->StreamInfo.Name, FDeleteFinishedStreamCallback::CreateSP(this, &SShooterDemoList::OnDeleteFinishedStreamComplete));
 	}
@@ -302,7 +351,17 @@ FReply SShooterDemoList::OnDemoDeleteCancel()
 
 void SShooterDemoList::OnDeleteFinishedStreamComplete(const FDeleteFinishedStreamResult& Result)
 {
-	BuildDemoList();
+	UShooterGameInstance* const GI = Cast<UShooterGameInstance>(PlayerOwner->GetGameInstance());
+	if (Result.WasSuccessful() && GI && SelectedItem.IsValid())
+	{
+		UShooterReplayIndex* ReplayIndex = GI->GetReplayIndex();
+		ReplayIndex->RemoveReplay(SelectedItem->StreamInfo.Name);
+		ReplayIndex->SaveIfDirty();
+		SelectedItem.Reset();
+	}
+
+	FillDemoListFromIndex();
+	OnBuildDemoListFinished();
 }
 
 void SShooterDemoList::OnFocusLost(const FFocusEvent& InFocusEvent)
@@ -415,6 +474,10 @@ TSharedRef<ITableRow> SShooterDemoList::MakeListViewWidget(TSharedPtr<FDemoEntry
 
 				ItemText = FText::FromString(NameString);
 			}
+			else if (ColumnName == "Map")
+			{
+				ItemText = FText::FromString(Item->StreamInfo.MapName);
+			}
 			else if (ColumnName == "Viewers")
 			{
 				ItemText = FText::FromString( FString::Printf( TEXT( "%i" ), Item->StreamInfo.NumViewers ) );
@@ -50,13 +50,19 @@ public:
 	/** Updates the list until it's completely populated */
 	void UpdateBuildDemoListStatus();
 
-	/** Populates the demo list */
+	/** Populates the demo list from the replay index, then checks the index against the replay streamer */
 	void BuildDemoList();
 
+	/** Refills the demo list from the replay index */
+	void FillDemoListFromIndex();
+
 	/** Called when demo list building finished */
 	void OnBuildDemoListFinished();
 
-	/** Called when we get results from the replay streaming interface */
+	/** Called when we get the streams of all versions from the replay streaming interface */
+	void OnEnumerateAllStreamsComplete(const FEnumerateStreamsResult& Result);
+
+	/** Called when we get the streams of the current version from the replay streaming interface */
 	void OnEnumerateStreamsComplete(const FEnumerateStreamsResult& Result);
 
 	/** Play chosen demo */
@@ -101,6 +107,12 @@ protected:
 	/** Whether we're building the demo list or not */
 	bool bUpdatingDemoList;
 
+	/** Whether the replay index is being checked against the replay streamer */
+	bool bCheckingReplayIndex;
+
+	/** Streams of all versions, while checking the replay index */
+	TArray<FNetworkReplayStreamInfo> AllStreams;
+
 	/** action bindings array */
 	TArray< TSharedPtr<FDemoEntry> > DemoList;
 
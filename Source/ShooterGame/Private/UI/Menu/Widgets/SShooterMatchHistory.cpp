@@ -0,0 +1,198 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "SShooterMatchHistory.h"
+#include "ShooterStyle.h"
+#include "Player/ShooterLocalPlayer.h"
+#include "Player/ShooterPersistentUser.h"
+
+static int32 ShooterMatchHistoryMenuMatches = 100;
+static FAutoConsoleVariableRef CVarShooterMatchHistoryMenuMatches(
+	TEXT("ShooterGame.MatchHistory.MenuMatches"),
+	ShooterMatchHistoryMenuMatches,
+	TEXT("Number of recent matches listed in the match history menu."),
+	ECVF_Default);
+
+static int32 ShooterMatchHistoryTrendWindow = 10;
+static FAutoConsoleVariableRef CVarShooterMatchHistoryTrendWindow(
+	TEXT("ShooterGame.MatchHistory.TrendWindow"),
+	ShooterMatchHistoryTrendWindow,
+	TEXT("Number of matches in each K/D trend window of the match history menu."),
+	ECVF_Default);
+
+void SShooterMatchHistory::Construct(const FArguments& InArgs)
+{
+	PlayerOwner = InArgs._PlayerOwner;
+	OwnerWidget = InArgs._OwnerWidget;
+	const int32 BoxWidth = 125;
+
+	ChildSlot
+	.VAlign(VAlign_Fill)
+	.HAlign(HAlign_Fill)
+	[
+		SNew(SVerticalBox)
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		[
+			SNew(STextBlock)
+			.Text(this, &SShooterMatchHistory::GetSummaryText)
+			.TextStyle(FShooterStyle::Get(), "ShooterGame.ScoreboardListTextStyle")
+		]
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		[
+			SNew(SBox)
+			.WidthOverride(600)
+			.HeightOverride(600)
+			[
+				SAssignNew(MatchListWidget, SListView< TSharedPtr<FShooterMatchRecord> >)
+				.ItemHeight(20)
+				.ListItemsSource(&Matches)
+				.SelectionMode(ESelectionMode::Single)
+				.OnGenerateRow(this, &SShooterMatchHistory::MakeListViewWidget)
+				.HeaderRow(
+				SNew(SHeaderRow)
+				+ SHeaderRow::Column("Date").FixedWidth(BoxWidth*2).DefaultLabel(NSLOCTEXT("MatchHistory", "DateColumn", "Date"))
+				+ SHeaderRow::Column("Result").FixedWidth(BoxWidth).DefaultLabel(NSLOCTEXT("MatchHistory", "ResultColumn", "Result"))
+				+ SHeaderRow::Column("Kills").FixedWidth(BoxWidth/2).DefaultLabel(NSLOCTEXT("MatchHistory", "KillsColumn", "Kills"))
+				+ SHeaderRow::Column("Deaths").FixedWidth(BoxWidth/2).DefaultLabel(NSLOCTEXT("MatchHistory", "DeathsColumn", "Deaths"))
+				+ SHeaderRow::Column("KD").DefaultLabel(NSLOCTEXT("MatchHistory", "KDColumn", "K/D")))
+			]
+		]
+	];
+}
+
+void SShooterMatchHistory::ReadMatchHistory()
+{
+	Matches.Reset();
+	SummaryText = NSLOCTEXT("MatchHistory", "NoMatches", "No matches played yet");
+
+	UShooterLocalPlayer* const LocalPlayer = Cast<UShooterLocalPlayer>(PlayerOwner.Get());
+	UShooterPersistentUser* const PersistentUser = LocalPlayer ? LocalPlayer->GetPersistentUser() : nullptr;
+	FShooterMatchHistory* const History = PersistentUser ? PersistentUser->GetMatchHistory() : nullptr;
+	if (History)
+	{
+		// Only the records shown are read, however long the history is
+		TArray<FShooterMatchRecord> Records;
+		History->GetRecentMatches(ShooterMatchHistoryMenuMatches, Records);
+		for (const FShooterMatchRecord& Record : Records)
+		{
+			Matches.Add(MakeShared<FShooterMatchRecord>(Record));
+		}
+
+		const int32 NumMatches = History->GetNumMatches();
+		const int32 TrendWindow = FMath::Max(ShooterMatchHistoryTrendWindow, 1);
+
+		TArray<float> Trend;
+		History->GetKillDeathTrend(TrendWindow, 2, Trend);
+		if (Trend.Num() == 2)
+		{
+			SummaryText = FText::Format(NSLOCTEXT("MatchHistory", "SummaryWithTrend", "{0} matches played. K/D over the last {1}: {2}, the {1} before: {3}"),
+				FText::AsNumber(NumMatches), FText::AsNumber(TrendWindow), FText::AsNumber(Trend[0]), FText::AsNumber(Trend[1]));
+		}
+		else if (Trend.Num() == 1)
+		{
+			SummaryText = FText::Format(NSLOCTEXT("MatchHistory", "Summary", "{0} matches played. K/D: {1}"),
+				FText::AsNumber(NumMatches), FText::AsNumber(Trend[0]));
+		}
+	}
+
+	MatchListWidget->RequestListRefresh();
+	if (Matches.Num() > 0)
+	{
+		MatchListWidget->SetSelection(Matches[0]);
+	}
+}
+
+FText SShooterMatchHistory::GetSummaryText() const
+{
+	return SummaryText;
+}
+
+void SShooterMatchHistory::OnFocusLost(const FFocusEvent& InFocusEvent)
+{
+	if (InFocusEvent.GetCause() != EFocusCause::SetDirectly)
+	{
+		FSlateApplication::Get().SetKeyboardFocus(SharedThis(this));
+	}
+}
+
+FReply SShooterMatchHistory::OnFocusReceived(const FGeometry& MyGeometry, const FFocusEvent& InFocusEvent)
+{
+	return FReply::Handled().SetUserFocus(MatchListWidget.ToSharedRef(), EFocusCause::SetDirectly);
+}
+
+void SShooterMatchHistory::MoveSelection(int32 MoveBy)
+{
+	TArray< TSharedPtr<FShooterMatchRecord> > SelectedItems = MatchListWidget->GetSelectedItems();
+	const int32 SelectedItemIndex = SelectedItems.Num() > 0 ? Matches.IndexOfByKey(SelectedItems[0]) : INDEX_NONE;
+
+	if (SelectedItemIndex+MoveBy > -1 && SelectedItemIndex+MoveBy < Matches.Num())
+	{
+		MatchListWidget->SetSelection(Matches[SelectedItemIndex+MoveBy]);
+		MatchListWidget->RequestScrollIntoView(Matches[SelectedItemIndex+MoveBy]);
+	}
+}
+
+FReply SShooterMatchHistory::OnKeyDown(const FGeometry& MyGeometry, const FKeyEvent& InKeyEvent)
+{
+	FReply Result = FReply::Unhandled();
+	const FKey Key = InKeyEvent.GetKey();
+	if (Key == EKeys::Up || Key == EKeys::Gamepad_DPad_Up || Key == EKeys::Gamepad_LeftStick_Up)
+	{
+		MoveSelection(-1);
+		Result = FReply::Handled();
+	}
+	else if (Key == EKeys::Down || Key == EKeys::Gamepad_DPad_Down || Key == EKeys::Gamepad_LeftStick_Down)
+	{
+		MoveSelection(1);
+		Result = FReply::Handled();
+	}
+	return Result;
+}
+
+TSharedRef<ITableRow> SShooterMatchHistory::MakeListViewWidget(TSharedPtr<FShooterMatchRecord> Item, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	class SMatchRowWidget : public SMultiColumnTableRow< TSharedPtr<FShooterMatchRecord> >
+	{
+	public:
+		SLATE_BEGIN_ARGS(SMatchRowWidget){}
+		SLATE_END_ARGS()
+
+		void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTable, TSharedPtr<FShooterMatchRecord> InItem)
+		{
+			Item = InItem;
+			SMultiColumnTableRow< TSharedPtr<FShooterMatchRecord> >::Construct(FSuperRowType::FArguments(), InOwnerTable);
+		}
+
+		TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName)
+		{
+			FText ItemText = FText::GetEmpty();
+			if (ColumnName == "Date")
+			{
+				ItemText = FText::FromString(Item->GetTime().ToString(TEXT("%m/%d/%Y %h:%M %A")));	// UTC time
+			}
+			else if (ColumnName == "Result")
+			{
+				ItemText = Item->IsWin() ? NSLOCTEXT("MatchHistory", "Won", "Won") : NSLOCTEXT("MatchHistory", "Lost", "Lost");
+			}
+			else if (ColumnName == "Kills")
+			{
+				ItemText = FText::AsNumber(Item->Kills);
+			}
+			else if (ColumnName == "Deaths")
+			{
+				ItemText = FText::AsNumber(Item->Deaths);
+			}
+			else if (ColumnName == "KD")
+			{
+				ItemText = FText::AsNumber((float)Item->Kills / FMath::Max(Item->Deaths, 1));
+			}
+			return SNew(STextBlock)
+				.Text(ItemText)
+				.TextStyle(FShooterStyle::Get(), "ShooterGame.ScoreboardListTextStyle");
+		}
+		TSharedPtr<FShooterMatchRecord> Item;
+	};
+	return SNew(SMatchRowWidget, OwnerTable, Item);
+}
@@ -0,0 +1,64 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "SlateBasics.h"
+#include "SlateExtras.h"
+#include "ShooterGame.h"
+#include "Player/ShooterMatchHistory.h"
+
+/** Lists the local player's most recent matches from their match history log, with their K/D trend */
+class SShooterMatchHistory : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SShooterMatchHistory)
+	{}
+
+	SLATE_ARGUMENT(TWeakObjectPtr<ULocalPlayer>, PlayerOwner)
+	SLATE_ARGUMENT(TSharedPtr<SWidget>, OwnerWidget)
+
+	SLATE_END_ARGS()
+
+	/** needed for every widget */
+	void Construct(const FArguments& InArgs);
+
+	/** if we want to receive focus */
+	virtual bool SupportsKeyboardFocus() const override { return true; }
+
+	/** focus received handler - keep the list focused */
+	virtual FReply OnFocusReceived(const FGeometry& MyGeometry, const FFocusEvent& InFocusEvent) override;
+
+	/** focus lost handler - keep the list focused */
+	virtual void OnFocusLost(const FFocusEvent& InFocusEvent) override;
+
+	/** key down handler */
+	virtual FReply OnKeyDown(const FGeometry& MyGeometry, const FKeyEvent& InKeyEvent) override;
+
+	/** Reads the most recent matches and the K/D trend from the owner's match history */
+	void ReadMatchHistory();
+
+protected:
+	/** creates single item widget, called for every list item */
+	TSharedRef<ITableRow> MakeListViewWidget(TSharedPtr<FShooterMatchRecord> Item, const TSharedRef<STableViewBase>& OwnerTable);
+
+	/** selects item at current + MoveBy index */
+	void MoveSelection(int32 MoveBy);
+
+	/** Number of matches and K/D trend, shown above the list */
+	FText GetSummaryText() const;
+
+	/** most recent matches, newest first */
+	TArray< TSharedPtr<FShooterMatchRecord> > Matches;
+
+	/** match list slate widget */
+	TSharedPtr< SListView< TSharedPtr<FShooterMatchRecord> > > MatchListWidget;
+
+	/** Built by ReadMatchHistory */
+	FText SummaryText;
+
+	/** pointer to our owner PC */
+	TWeakObjectPtr<class ULocalPlayer> PlayerOwner;
+
+	/** pointer to our parent widget */
+	TSharedPtr<class SWidget> OwnerWidget;
+};
@@ -7,6 +7,8 @@
 #include "ShooterGameLoadingScreen.h"
 #include "ShooterGameInstance.h"
 #include "Online/ShooterGameSession.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
 
 #define LOCTEXT_NAMESPACE "ShooterGame.HUD.Menu"
 
@@ -20,6 +22,8 @@ void SShooterServerList::Construct(const FArguments& InArgs)
 	StatusText = FText::GetEmpty();
 	BoxWidth = 125;
 	LastSearchTime = 0.0f;
+	SortColumn = "Ping";
+	SortMode = EColumnSortMode::Ascending;
 	
 #if PLATFORM_SWITCH
 	MinTimeBetweenSearches = 6.0;
@@ -52,7 +56,11 @@ void SShooterServerList::Construct(const FArguments& InArgs)
 					+ SHeaderRow::Column("GameType") .DefaultLabel(NSLOCTEXT("ServerList", "GameTypeColumn", "Game Type"))
 					+ SHeaderRow::Column("Map").DefaultLabel(NSLOCTEXT("ServerList", "MapNameColumn", "Map"))
 					+ SHeaderRow::Column("Players") .DefaultLabel(NSLOCTEXT("ServerList", "PlayersColumn", "Players"))
-					+ SHeaderRow::Column("Ping") .DefaultLabel(NSLOCTEXT("ServerList", "NetworkPingColumn", "Ping")))
+						.SortMode(this, &SShooterServerList::GetColumnSortMode, FName("Players"))
+						.OnSort(this, &SShooterServerList::OnColumnSort)
+					+ SHeaderRow::Column("Ping") .DefaultLabel(NSLOCTEXT("ServerList", "NetworkPingColumn", "Ping"))
+						.SortMode(this, &SShooterServerList::GetColumnSortMode, FName("Ping"))
+						.OnSort(this, &SShooterServerList::OnColumnSort))
 			]
 		]
 		+SVerticalBox::Slot()
@@ -100,16 +108,19 @@ void SShooterServerList::UpdateSearchStatus()
 		switch(SearchState)
 		{
 			case EOnlineAsyncTaskState::InProgress:
-				StatusText = LOCTEXT("Searching","SEARCHING...");
+				// LAN results arrive one by one, show them as they come
+				AddSearchResults(ShooterSession->GetSearchResults(), NumSearchResults);
+				StatusText = AllServers.Num() > 0 ? FText::Format(LOCTEXT("SearchingFound","SEARCHING... {0} FOUND"), FText::AsNumber(AllServers.Num())) : LOCTEXT("Searching","SEARCHING...");
 				bFinishSearch = false;
 				break;
 
 			case EOnlineAsyncTaskState::Done:
-				// copy the results
+				// add the results that are not listed yet
 				{
-					ServerList.Empty();
 					const TArray<FOnlineSessionSearchResult> & SearchResults = ShooterSession->GetSearchResults();
 					check(SearchResults.Num() == NumSearchResults);
+					AddSearchResults(SearchResults, NumSearchResults);
+
 					if (NumSearchResults == 0)
 					{
 #if PLATFORM_PS4
@@ -134,28 +145,6 @@ void SShooterServerList::UpdateSearchStatus()
 						StatusText = LOCTEXT("ServersRefresh","PRESS SPACE TO REFRESH SERVER LIST");
 #endif
 					}
-
-					for (int32 IdxResult = 0; IdxResult < NumSearchResults; ++IdxResult)
-					{
-						TSharedPtr<FServerEntry> NewServerEntry = MakeShareable(new FServerEntry());
-
-						const FOnlineSessionSearchResult& Result = SearchResults[IdxResult];
-
-						NewServerEntry->ServerName = Result.Session.OwningUserName;
-						NewServerEntry->Ping = FString::FromInt(Result.PingInMs);
-						NewServerEntry->CurrentPlayers = FString::FromInt(Result.Session.SessionSettings.NumPublicConnections 
-							+ Result.Session.SessionSettings.NumPrivateConnections 
-							- Result.Session.NumOpenPublicConnections 
-							- Result.Session.NumOpenPrivateConnections);
-						NewServerEntry->MaxPlayers = FString::FromInt(Result.Session.SessionSettings.NumPublicConnections
-							+ Result.Session.SessionSettings.NumPrivateConnections);
-						NewServerEntry->SearchResultsIndex = IdxResult;
-					
-						Result.Session.SessionSettings.Get(SETTING_GAMEMODE, NewServerEntry->GameType);
-						Result.Session.SessionSettings.Get(SETTING_MAPNAME, NewServerEntry->MapName);
-
-						ServerList.Add(NewServerEntry);
-					}
 				}
 				break;
 
@@ -211,7 +200,9 @@ void SShooterServerList::BeginServerSearch(bool bLANMatch, bool bIsDedicatedServ
 		bDedicatedServer = bIsDedicatedServer;
 		MapFilterName = InMapFilterName;
 		bSearchingForServers = true;
+		AllServers.Empty();
 		ServerList.Empty();
+		ServerListWidget->RequestListRefresh();
 		LastSearchTime = CurrentTime;
 
 		UShooterGameInstance* const GI = Cast<UShooterGameInstance>(PlayerOwner->GetGameInstance());
@@ -227,34 +218,133 @@ void SShooterServerList::OnServerSearchFinished()
 {
 	bSearchingForServers = false;
 
-	UpdateServerList();
+	// The list is already filtered and sorted, only the selection is left
+	RestoreSelection();
 }
 
-void SShooterServerList::UpdateServerList()
+void SShooterServerList::AddSearchResults(const TArray<FOnlineSessionSearchResult>& SearchResults, int32 NumSearchResults)
+{
+	if (NumSearchResults < AllServers.Num())
+	{
+		// The results were replaced rather than added to, start over
+		AllServers.Empty();
+		ServerList.Empty();
+	}
+
+	const int32 FirstNewResult = AllServers.Num();
+	for (int32 IdxResult = FirstNewResult; IdxResult < NumSearchResults; ++IdxResult)
+	{
+		TSharedPtr<FServerEntry> NewServerEntry = MakeShareable(new FServerEntry());
+
+		const FOnlineSessionSearchResult& Result = SearchResults[IdxResult];
+
+		NewServerEntry->ServerName = Result.Session.OwningUserName;
+		NewServerEntry->PingInMs = Result.PingInMs;
+		NewServerEntry->Ping = FString::FromInt(Result.PingInMs);
+		NewServerEntry->NumPlayers = Result.Session.SessionSettings.NumPublicConnections 
+			+ Result.Session.SessionSettings.NumPrivateConnections 
+			- Result.Session.NumOpenPublicConnections 
+			- Result.Session.NumOpenPrivateConnections;
+		NewServerEntry->CurrentPlayers = FString::FromInt(NewServerEntry->NumPlayers);
+		NewServerEntry->MaxPlayers = FString::FromInt(Result.Session.SessionSettings.NumPublicConnections
+			+ Result.Session.SessionSettings.NumPrivateConnections);
+		NewServerEntry->SearchResultsIndex = IdxResult;
+	
+		Result.Session.SessionSettings.Get(SETTING_GAMEMODE, NewServerEntry->GameType);
+		Result.Session.SessionSettings.Get(SETTING_MAPNAME, NewServerEntry->MapName);
+
+		AllServers.Add(NewServerEntry);
+
+		if (PassesFilter(*NewServerEntry))
+		{
+			const int32 InsertIndex = Algo::UpperBound(ServerList, NewServerEntry, [this](const TSharedPtr<FServerEntry>& A, const TSharedPtr<FServerEntry>& B) { return SortsBefore(A, B); });
+			ServerList.Insert(NewServerEntry, InsertIndex);
+		}
+	}
+
+	if (AllServers.Num() != FirstNewResult)
+	{
+		// Rows are only generated for the visible entries, and existing rows are kept
+		ServerListWidget->RequestListRefresh();
+	}
+}
+
+bool SShooterServerList::PassesFilter(const FServerEntry& Entry) const
 {
 	/** Only filter maps if a specific map is specified */
-	if (MapFilterName != "Any")
+	return MapFilterName == "Any" || Entry.MapName == MapFilterName;
+}
+
+bool SShooterServerList::SortsBefore(const TSharedPtr<FServerEntry>& A, const TSharedPtr<FServerEntry>& B) const
+{
+	const bool bAscending = SortMode != EColumnSortMode::Descending;
+	if (SortColumn == "Players")
 	{
-		for (int32 i = 0; i < ServerList.Num(); ++i)
+		if (A->NumPlayers != B->NumPlayers)
 		{
-			/** Only filter maps if a specific map is specified */
-			if (ServerList[i]->MapName != MapFilterName)
-			{
-				ServerList.RemoveAt(i);
-				i--;
-			}
+			return bAscending ? A->NumPlayers < B->NumPlayers : A->NumPlayers > B->NumPlayers;
+		}
+		if (A->PingInMs != B->PingInMs)
+		{
+			return A->PingInMs < B->PingInMs;
+		}
+	}
+	else
+	{
+		if (A->PingInMs != B->PingInMs)
+		{
+			return bAscending ? A->PingInMs < B->PingInMs : A->PingInMs > B->PingInMs;
+		}
+		if (A->NumPlayers != B->NumPlayers)
+		{
+			return A->NumPlayers > B->NumPlayers;
 		}
 	}
 
-	int32 SelectedItemIndex = ServerList.IndexOfByKey(SelectedItem);
+	// Keep the search order for otherwise equal servers
+	return A->SearchResultsIndex < B->SearchResultsIndex;
+}
 
+EColumnSortMode::Type SShooterServerList::GetColumnSortMode(FName ColumnId) const
+{
+	return ColumnId == SortColumn ? SortMode : EColumnSortMode::None;
+}
+
+void SShooterServerList::OnColumnSort(EColumnSortPriority::Type SortPriority, const FName& ColumnId, EColumnSortMode::Type NewSortMode)
+{
+	SortColumn = ColumnId;
+	SortMode = NewSortMode;
+
+	Algo::Sort(ServerList, [this](const TSharedPtr<FServerEntry>& A, const TSharedPtr<FServerEntry>& B) { return SortsBefore(A, B); });
 	ServerListWidget->RequestListRefresh();
+}
+
+void SShooterServerList::UpdateServerList()
+{
+	// Refilter the existing entries, the list view keeps the rows of the ones still shown
+	ServerList.Reset();
+	for (const TSharedPtr<FServerEntry>& Entry : AllServers)
+	{
+		if (PassesFilter(*Entry))
+		{
+			ServerList.Add(Entry);
+		}
+	}
+	Algo::Sort(ServerList, [this](const TSharedPtr<FServerEntry>& A, const TSharedPtr<FServerEntry>& B) { return SortsBefore(A, B); });
+
+	ServerListWidget->RequestListRefresh();
+	RestoreSelection();
+}
+
+void SShooterServerList::RestoreSelection()
+{
+	int32 SelectedItemIndex = ServerList.IndexOfByKey(SelectedItem);
+
 	if (ServerList.Num() > 0)
 	{
 		ServerListWidget->UpdateSelectionSet();
 		ServerListWidget->SetSelection(ServerList[SelectedItemIndex > -1 ? SelectedItemIndex : 0],ESelectInfo::OnNavigation);
 	}
-
 }
 
 void SShooterServerList::ConnectToServer()
@@ -18,6 +18,10 @@ struct FServerEntry
 	FString MapName;
 	FString Ping;
 	int32 SearchResultsIndex;
+
+	/** Numeric values of Ping and CurrentPlayers, for sorting */
+	int32 PingInMs;
+	int32 NumPlayers;
 };
 
 //class declare
@@ -75,6 +79,24 @@ public:
 	/** fill/update server list, should be called before showing this control */
 	void UpdateServerList();
 
+	/** Adds entries for the search results that arrived since the last call, inserting the ones that pass the filter in sort order */
+	void AddSearchResults(const TArray<FOnlineSessionSearchResult>& SearchResults, int32 NumSearchResults);
+
+	/** Whether Entry passes the map filter */
+	bool PassesFilter(const FServerEntry& Entry) const;
+
+	/** Whether A is listed above B with the current sort */
+	bool SortsBefore(const TSharedPtr<FServerEntry>& A, const TSharedPtr<FServerEntry>& B) const;
+
+	/** Sort mode shown in a column header */
+	EColumnSortMode::Type GetColumnSortMode(FName ColumnId) const;
+
+	/** Column header clicked, re-sorts the list */
+	void OnColumnSort(EColumnSortPriority::Type SortPriority, const FName& ColumnId, EColumnSortMode::Type NewSortMode);
+
+	/** Selects the previously selected entry if it is still listed, the first one otherwise */
+	void RestoreSelection();
+
 	/** connect to chosen server */
 	void ConnectToServer();
 
@@ -107,9 +129,18 @@ protected:
 	/** Minimum time between searches (platform dependent) */
 	double MinTimeBetweenSearches;
 
-	/** action bindings array */
+	/** Every search result of the current search, in search result order */
+	TArray< TSharedPtr<FServerEntry> > AllServers;
+
+	/** Entries of AllServers that pass the filter, sorted, the list view's items */
 	TArray< TSharedPtr<FServerEntry> > ServerList;
 
+	/** Column the list is sorted by, Ping or Players */
+	FName SortColumn;
+
+	/** Direction of the sort */
+	EColumnSortMode::Type SortMode;
+
 	/** action bindings list slate widget */
 	TSharedPtr< SListView< TSharedPtr<FServerEntry> > > ServerListWidget; 
 
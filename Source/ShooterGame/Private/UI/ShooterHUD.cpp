@@ -13,6 +13,7 @@
 #include "OnlineSubsystemUtils.h"
 #include "ShooterGameUserSettings.h"
 #include "Performance/LatencyMarkerModule.h"
+#include "ShooterPerfOverlay.h"
 #include <string>
 #include <string>
 #include <string>
@@ -32,6 +33,7 @@ AShooterHUD::AShooterHUD(const FObjectInitializer& ObjectInitializer) : Super(Ob
 	LastEnemyHitTime = -LastEnemyHitDisplayTime;
 
 	TimePassed = 0.0f;
+	NetModeDescTime = -1.0f;
 	LatencyTotal = 0, LatencyGame = 0, LatencyRender = 0, Framerate = 0;
 
 	OnPlayerTalkingStateChangedDelegate = FOnPlayerTalkingStateChangedDelegate::CreateUObject(this, &AShooterHUD::OnPlayerTalkingStateChanged);
@@ -144,6 +146,19 @@ FString AShooterHUD::GetTimeString(float TimeSeconds)
 	return TimeDesc;
 }
 
+const FShooterHUDText& AShooterHUD::UpdateText(FShooterHUDText& Cached, int64 Key, TFunctionRef<FString()> MakeString)
+{
+	if (!Cached.bValid || Cached.Key != Key)
+	{
+		const FString Text = MakeString();
+		Canvas->StrLen(BigFont, Text, Cached.SizeX, Cached.SizeY);
+		Cached.Text = FText::FromString(Text);
+		Cached.Key = Key;
+		Cached.bValid = true;
+	}
+	return Cached;
+}
+
 void AShooterHUD::DrawWeaponHUD()
 {
 	AShooterCharacter* MyPawn = CastChecked<AShooterCharacter>(GetOwningPawn());
@@ -189,27 +204,25 @@ void AShooterHUD::DrawWeaponHUD()
 			Canvas->DrawIcon(MyWeapon->PrimaryIcon, PriWeapPosX, PriWeapPosY, ScaleUI);
 
 			const float TextOffset = 12;
-			float SizeX, SizeY;
 			float TopTextHeight;
-			FString Text = FString::FromInt(MyWeapon->GetCurrentAmmoInClip());
-
-			Canvas->StrLen(BigFont, Text, SizeX, SizeY);
+			const int32 AmmoInClip = MyWeapon->GetCurrentAmmoInClip();
+			const FShooterHUDText& ClipText = UpdateText(PrimaryClipAmmoText, AmmoInClip, [AmmoInClip]() { return FString::FromInt(AmmoInClip); });
 
 			const float TopTextScale = 0.73f; // of 51pt font
-			const float TopTextPosX = Canvas->ClipX - Canvas->OrgX - (PriWeaponBoxWidth + Offset * 2 + (BoxWidth + SizeX * TopTextScale) / 2.0f)  * ScaleUI;
+			const float TopTextPosX = Canvas->ClipX - Canvas->OrgX - (PriWeaponBoxWidth + Offset * 2 + (BoxWidth + ClipText.SizeX * TopTextScale) / 2.0f)  * ScaleUI;
 			const float TopTextPosY = Canvas->ClipY - Canvas->OrgY - (PriWeapOffsetY + PrimaryWeapBg.VL + Offset - TextOffset / 2.0f) * ScaleUI; 
-			TextItem.Text = FText::FromString( Text );
+			TextItem.Text = ClipText.Text;
 			TextItem.Scale = FVector2D( TopTextScale * ScaleUI, TopTextScale * ScaleUI );
 			TextItem.FontRenderInfo = ShadowedFont;
 			Canvas->DrawItem( TextItem, TopTextPosX, TopTextPosY );
-			TopTextHeight = SizeY * TopTextScale;
-			Text = FString::FromInt(MyWeapon->GetCurrentAmmo() - MyWeapon->GetCurrentAmmoInClip());
-			Canvas->StrLen(BigFont, Text, SizeX, SizeY);
+			TopTextHeight = ClipText.SizeY * TopTextScale;
+			const int32 SpareAmmo = MyWeapon->GetCurrentAmmo() - AmmoInClip;
+			const FShooterHUDText& SpareText = UpdateText(PrimarySpareAmmoText, SpareAmmo, [SpareAmmo]() { return FString::FromInt(SpareAmmo); });
 
 			const float BottomTextScale = 0.49f; // of 51pt font
-			const float BottomTextPosX = Canvas->ClipX - Canvas->OrgX - (PriWeaponBoxWidth + Offset * 2 + (BoxWidth + SizeX * BottomTextScale) / 2.0f) * ScaleUI; 
+			const float BottomTextPosX = Canvas->ClipX - Canvas->OrgX - (PriWeaponBoxWidth + Offset * 2 + (BoxWidth + SpareText.SizeX * BottomTextScale) / 2.0f) * ScaleUI; 
 			const float BottomTextPosY = TopTextPosY + (TopTextHeight - 0.8f * TextOffset) * ScaleUI;
-			TextItem.Text = FText::FromString( Text );
+			TextItem.Text = SpareText.Text;
 			TextItem.Scale = FVector2D( BottomTextScale*ScaleUI, BottomTextScale * ScaleUI );
 			TextItem.FontRenderInfo = ShadowedFont;
 			Canvas->DrawItem( TextItem, BottomTextPosX, BottomTextPosY );
@@ -308,19 +321,16 @@ void AShooterHUD::DrawWeaponHUD()
 			Canvas->SetDrawColor(FColor::White);
 			Canvas->DrawIcon(SecondaryWeapon->SecondaryIcon, SecWeapPosX, SecWeapPosY, ScaleUI);
 
-			const float TextOffset = 10;
-			float SizeX, SizeY;
-			float TopTextHeight;
-			FString Text = FString::FromInt(SecondaryWeapon->GetCurrentAmmo());
+			const int32 SecondaryAmmo = SecondaryWeapon->GetCurrentAmmo();
+			const FShooterHUDText& AmmoText = UpdateText(SecondaryAmmoText, SecondaryAmmo, [SecondaryAmmo]() { return FString::FromInt(SecondaryAmmo); });
 
-			Canvas->StrLen(BigFont,Text, SizeX, SizeY);
 			const float TopTextScale = 0.53f; // of 51pt font
-			TopTextHeight = SizeY * TopTextScale;
+			const float TopTextHeight = AmmoText.SizeY * TopTextScale;
 
-			const float TopTextPosX = Canvas->ClipX - Canvas->OrgX - (SecWeaponBoxWidth + Offset * 2 + (SecClipBoxWidth + SizeX * TopTextScale) / 2.0f)  * ScaleUI;
+			const float TopTextPosX = Canvas->ClipX - Canvas->OrgX - (SecWeaponBoxWidth + Offset * 2 + (SecClipBoxWidth + AmmoText.SizeX * TopTextScale) / 2.0f)  * ScaleUI;
 			const float TopTextPosY = SecWeapBgPosY + (SecondaryWeapBg.VL - TopTextHeight) / 2.0f * ScaleUI; 
 
-			TextItem.Text = FText::FromString( Text );
+			TextItem.Text = AmmoText.Text;
 			TextItem.Scale = FVector2D( TopTextScale * ScaleUI, TopTextScale * ScaleUI );
 			Canvas->DrawItem( TextItem, TopTextPosX, TopTextPosY );
 		}
@@ -378,10 +388,8 @@ void AShooterHUD::DrawAbilities()
 	FCanvasTextItem TextItem(FVector2D::ZeroVector, FText::GetEmpty(), BigFont, HUDDark);
 	TextItem.EnableShadow(FLinearColor::Black);
 	float TextScale = 0.57f;
-	FString Text;
 	TextItem.FontRenderInfo = ShadowedFont;
 	TextItem.Scale = FVector2D(TextScale * ScaleUI, TextScale * ScaleUI);
-	FString cooldownText;
 
 	int Ability1Cooldown = (int)MyPawn->CurrentTeleportCooldown;
 	const float Ability1PosX = ((Canvas->ClipX - AbilityReady.UL * ScaleUI) / 2) * 1.5;
@@ -389,13 +397,8 @@ void AShooterHUD::DrawAbilities()
 	Canvas->DrawIcon(AbilityNotReady, Ability1PosX, Ability1PosY, ScaleUI);
 	if (Ability1Cooldown < 1) {
 		Canvas->DrawIcon(AbilityReady, Ability1PosX, Ability1PosY, ScaleUI);
-		cooldownText = "T";
-		TextItem.Text = FText::FromString(cooldownText);
-	}
-	else {
-		cooldownText = FString::FromInt(Ability1Cooldown);
-		TextItem.Text = FText::FromString(cooldownText);
 	}
+	TextItem.Text = UpdateText(TeleportCooldownText, FMath::Max(Ability1Cooldown, 0), [Ability1Cooldown]() { return Ability1Cooldown < 1 ? FString(TEXT("T")) : FString::FromInt(Ability1Cooldown); }).Text;
 	Canvas->DrawIcon(TeleportIcon, Ability1PosX + Offset * ScaleUI, Ability1PosY + (AbilityReady.VL - TimerIcon.VL) / 2.0f * ScaleUI, ScaleUI);
 	 float AbilityTextPosX = (Ability1PosX + Offset * ScaleUI) * 1.03;
 	 float AbilityTextPosY = (Ability1PosY + (AbilityReady.VL - TimerIcon.VL) / 2.0f * ScaleUI) / 1.005;
@@ -409,13 +412,8 @@ void AShooterHUD::DrawAbilities()
 	Canvas->DrawIcon(AbilityNotReady, Ability2PosX, Ability2PosY, ScaleUI);
 	if (Ability2Cooldown < 1) {
 		Canvas->DrawIcon(AbilityReady, Ability2PosX, Ability2PosY, ScaleUI);
-		cooldownText = "E";
-		TextItem.Text = FText::FromString(cooldownText);
-	}
-	else {
-		cooldownText = FString::FromInt(Ability2Cooldown);
-		TextItem.Text = FText::FromString(cooldownText);
 	}
+	TextItem.Text = UpdateText(TimeRewindCooldownText, FMath::Max(Ability2Cooldown, 0), [Ability2Cooldown]() { return Ability2Cooldown < 1 ? FString(TEXT("E")) : FString::FromInt(Ability2Cooldown); }).Text;
 	Canvas->DrawIcon(TimerIcon, Ability2PosX + Offset * ScaleUI, Ability2PosY + (AbilityReady.VL - TimerIcon.VL) / 2.0f * ScaleUI, ScaleUI);
 	AbilityTextPosX = (Ability2PosX + Offset * ScaleUI) * 1.03;
 	AbilityTextPosY = (Ability2PosY + (AbilityReady.VL - TimerIcon.VL) / 2.0f * ScaleUI) / 1.005;
@@ -500,81 +498,89 @@ void AShooterHUD::DrawMatchTimerAndPosition()
 	{
 		FCanvasTextItem TextItem( FVector2D::ZeroVector, FText::GetEmpty(), BigFont, HUDDark );
 		TextItem.EnableShadow( FLinearColor::Black );
-		float SizeX, SizeY;
 		float TextScale = 0.57f;
-		FString Text;
 		TextItem.FontRenderInfo = ShadowedFont;
 		TextItem.Scale = FVector2D( TextScale*ScaleUI, TextScale*ScaleUI );
+		const int32 RemainingTime = MyGameState->RemainingTime;
 		if (MyGameState->GetMatchState() == MatchState::WaitingToStart)
 		{
 			TextItem.Scale = FVector2D( ScaleUI, ScaleUI );
-			Text = LOCTEXT("WarmupString","MATCH STARTS IN: ").ToString() + FString::FromInt(MyGameState->RemainingTime);
 			TextItem.SetColor( HUDLight );
-			TextItem.Text = FText::FromString( Text );			
+			TextItem.Text = UpdateText(WarmupText, RemainingTime, [RemainingTime]() { return LOCTEXT("WarmupString","MATCH STARTS IN: ").ToString() + FString::FromInt(RemainingTime); }).Text;
 			AddMatchInfoString(TextItem);
 		}
 		else if (MyGameState->GetMatchState() == MatchState::InProgress)
 		{
-			Text = GetTimeString(MyGameState->RemainingTime);
-			Canvas->StrLen(BigFont, Text, SizeX, SizeY);
+			const FShooterHUDText& TimerText = UpdateText(MatchTimerText, RemainingTime, [this, RemainingTime]() { return GetTimeString(RemainingTime); });
 
 			TextItem.SetColor( HUDDark );
-			TextItem.Text = FText::FromString( Text );
+			TextItem.Text = TimerText.Text;
 			TextItem.Position = FVector2D( TimerPosX + Offset * 1.5f * ScaleUI + TimerIcon.UL * ScaleUI,
-				TimerPosY + (TimePlaceBg.VL * ScaleUI - SizeY * TextScale * ScaleUI) / 2 );
+				TimerPosY + (TimePlaceBg.VL * ScaleUI - TimerText.SizeY * TextScale * ScaleUI) / 2 );
 			Canvas->DrawItem(TextItem);
 		}
 
 		float BoxWidth = 45.0f * ScaleUI;
-		Text = FString();
 		AShooterPlayerController* MyPC = Cast<AShooterPlayerController>(PlayerOwner);
 		if (MyPC && MyGameState && MatchState == EShooterMatchState::Playing)
 		{
 			AShooterPlayerState* MyPlayerState = Cast<AShooterPlayerState>(MyPC->PlayerState);
 			if (MyPlayerState)
 			{
-				if (MyGameState->NumTeams > 1) // team based game
+				// The place only changes with scores, teams and players, which all bump the ranked map version
+				uint32 PlaceKey = HashCombine(MyGameState->GetRankedMapVersion(), GetTypeHash(MyPlayerState));
+				for (int32 TeamScore : MyGameState->TeamScores)
 				{
-					int32 MyTeam = MyPlayerState->GetTeamNum();
-					int32 MyPos = FMath::Max(1, MyGameState->TeamScores.Num());
-					for (int32 i=0; i < MyGameState->TeamScores.Num(); i++)
+					PlaceKey = HashCombine(PlaceKey, GetTypeHash(TeamScore));
+				}
+
+				const FShooterHUDText& Place = UpdateText(PlaceText, PlaceKey, [MyGameState, MyPlayerState]()
+				{
+					FString Text;
+					if (MyGameState->NumTeams > 1) // team based game
 					{
-						if (MyGameState->TeamScores.Num() > MyTeam &&
-							MyGameState->TeamScores[MyTeam] >= MyGameState->TeamScores[i] && MyTeam != i)
+						int32 MyTeam = MyPlayerState->GetTeamNum();
+						int32 MyPos = FMath::Max(1, MyGameState->TeamScores.Num());
+						for (int32 i=0; i < MyGameState->TeamScores.Num(); i++)
+						{
+							if (MyGameState->TeamScores.Num() > MyTeam &&
+								MyGameState->TeamScores[MyTeam] >= MyGameState->TeamScores[i] && MyTeam != i)
+							{
+								MyPos--;
+							}
+						}
+						int32 NumTeams = 0;
+						for (int32 i=0; i < MyGameState->NumTeams; i++)
 						{
-							MyPos--;
+							RankedPlayerMap PlayerStateMap;
+							MyGameState->GetRankedMap(i,PlayerStateMap);
+							if(PlayerStateMap.Num() > 0)
+							{
+								NumTeams++;
+							}
 						}
+						Text = FString::Printf(TEXT("%d/%d"), MyPos, NumTeams);
 					}
-					int32 NumTeams = 0;
-					for (int32 i=0; i < MyGameState->NumTeams; i++)
+					else // free for all
 					{
 						RankedPlayerMap PlayerStateMap;
-						MyGameState->GetRankedMap(i,PlayerStateMap);
-						if(PlayerStateMap.Num() > 0)
-						{
-							NumTeams++;
-						}
+						MyGameState->GetRankedMap(0,PlayerStateMap);
+						const int32* MyRank = PlayerStateMap.FindKey(MyPlayerState);
+						int32 MyPos = MyRank ? *MyRank + 1 : 0;
+						Text = FString::Printf(TEXT("%d/%d"), MyPos, PlayerStateMap.Num());
 					}
-					Text = FString::Printf(TEXT("%d/%d"), MyPos, NumTeams);
-				}
-				else // free for all
-				{
-					RankedPlayerMap PlayerStateMap;
-					MyGameState->GetRankedMap(0,PlayerStateMap);
-					const int32* MyRank = PlayerStateMap.FindKey(MyPlayerState);
-					int32 MyPos = MyRank ? *MyRank + 1 : 0;
-					Text = FString::Printf(TEXT("%d/%d"), MyPos, PlayerStateMap.Num());
-				}
-				Canvas->StrLen(BigFont, Text, SizeX, SizeY);
+					return Text;
+				});
+
 				Canvas->DrawIcon(PlaceIcon,
-					Canvas->ClipX - Canvas->OrgX - BoxWidth  - (SizeX * TextScale + PlaceIcon.UL + Offset/4) * ScaleUI,
+					Canvas->ClipX - Canvas->OrgX - BoxWidth  - (Place.SizeX * TextScale + PlaceIcon.UL + Offset/4) * ScaleUI,
 					TimerPosY + (TimePlaceBg.VL - PlaceIcon.VL) / 2.0f * ScaleUI, ScaleUI);
 
-				TextItem.Text = FText::FromString( Text);
+				TextItem.Text = Place.Text;
 				TextItem.Scale = FVector2D(TextScale*ScaleUI, TextScale*ScaleUI);
 				TextItem.FontRenderInfo = ShadowedFont;
-				Canvas->DrawItem( TextItem, Canvas->ClipX - Canvas->OrgX - (BoxWidth  + SizeX * TextScale * ScaleUI),
-					TimerPosY + (TimePlaceBg.VL * ScaleUI - SizeY * TextScale * ScaleUI) / 2 );
+				Canvas->DrawItem( TextItem, Canvas->ClipX - Canvas->OrgX - (BoxWidth  + Place.SizeX * TextScale * ScaleUI),
+					TimerPosY + (TimePlaceBg.VL * ScaleUI - Place.SizeY * TextScale * ScaleUI) / 2 );
 			}
 		}
 	}
@@ -598,32 +604,24 @@ void AShooterHUD::DrawKills()
 	FCanvasTextItem TextItem( FVector2D::ZeroVector, FText::GetEmpty(), BigFont, HUDDark );
 	TextItem.EnableShadow( FLinearColor::Black );
 
-	float SizeX, SizeY;
-	FString Text = LOCTEXT("Kills", "KILLS:").ToString();
-	Canvas->StrLen(BigFont, Text, SizeX, SizeY);
+	const FShooterHUDText& Label = UpdateText(KillsLabelText, 0, []() { return LOCTEXT("Kills", "KILLS:").ToString(); });
 
-	TextItem.Text = FText::FromString( Text );
+	TextItem.Text = Label.Text;
 	TextItem.Scale = FVector2D( TextScale * ScaleUI, TextScale * ScaleUI );
 	TextItem.FontRenderInfo = ShadowedFont;
 	TextItem.SetColor(HUDDark);
 	Canvas->DrawItem( TextItem, KillsPosX + Offset * ScaleUI + KillsIcon.UL * 1.5f * ScaleUI,
-		KillsPosY + (KillsBg.VL * ScaleUI - SizeY * TextScale * ScaleUI) / 2 );
+		KillsPosY + (KillsBg.VL * ScaleUI - Label.SizeY * TextScale * ScaleUI) / 2 );
+
+	const int32 NumKills = MyPlayerState->GetKills();
+	const FShooterHUDText& Kills = UpdateText(KillsText, NumKills, [NumKills]() { return FString::FromInt(NumKills); });
 
-	if (MyPlayerState)
-	{
-		Text = FString::FromInt(MyPlayerState->GetKills());
-	}
-	else 
-	{
-		Text = FString("0");
-	}
 	TextScale = 0.88f;
 	float BoxWidth = 135.0f * ScaleUI;
-	Canvas->StrLen(BigFont, Text, SizeX, SizeY);
-	TextItem.Text = FText::FromString( Text );
+	TextItem.Text = Kills.Text;
 	TextItem.Scale = FVector2D( TextScale * ScaleUI, TextScale * ScaleUI );
-	Canvas->DrawItem( TextItem, KillsPosX + KillsBg.UL * ScaleUI - (BoxWidth + SizeX * TextScale * ScaleUI) /2,
-		KillsPosY + (KillsBg.VL* ScaleUI - SizeY * TextScale * ScaleUI) / 2 );
+	Canvas->DrawItem( TextItem, KillsPosX + KillsBg.UL * ScaleUI - (BoxWidth + Kills.SizeX * TextScale * ScaleUI) /2,
+		KillsPosY + (KillsBg.VL* ScaleUI - Kills.SizeY * TextScale * ScaleUI) / 2 );
 
 }
 
@@ -639,6 +637,8 @@ void AShooterHUD::NotifyEnemyHit()
 
 void AShooterHUD::DrawHUD()
 {
+	QUICK_SCOPE_CYCLE_COUNTER(AShooterHUD_DrawHUD);
+
 	Super::DrawHUD();
 	if (Canvas == nullptr)
 	{
@@ -666,8 +666,8 @@ void AShooterHUD::DrawHUD()
 	}
 
 
-	// Empty the info item array
-	InfoItems.Empty();
+	// Empty the info item array, keeping its memory for the next frame
+	InfoItems.Reset();
 	float TextScale = 1.0f;
 	// enforce min
 	ScaleUI = FMath::Max(ScaleUI, MinHudScale);
@@ -690,10 +690,12 @@ void AShooterHUD::DrawHUD()
 		Canvas->ApplySafeZoneTransform();
 	}
 
-	// net mode
-	if (GetNetMode() != NM_Standalone)
+	// net mode, the session rarely changes so the description is only rebuilt once a second
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+	if (GetNetMode() != NM_Standalone && (NetModeDesc.IsEmpty() || CurrentTime - NetModeDescTime >= 1.0f || CurrentTime < NetModeDescTime))
 	{
-		FString NetModeDesc = (GetNetMode() == NM_Client) ? TEXT("Client") : TEXT("Server");
+		NetModeDescTime = CurrentTime;
+		NetModeDesc = (GetNetMode() == NM_Client) ? TEXT("Client") : TEXT("Server");
 		IOnlineSubsystem * OnlineSubsystem = Online::GetSubsystem(GetWorld());
 		if(OnlineSubsystem)
 		{
@@ -711,13 +713,25 @@ void AShooterHUD::DrawHUD()
 		}
 
 		NetModeDesc += FString::Printf( TEXT( "\nVersion: %i, %s, %s" ), FNetworkVersion::GetNetworkCompatibleChangelist(), UTF8_TO_TCHAR(__DATE__), UTF8_TO_TCHAR(__TIME__) );
+	}
 
+	if (GetNetMode() != NM_Standalone)
+	{
 		DrawDebugInfoString(NetModeDesc, Canvas->OrgX + Offset*ScaleUI, Canvas->OrgY + 5*Offset*ScaleUI, true, true, HUDLight);
 	}
 
 	DrawNVIDIAReflexTimers();
 	DrawMatchTimerAndPosition();
 
+	if (PerfOverlay.IsValid() && PlayerOwner && (PerfOverlay->IsVisible() || PerfOverlay->IsCapturing()))
+	{
+		PerfOverlay->Tick(PlayerOwner, GetWorld()->GetDeltaSeconds());
+		if (PerfOverlay->IsVisible())
+		{
+			PerfOverlay->Draw(Canvas, NormalFont, ScaleUI);
+		}
+	}
+
 	float MessageOffset = (Canvas->ClipY / 4.0)* ScaleUI;
 	if (MatchState == EShooterMatchState::Playing)
 	{
@@ -736,10 +750,9 @@ void AShooterHUD::DrawHUD()
 		else
 		{
 			// respawn
-			FString Text = LOCTEXT("WaitingForRespawn", "WAITING FOR RESPAWN").ToString();
 			FCanvasTextItem TextItem( FVector2D::ZeroVector, FText::GetEmpty(), BigFont, HUDDark );
 			TextItem.EnableShadow( FLinearColor::Black );
-			TextItem.Text = FText::FromString( Text );
+			TextItem.Text = LOCTEXT("WaitingForRespawn", "WAITING FOR RESPAWN");
 			TextItem.Scale = FVector2D( TextScale * ScaleUI, TextScale * ScaleUI );
 			TextItem.FontRenderInfo = ShadowedFont;
 			TextItem.SetColor(HUDLight);
@@ -754,17 +767,13 @@ void AShooterHUD::DrawHUD()
 		MessageOffset = DrawRecentlyKilledPlayer();
 
 		// No ammo message if required
-		const float CurrentTime = GetWorld()->GetTimeSeconds();
 		if (CurrentTime - NoAmmoNotifyTime >= 0 && CurrentTime - NoAmmoNotifyTime <= NoAmmoFadeOutTime)
 		{
-			FString Text = FString();
-
 			const float Alpha = FMath::Min(1.0f, 1 - (CurrentTime - NoAmmoNotifyTime) / NoAmmoFadeOutTime);
-			Text = LOCTEXT("NoAmmo", "NO AMMO").ToString();
 			
 			FCanvasTextItem TextItem( FVector2D::ZeroVector, FText::GetEmpty(), BigFont, HUDDark );
 			TextItem.EnableShadow( FLinearColor::Black );
-			TextItem.Text = FText::FromString( Text );
+			TextItem.Text = LOCTEXT("NoAmmo", "NO AMMO");
 			TextItem.Scale = FVector2D( TextScale * ScaleUI, TextScale * ScaleUI );
 			TextItem.FontRenderInfo = ShadowedFont;
 			TextItem.SetColor(FLinearColor(0.75f, 0.125f, 0.125f, Alpha ));
@@ -1171,6 +1180,29 @@ void AShooterHUD::ToggleScoreboard()
 	ShowScoreboard(!bIsScoreBoardVisible);
 }
 
+void AShooterHUD::TogglePerfOverlay()
+{
+	if (!PerfOverlay.IsValid())
+	{
+		PerfOverlay = MakeShareable(new FShooterPerfOverlay());
+	}
+	PerfOverlay->SetVisible(!PerfOverlay->IsVisible());
+}
+
+void AShooterHUD::StartPerfCapture(float Seconds)
+{
+	if (!PerfOverlay.IsValid())
+	{
+		PerfOverlay = MakeShareable(new FShooterPerfOverlay());
+	}
+	PerfOverlay->StartCapture(Seconds);
+
+	if (PlayerOwner)
+	{
+		PlayerOwner->ClientMessage(FString::Printf(TEXT("Perf capture: recording %.0f seconds"), Seconds));
+	}
+}
+
 bool AShooterHUD::ShowScoreboard(bool bEnable, bool bFocus)
 {
 	if( bIsScoreBoardVisible == bEnable)
@@ -0,0 +1,217 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterPerfOverlay.h"
+#include "Player/ShooterCharacterMovement.h"
+#include "Engine/Canvas.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Misc/FileHelper.h"
+
+static int32 ShooterPerfOverlayHistory = 120;
+static FAutoConsoleVariableRef CVarShooterPerfOverlayHistory(
+	TEXT("ShooterGame.PerfOverlay.History"),
+	ShooterPerfOverlayHistory,
+	TEXT("Number of frames shown in each graph of the performance overlay."),
+	ECVF_Default);
+
+namespace ShooterPerfOverlay
+{
+	static const TCHAR* StatNames[] =
+	{
+		TEXT("Frame ms"),
+		TEXT("Game thread ms"),
+		TEXT("Render thread ms"),
+		TEXT("Ping ms"),
+		TEXT("Packet loss %"),
+		TEXT("Corrections"),
+		TEXT("Replicated actors"),
+	};
+
+	static const FColor StatColors[] =
+	{
+		FColor(255, 255, 255),
+		FColor(110, 200, 255),
+		FColor(255, 170, 90),
+		FColor(120, 255, 120),
+		FColor(255, 90, 90),
+		FColor(255, 230, 80),
+		FColor(200, 140, 255),
+	};
+}
+
+FShooterPerfOverlay::FShooterPerfOverlay()
+	: bVisible(false)
+	, CaptureTimeLeft(0.f)
+	, CaptureTime(0.f)
+	, LastNumCorrections(0)
+{
+}
+
+int32 FShooterPerfOverlay::GetNewCorrections(APlayerController* PC)
+{
+	const ACharacter* Character = Cast<ACharacter>(PC->GetPawn());
+	UShooterCharacterMovement* Movement = Character ? Cast<UShooterCharacterMovement>(Character->GetCharacterMovement()) : nullptr;
+	if (Movement == nullptr)
+	{
+		LastMovement = nullptr;
+		return 0;
+	}
+
+	const int32 NumCorrections = Movement->GetNumClientCorrections();
+	const int32 NewCorrections = (Movement == LastMovement.Get()) ? NumCorrections - LastNumCorrections : 0;
+	LastMovement = Movement;
+	LastNumCorrections = NumCorrections;
+	return NewCorrections;
+}
+
+void FShooterPerfOverlay::Tick(APlayerController* PC, float DeltaSeconds)
+{
+	float Values[Stat_Num];
+	Values[Stat_Frame] = DeltaSeconds * 1000.f;
+	Values[Stat_GameThread] = FPlatformTime::ToMilliseconds(GGameThreadTime);
+	Values[Stat_RenderThread] = FPlatformTime::ToMilliseconds(GRenderThreadTime);
+	Values[Stat_Ping] = 0.f;
+	Values[Stat_PacketLoss] = 0.f;
+	Values[Stat_Corrections] = GetNewCorrections(PC);
+	Values[Stat_ReplicatedActors] = 0.f;
+
+	// A listen server's local player has no connection, nothing to report for it but the actors it replicates
+	UNetConnection* Connection = PC->GetNetConnection();
+	if (Connection)
+	{
+		Values[Stat_Ping] = Connection->AvgLag * 1000.f;
+
+		const int32 NumPackets = Connection->InPackets + Connection->InPacketsLost;
+		Values[Stat_PacketLoss] = NumPackets > 0 ? 100.f * Connection->InPacketsLost / NumPackets : 0.f;
+	}
+
+	UNetDriver* NetDriver = PC->GetWorld()->GetNetDriver();
+	if (NetDriver && NetDriver->ServerConnection)
+	{
+		Values[Stat_ReplicatedActors] = NetDriver->ServerConnection->ActorChannelsNum();
+	}
+	else if (NetDriver)
+	{
+		Values[Stat_ReplicatedActors] = NetDriver->GetNetworkObjectList().GetActiveObjects().Num();
+	}
+
+	const int32 HistorySize = FMath::Max(ShooterPerfOverlayHistory, 2);
+	for (int32 Stat = 0; Stat < Stat_Num; ++Stat)
+	{
+		FStatHistory& StatHistory = History[Stat];
+		if (StatHistory.Samples.Num() != HistorySize)
+		{
+			StatHistory.Samples.SetNumZeroed(HistorySize);
+			StatHistory.NextSample = 0;
+			StatHistory.NumSamples = 0;
+		}
+
+		StatHistory.Samples[StatHistory.NextSample] = Values[Stat];
+		StatHistory.NextSample = (StatHistory.NextSample + 1) % HistorySize;
+		StatHistory.NumSamples = FMath::Min(StatHistory.NumSamples + 1, HistorySize);
+	}
+
+	if (IsCapturing())
+	{
+		CaptureTime += DeltaSeconds;
+		CaptureRows.Add(FString::Printf(TEXT("%.3f,%.3f,%.3f,%.3f,%.1f,%.1f,%d,%d"),
+			CaptureTime, Values[Stat_Frame], Values[Stat_GameThread], Values[Stat_RenderThread], Values[Stat_Ping], Values[Stat_PacketLoss],
+			(int32)Values[Stat_Corrections], (int32)Values[Stat_ReplicatedActors]));
+
+		CaptureTimeLeft -= DeltaSeconds;
+		if (CaptureTimeLeft <= 0.f)
+		{
+			FinishCapture(PC);
+		}
+	}
+}
+
+void FShooterPerfOverlay::Draw(UCanvas* Canvas, UFont* Font, float ScaleUI) const
+{
+	const float GraphWidth = 240.f * ScaleUI;
+	const float GraphHeight = 40.f * ScaleUI;
+	const float Padding = 4.f * ScaleUI;
+	const float PosX = Canvas->OrgX + Canvas->ClipX - GraphWidth - 20.f * ScaleUI;
+	float PosY = Canvas->OrgY + 120.f * ScaleUI;
+
+	float LabelSizeX, LabelSizeY;
+	Canvas->StrLen(Font, TEXT("0"), LabelSizeX, LabelSizeY);
+	LabelSizeY *= ScaleUI;
+
+	for (int32 Stat = 0; Stat < Stat_Num; ++Stat)
+	{
+		const FStatHistory& StatHistory = History[Stat];
+		const int32 HistorySize = StatHistory.Samples.Num();
+		if (StatHistory.NumSamples == 0)
+		{
+			continue;
+		}
+
+		float MaxValue = 0.f;
+		float TotalValue = 0.f;
+		for (int32 i = 0; i < StatHistory.NumSamples; ++i)
+		{
+			const float Value = StatHistory.Samples[(StatHistory.NextSample - 1 - i + HistorySize) % HistorySize];
+			MaxValue = FMath::Max(MaxValue, Value);
+			TotalValue += Value;
+		}
+		const float CurrentValue = StatHistory.Samples[(StatHistory.NextSample - 1 + HistorySize) % HistorySize];
+
+		// Background
+		FCanvasTileItem TileItem(FVector2D(PosX - Padding, PosY - Padding), FVector2D(GraphWidth + 2.f * Padding, LabelSizeY + GraphHeight + 2.f * Padding), FColor(0, 0, 0, 128));
+		TileItem.BlendMode = SE_BLEND_Translucent;
+		Canvas->DrawItem(TileItem);
+
+		// Label, with the current, average and max values over the window
+		FCanvasTextItem TextItem(FVector2D(PosX, PosY), FText::FromString(FString::Printf(TEXT("%s %.1f (avg %.1f, max %.1f)"),
+			ShooterPerfOverlay::StatNames[Stat], CurrentValue, TotalValue / StatHistory.NumSamples, MaxValue)), Font, ShooterPerfOverlay::StatColors[Stat]);
+		TextItem.Scale = FVector2D(ScaleUI, ScaleUI);
+		Canvas->DrawItem(TextItem);
+
+		// One bar per frame, oldest on the left, scaled to the max in the window
+		const float BarWidth = GraphWidth / HistorySize;
+		const float GraphBottom = PosY + LabelSizeY + GraphHeight;
+		for (int32 i = 0; i < StatHistory.NumSamples; ++i)
+		{
+			const float Value = StatHistory.Samples[(StatHistory.NextSample - StatHistory.NumSamples + i + HistorySize) % HistorySize];
+			const float BarHeight = MaxValue > 0.f ? GraphHeight * Value / MaxValue : 0.f;
+			if (BarHeight > 0.f)
+			{
+				FCanvasTileItem BarItem(FVector2D(PosX + (HistorySize - StatHistory.NumSamples + i) * BarWidth, GraphBottom - BarHeight), FVector2D(FMath::Max(BarWidth, 1.f), BarHeight), ShooterPerfOverlay::StatColors[Stat]);
+				Canvas->DrawItem(BarItem);
+			}
+		}
+
+		PosY += LabelSizeY + GraphHeight + 3.f * Padding;
+	}
+}
+
+void FShooterPerfOverlay::StartCapture(float Seconds)
+{
+	CaptureTimeLeft = Seconds;
+	CaptureTime = 0.f;
+	CaptureRows.Reset();
+}
+
+void FShooterPerfOverlay::FinishCapture(APlayerController* PC)
+{
+	CaptureTimeLeft = 0.f;
+
+	const FString Filename = FPaths::ProfilingDir() / TEXT("PerfCapture") / FString::Printf(TEXT("PerfCapture-%s.csv"), *FDateTime::Now().ToString());
+	CaptureRows.Insert(TEXT("Time,FrameMs,GameThreadMs,RenderThreadMs,PingMs,PacketLossPct,Corrections,ReplicatedActors"), 0);
+
+	FString Message;
+	if (FFileHelper::SaveStringArrayToFile(CaptureRows, *Filename))
+	{
+		Message = FString::Printf(TEXT("Perf capture: %d frames written to %s"), CaptureRows.Num() - 1, *FPaths::ConvertRelativePathToFull(Filename));
+		UE_LOG(LogShooter, Log, TEXT("%s"), *Message);
+	}
+	else
+	{
+		Message = FString::Printf(TEXT("Perf capture: failed to write %s"), *Filename);
+		UE_LOG(LogShooter, Warning, TEXT("%s"), *Message);
+	}
+
+	PC->ClientMessage(Message);
+	CaptureRows.Empty();
+}
@@ -0,0 +1,71 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ShooterGame.h"
+
+/**
+ * In-game performance overlay drawn by AShooterHUD, toggled with the PerfOverlay console command.
+ * Keeps a rolling history of frame, game thread and render thread time, ping, packet loss, movement corrections
+ * and replicated actors, and draws each one as a bar graph.
+ * PerfCapture <Seconds> writes every frame's sample to Saved/Profiling/PerfCapture/ as CSV, overlay shown or not.
+ */
+class FShooterPerfOverlay
+{
+public:
+	FShooterPerfOverlay();
+
+	/** Records this frame's sample, should be called once per frame while visible or capturing */
+	void Tick(APlayerController* PC, float DeltaSeconds);
+
+	/** Draws the graphs down the right edge of the canvas */
+	void Draw(UCanvas* Canvas, UFont* Font, float ScaleUI) const;
+
+	/** Starts writing samples to a CSV for Seconds, replacing any capture in progress */
+	void StartCapture(float Seconds);
+
+	bool IsCapturing() const { return CaptureTimeLeft > 0.f; }
+
+	bool IsVisible() const { return bVisible; }
+	void SetVisible(bool bInVisible) { bVisible = bInVisible; }
+
+private:
+	enum EStat
+	{
+		Stat_Frame,
+		Stat_GameThread,
+		Stat_RenderThread,
+		Stat_Ping,
+		Stat_PacketLoss,
+		Stat_Corrections,
+		Stat_ReplicatedActors,
+		Stat_Num
+	};
+
+	/** Rolling window of one stat */
+	struct FStatHistory
+	{
+		TArray<float> Samples;
+		int32 NextSample = 0;
+		int32 NumSamples = 0;
+	};
+
+	/** Writes the capture and tells PC where it went */
+	void FinishCapture(APlayerController* PC);
+
+	/** Movement corrections received by PC's pawn since the last sample */
+	int32 GetNewCorrections(APlayerController* PC);
+
+	FStatHistory History[Stat_Num];
+
+	bool bVisible;
+
+	/** Capture in progress */
+	float CaptureTimeLeft;
+	float CaptureTime;
+	TArray<FString> CaptureRows;
+
+	/** Movement component and correction count at the last sample */
+	TWeakObjectPtr<class UShooterCharacterMovement> LastMovement;
+	int32 LastNumCorrections;
+};
@@ -9,6 +9,13 @@
 #define CHAT_BOX_HEIGHT 192.0f
 #define CHAT_BOX_PADDING 20.0f
 
+static int32 ShooterChatMaxLines = 100;
+static FAutoConsoleVariableRef CVarShooterChatMaxLines(
+	TEXT("ShooterGame.Chat.MaxLines"),
+	ShooterChatMaxLines,
+	TEXT("Number of chat lines kept in the chat history, older lines are dropped."),
+	ECVF_Default);
+
 void SChatWidget::Construct(const FArguments& InArgs, const FLocalPlayerContext& InContext)
 {
 	ShooterHUDPCTrackerBase::Init(InContext);
@@ -111,20 +118,43 @@ FSlateColor SChatWidget::GetStyleColor( const FLinearColor& InColor ) const
 
 void SChatWidget::AddChatLine(const FText& ChatString, bool SetFocus)
 {
-	ChatHistory.Add(MakeShareable(new FChatLine(ChatString)));
-
-	if(ChatHistoryListView.IsValid())
+	// The widget is only ticked while visible, keep the pending lines bounded too
+	if (PendingChatLines.Num() >= FMath::Max(ShooterChatMaxLines, 1))
 	{
-		FChatLine* LastLine  = ChatHistory[ChatHistory.Num() - 1].Get();
-		UE_LOG(LogOnline, Warning, TEXT("request scroll last=%s"), *LastLine->ChatString.ToString());
-		ChatHistoryListView->RequestScrollIntoView(ChatHistory[ChatHistory.Num() - 1]);
+		PendingChatLines.RemoveAt(0, 1, false);
 	}
-	
-	FSlateApplication::Get().PlaySound(ChatStyle->RxMessgeSound);
+	PendingChatLines.Add(MakeShareable(new FChatLine(ChatString)));
+
 	SetEntryVisibility( EVisibility::Visible );
 	bVisibiltyNeedsFocus = SetFocus;
 }
 
+void SChatWidget::FlushPendingChatLines()
+{
+	if (PendingChatLines.Num() == 0)
+	{
+		return;
+	}
+
+	ChatHistory.Append(PendingChatLines);
+	PendingChatLines.Reset();
+
+	const int32 NumToDrop = ChatHistory.Num() - FMath::Max(ShooterChatMaxLines, 1);
+	if (NumToDrop > 0)
+	{
+		ChatHistory.RemoveAt(0, NumToDrop, false);
+	}
+
+	// One list refresh and one sound for everything that came in this frame
+	if (ChatHistoryListView.IsValid())
+	{
+		ChatHistoryListView->RequestListRefresh();
+		ChatHistoryListView->RequestScrollIntoView(ChatHistory.Last());
+	}
+
+	FSlateApplication::Get().PlaySound(ChatStyle->RxMessgeSound);
+}
+
 EVisibility SChatWidget::GetEntryVisibility() const
 {
 	return ChatEditBox->GetVisibility();
@@ -178,6 +208,8 @@ void SChatWidget::Tick( const FGeometry& AllottedGeometry, const double InCurren
 	// Always tick the super.
 	SCompoundWidget::Tick( AllottedGeometry, InCurrentTime, InDeltaTime );
 
+	FlushPendingChatLines();
+
 	// If we have not got the keep visible flag set, and the fade time has expired hide the widget
 	const double CurrentTime = FSlateApplication::Get().GetCurrentTime();
 	if( ( bAlwaysVisible == false ) && ( CurrentTime > ( LastChatLineTime + ChatFadeTime ) ) )
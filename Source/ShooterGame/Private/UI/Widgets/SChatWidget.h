@@ -40,7 +40,7 @@ public:
 	void SetEntryVisibility( TAttribute<EVisibility> InVisibility );
 
 	/** 
-	 * Add a new chat line.
+	 * Add a new chat line. Lines are added to the list once per frame, however many arrive.
 	 *
 	 * @param	ChatString		String to add.
 	 * @param	SetFocus		Should the window be given focus
@@ -94,6 +94,9 @@ protected:
 
 	TSharedRef<ITableRow> GenerateChatRow(TSharedPtr<FChatLine> ChatLine, const TSharedRef<STableViewBase>& OwnerTable);
 
+	/** Moves the lines received since the last frame to the history, dropping the oldest lines over ShooterGame.Chat.MaxLines */
+	void FlushPendingChatLines();
+
 	/** Visibility of the entry widget previous frame. */
 	EVisibility LastVisibility;
 	
@@ -112,9 +115,12 @@ protected:
 	/** The chat history list view. */
 	TSharedPtr< SListView< TSharedPtr< FChatLine> > > ChatHistoryListView;
 
-	/** The array of chat history. */
+	/** The array of chat history, oldest first. */
 	TArray< TSharedPtr< FChatLine> > ChatHistory;
 
+	/** Lines received this frame, not yet in ChatHistory. */
+	TArray< TSharedPtr< FChatLine> > PendingChatLines;
+
 	/** Should this chatbox be kept visible. */
 	uint32 bAlwaysVisible : 1;
 
@@ -30,6 +30,14 @@ private:
 	/** Jumps the replay to the time on the bar that was clicked */
 	FReply OnTimelineClicked(const FGeometry& Geometry, const FPointerEvent& Event);
 
+	/** Logs how long the seek took */
+	void OnGotoTimeComplete(bool bWasSuccessful, double StartTime, float TargetTime);
+
+	/** Seek latency stats, for the log */
+	int32 NumSeeks;
+	double TotalSeekMs;
+	double MaxSeekMs;
+
 	/** The demo net driver underlying the current replay */
 	TWeakObjectPtr<UDemoNetDriver> DemoDriver;
 
@@ -45,6 +53,9 @@ void SShooterReplayTimeline::Construct(const FArguments& InArgs)
 	DemoDriver = InArgs._DemoDriver;
 	BackgroundBrush = InArgs._BackgroundBrush;
 	IndicatorBrush = InArgs._IndicatorBrush;
+	NumSeeks = 0;
+	TotalSeekMs = 0.0;
+	MaxSeekMs = 0.0;
 
 	ChildSlot
 	.Padding(InArgs._BackgroundPadding)
@@ -114,7 +125,8 @@ FReply SShooterReplayTimeline::OnTimelineClicked(const FGeometry& Geometry, cons
 
 		const float TimelinePercentage = LocalPos.X / Geometry.GetLocalSize().X;
 
-		DemoDriver->GotoTimeInSeconds( TimelinePercentage * DemoDriver->GetDemoTotalTime() );
+		const float TargetTime = TimelinePercentage * DemoDriver->GetDemoTotalTime();
+		DemoDriver->GotoTimeInSeconds( TargetTime, FOnGotoTimeDelegate::CreateSP(this, &SShooterReplayTimeline::OnGotoTimeComplete, FPlatformTime::Seconds(), TargetTime) );
 
 		return FReply::Handled();
 	}
@@ -122,6 +134,22 @@ FReply SShooterReplayTimeline::OnTimelineClicked(const FGeometry& Geometry, cons
 	return FReply::Unhandled();
 }
 
+void SShooterReplayTimeline::OnGotoTimeComplete(bool bWasSuccessful, double StartTime, float TargetTime)
+{
+	if (!bWasSuccessful)
+	{
+		UE_LOG(LogShooter, Warning, TEXT("Replay seek to %.1fs failed"), TargetTime);
+		return;
+	}
+
+	const double SeekMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	NumSeeks++;
+	TotalSeekMs += SeekMs;
+	MaxSeekMs = FMath::Max(MaxSeekMs, SeekMs);
+
+	UE_LOG(LogShooter, Log, TEXT("Replay seek to %.1fs took %.0f ms (avg %.0f ms, max %.0f ms over %d seeks)"), TargetTime, SeekMs, TotalSeekMs / NumSeeks, MaxSeekMs, NumSeeks);
+}
+
 void SShooterDemoHUD::Construct(const FArguments& InArgs)
 {	
 	PlayerOwner = InArgs._PlayerOwner;
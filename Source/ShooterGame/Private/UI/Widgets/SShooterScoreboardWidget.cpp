@@ -27,6 +27,7 @@ void SShooterScoreboardWidget::Construct(const FArguments& InArgs)
 
 	ScoreboardStartTime = FPlatformTime::Seconds();
 	MatchState = InArgs._MatchState.Get();
+	LastRankedMapVersion = 0;
 
 	UpdatePlayerStateMaps();
 	
@@ -281,10 +282,14 @@ void SShooterScoreboardWidget::UpdatePlayerStateMaps()
 	if (PCOwner.IsValid())
 	{
 		AShooterGameState* const GameState = PCOwner->GetWorld()->GetGameState<AShooterGameState>();
-		if (GameState)
+		const int32 NumTeams = GameState ? FMath::Max(GameState->NumTeams, 1) : 0;
+
+		// Nothing to rebuild unless a score, team or player changed
+		if (GameState && (GameState->GetRankedMapVersion() != LastRankedMapVersion || PlayerStateMaps.Num() != NumTeams))
 		{
+			LastRankedMapVersion = GameState->GetRankedMapVersion();
+
 			bool bRequiresWidgetUpdate = false;
-			const int32 NumTeams = FMath::Max(GameState->NumTeams, 1);
 			LastTeamPlayerCount.Reset();
 			LastTeamPlayerCount.AddZeroed(PlayerStateMaps.Num());
 			for (int32 i = 0; i < PlayerStateMaps.Num(); i++)
@@ -219,10 +219,13 @@ protected:
 	/** the player currently selected in the scoreboard */
 	FTeamPlayer SelectedPlayer;
 
-	/** the Ranked PlayerState map...cleared every frame */
+	/** the Ranked PlayerState map...rebuilt when the game state's ranking changes */
 	TArray<RankedPlayerMap> PlayerStateMaps;
 
-	/** player count in each team in the last tick */
+	/** game state ranked map version PlayerStateMaps was built from */
+	uint32 LastRankedMapVersion;
+
+	/** player count in each team in the last rebuild */
 	TArray<int32> LastTeamPlayerCount;
 
 	/** holds talking player data */
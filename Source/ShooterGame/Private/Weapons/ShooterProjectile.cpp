@@ -4,6 +4,9 @@
 #include "Weapons/ShooterProjectile.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Effects/ShooterExplosionEffect.h"
+#include "Player/ShooterDemoSpectator.h"
+
+FOnShooterProjectileExploded AShooterProjectile::NotifyExploded;
 
 AShooterProjectile::AShooterProjectile(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
@@ -87,18 +90,31 @@ void AShooterProjectile::Explode(const FHitResult& Impact)
 		UGameplayStatics::ApplyRadialDamage(this, WeaponConfig.ExplosionDamage, NudgedImpactLocation, WeaponConfig.ExplosionRadius, WeaponConfig.DamageType, TArray<AActor*>(), this, MyController.Get());
 	}
 
-	if (ExplosionTemplate)
+	SpawnExplosionEffect(GetWorld(), ExplosionTemplate, Impact);
+
+	bExploded = true;
+
+	if (GetLocalRole() == ROLE_Authority)
+	{
+		NotifyExploded.Broadcast(this, Impact);
+	}
+}
+
+void AShooterProjectile::SpawnExplosionEffect(UWorld* World, TSubclassOf<AShooterExplosionEffect> Template, const FHitResult& Impact)
+{
+	if (World && Template && !AShooterDemoSpectator::ShouldSkipCosmetics(World))
 	{
+		// effects shouldn't be placed inside mesh at impact point
+		const FVector NudgedImpactLocation = Impact.ImpactPoint + Impact.ImpactNormal * 10.0f;
+
 		FTransform const SpawnTransform(Impact.ImpactNormal.Rotation(), NudgedImpactLocation);
-		AShooterExplosionEffect* const EffectActor = GetWorld()->SpawnActorDeferred<AShooterExplosionEffect>(ExplosionTemplate, SpawnTransform);
+		AShooterExplosionEffect* const EffectActor = World->SpawnActorDeferred<AShooterExplosionEffect>(Template, SpawnTransform);
 		if (EffectActor)
 		{
 			EffectActor->SurfaceHit = Impact;
 			UGameplayStatics::FinishSpawningActor(EffectActor, SpawnTransform);
 		}
 	}
-
-	bExploded = true;
 }
 
 void AShooterProjectile::DisableAndDestroy()
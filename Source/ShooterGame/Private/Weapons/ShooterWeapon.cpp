@@ -7,6 +7,7 @@
 #include "Bots/ShooterAIController.h"
 #include "Online/ShooterPlayerState.h"
 #include "UI/ShooterHUD.h"
+#include "Player/ShooterDemoSpectator.h"
 #include "MatineeCameraShake.h"
 
 AShooterWeapon::AShooterWeapon(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
@@ -819,6 +820,11 @@ void AShooterWeapon::SimulateWeaponFire()
 		return;
 	}
 
+	if (AShooterDemoSpectator::ShouldSkipCosmetics(GetWorld()))
+	{
+		return;
+	}
+
 	if (MuzzleFX)
 	{
 		USkeletalMeshComponent* UseWeaponMesh = GetWeaponMesh();
@@ -4,6 +4,7 @@
 #include "Weapons/ShooterWeapon_Instant.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Effects/ShooterImpactEffect.h"
+#include "Player/ShooterDemoSpectator.h"
 
 AShooterWeapon_Instant::AShooterWeapon_Instant(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
@@ -245,6 +246,12 @@ void AShooterWeapon_Instant::OnRep_HitNotify()
 
 void AShooterWeapon_Instant::SimulateInstantHit(const FVector& ShotOrigin, int32 RandomSeed, float ReticleSpread)
 {
+	// nothing but effects here, skip the trace too
+	if (AShooterDemoSpectator::ShouldSkipCosmetics(GetWorld()))
+	{
+		return;
+	}
+
 	FRandomStream WeaponRandomStream(RandomSeed);
 	const float ConeHalfAngle = FMath::DegreesToRadians(ReticleSpread * 0.5f);
 
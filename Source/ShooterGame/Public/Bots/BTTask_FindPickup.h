@@ -11,4 +11,9 @@ class UBTTask_FindPickup : public UBTTask_BlackboardBase
 	GENERATED_UCLASS_BODY()
 		
 	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+
+protected:
+	/** Pick the pickup with the shortest navigation path among the closest few, instead of the closest one */
+	UPROPERTY(EditAnywhere, Category = Pickup)
+	bool bUsePathCost;
 };
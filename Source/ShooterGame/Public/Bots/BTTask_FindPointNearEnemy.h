@@ -5,11 +5,21 @@
 #include "BehaviorTree/Tasks/BTTask_BlackboardBase.h"
 #include "BTTask_FindPointNearEnemy.generated.h"
 
-// Bot AI task that tries to find a location near the current enemy
+struct FBTFindPointNearEnemyMemory
+{
+	/** Enemy the location in the blackboard was picked for */
+	TWeakObjectPtr<AActor> GoalEnemy;
+};
+
+// Bot AI task that tries to find a location near the current enemy.
+// The navmesh query is deferred to UShooterNavQueryService: if the blackboard already holds a location picked for the same enemy
+// the task succeeds right away and the bot keeps that goal until the query updates it, otherwise the task waits for the query.
 UCLASS()
 class UBTTask_FindPointNearEnemy : public UBTTask_BlackboardBase
 {
 	GENERATED_UCLASS_BODY()
 
 	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual EBTNodeResult::Type AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual uint16 GetInstanceMemorySize() const override { return sizeof(FBTFindPointNearEnemyMemory); }
 };
@@ -6,6 +6,7 @@
 
 class UBehaviorTreeComponent;
 class UBlackboardComponent;
+struct FShooterCharacterQuery;
 
 UCLASS(config=Game)
 class AShooterAIController : public AAIController
@@ -35,6 +36,15 @@ public:
 
 	void CheckAmmo(const class AShooterWeapon* CurrentWeapon);
 
+	/** Sets the NeedAmmo blackboard key */
+	void SetNeedAmmo(bool bNeedAmmo);
+
+	/** Few enough bullets left to go look for ammo. Pure, so the game mode's parallel think pass can use it. */
+	static bool IsLowOnAmmo(int32 Ammo, int32 MaxAmmo);
+
+	/** Closest living enemies first, found by the game mode's bot think pass this frame. Replaces a dead enemy on the blackboard. */
+	void SetThinkEnemies(TArray<TWeakObjectPtr<AShooterCharacter>>&& Enemies);
+
 	void SetEnemy(class APawn* InPawn);
 
 	class AShooterCharacter* GetEnemy() const;
@@ -49,8 +59,9 @@ public:
 
 	UFUNCTION(BlueprintCallable, Category = Behavior)
 	bool FindClosestEnemyWithLOS(AShooterCharacter* ExcludeEnemy);
-		
-	bool HasWeaponLOSToEnemy(AActor* InEnemyActor, const bool bAnyEnemy) const;
+
+	/** Current AI level of detail */
+	EShooterBotLOD::Type GetLOD() const { return LOD; }
 
 	// Begin AAIController interface
 	/** Update direction AI is looking based on FocalPoint */
@@ -61,12 +72,54 @@ protected:
 	// Check of we have LOS to a character
 	bool LOSTrace(AShooterCharacter* InEnemyChar) const;
 
+	/** Character index query matching the enemies of this bot */
+	FShooterCharacterQuery GetEnemyQuery();
+
+	/**
+	 * Up to MaxEnemies living enemies closest first, from the think pass if it ran since the last frame (which only keeps
+	 * the closest ShooterGame.AI.Think.MaxEnemies), otherwise from the character index.
+	 * Returns true if the enemies came from the think pass.
+	 */
+	bool GetClosestEnemies(int32 MaxEnemies, TArray<AShooterCharacter*>& OutEnemies);
+
+	/**
+	 * Picks the AI LOD from the distance to the closest human viewer, bots in a fight always get full LOD.
+	 * Lower LODs update the behavior tree (and the services searching for enemies in it) and the control rotation less often.
+	 */
+	void UpdateLOD();
+
+	/** Sets LOD and the update intervals that go with it */
+	void SetLOD(EShooterBotLOD::Type NewLOD);
+
+	/** Shooting or able to see the current enemy */
+	bool IsInCombat() const;
+
+	/** Squared distance from Location to the closest human player's view point. With no human players, to the closest other living character (MAX_FLT if none). */
+	float GetClosestViewerDistSquared(const FVector& Location) const;
+
+	EShooterBotLOD::Type LOD;
+
+	/** Min time between control rotation updates at the current LOD */
+	float ControlRotationInterval;
+
+	/** Time skipped since the last control rotation update */
+	float ControlRotationDeltaTime;
+
+	/** Closest enemies from the last think pass, closest first */
+	TArray<TWeakObjectPtr<AShooterCharacter>> ThinkEnemies;
+
+	/** Frame of the last think pass, 0 if it never ran */
+	uint64 ThinkFrame;
+
 	int32 EnemyKeyID;
 	int32 NeedAmmoKeyID;
 
 	/** Handle for efficient management of Respawn timer */
 	FTimerHandle TimerHandle_Respawn;
 
+	/** Handle for efficient management of UpdateLOD timer */
+	FTimerHandle TimerHandle_UpdateLOD;
+
 public:
 	/** Returns BlackboardComp subobject **/
 	FORCEINLINE UBlackboardComponent* GetBlackboardComp() const { return BlackboardComp; }
@@ -0,0 +1,27 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "ShooterBehaviorTreeComponent.generated.h"
+
+/**
+ * Behavior tree component that can be throttled by the bot's AI LOD.
+ * The tree schedules its own tick interval, so the LOD interval is applied on top of it instead of through SetComponentTickInterval.
+ */
+UCLASS()
+class UShooterBehaviorTreeComponent : public UBehaviorTreeComponent
+{
+	GENERATED_BODY()
+
+public:
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/** Min time between tree updates, 0 updates whenever the tree asks to */
+	void SetLODTickInterval(float Interval) { LODTickInterval = Interval; }
+
+private:
+	float LODTickInterval = 0.f;
+
+	/** Time skipped since the last tree update */
+	float LODDeltaTime = 0.f;
+};
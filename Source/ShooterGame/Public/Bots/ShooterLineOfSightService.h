@@ -0,0 +1,97 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "WorldCollision.h"
+#include "ShooterLineOfSightService.generated.h"
+
+namespace EShooterLineOfSight
+{
+	enum Type
+	{
+		/** Never traced yet, a trace has been queued */
+		Unknown,
+		Visible,
+		Blocked,
+	};
+}
+
+/**
+ * Shared, cached line of sight checks for bots.
+ * Callers get the last known result right away. Missing or stale (older than ShooterGame.LOS.MaxAge) results are queued, de-duplicated,
+ * and traced asynchronously at most ShooterGame.LOS.TracesPerFrame per frame.
+ */
+UCLASS()
+class UShooterLineOfSightService : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Line of sight from Observer's eyes to Target. Hitting another enemy of Observer on the way also counts as visible. */
+	EShooterLineOfSight::Type GetLineOfSight(APawn* Observer, AActor* Target);
+
+	/** Line of sight from Observer's eyes to a location: visible if nothing blocks the way there. */
+	EShooterLineOfSight::Type GetLineOfSight(APawn* Observer, const FVector& TargetLocation);
+
+	// Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	// End FTickableGameObject interface
+
+private:
+
+	struct FRequestKey
+	{
+		FObjectKey Observer;
+		FObjectKey Target;
+
+		/** Quantized target location, only used when there is no target actor */
+		FIntVector Location;
+
+		bool operator==(const FRequestKey& Other) const { return Observer == Other.Observer && Target == Other.Target && Location == Other.Location; }
+		friend uint32 GetTypeHash(const FRequestKey& Key) { return HashCombine(HashCombine(GetTypeHash(Key.Observer), GetTypeHash(Key.Target)), GetTypeHash(Key.Location)); }
+	};
+
+	struct FRequest
+	{
+		FRequestKey Key;
+		TWeakObjectPtr<APawn> Observer;
+		TWeakObjectPtr<AActor> Target;
+		FVector TargetLocation;
+	};
+
+	struct FResult
+	{
+		/** World time of the last finished trace, negative if none yet */
+		float ResultTime = -1.f;
+
+		/** World time this pair was last asked for. Unused pairs are forgotten. */
+		float RequestTime = 0.f;
+
+		/** In the queue or being traced */
+		bool bQueued = false;
+
+		bool bVisible = false;
+	};
+
+	EShooterLineOfSight::Type GetLineOfSight(const FRequest& Request);
+
+	void OnTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	TMap<FRequestKey, FResult> Results;
+
+	/** Requests waiting for a trace, oldest first */
+	TArray<FRequest> Queue;
+
+	/** Requests being traced, by trace UserData */
+	TMap<uint32, FRequest> PendingTraces;
+
+	uint32 NextTraceId = 1;
+
+	float LastCleanupTime = 0.f;
+};
@@ -0,0 +1,69 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ShooterNavQueryService.generated.h"
+
+/** Called when a deferred nav query is done: success and the found location */
+DECLARE_DELEGATE_TwoParams(FShooterNavQueryDone, bool, const FVector&);
+
+/**
+ * Deferred navmesh queries for bots.
+ * Requests are queued and run at most ShooterGame.NavQuery.QueriesPerFrame per frame, so many bots picking new goals
+ * in the same frame don't all pay for their queries at once. Each querier has at most one request in flight: a new one updates it in place
+ * and keeps its place in the queue.
+ * Results are remembered per target for ShooterGame.NavQuery.MaxAge, and reused by requests for the same target from a nearby origin.
+ */
+UCLASS()
+class UShooterNavQueryService : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	 * Random reachable point within Radius of Origin, for a querier moving toward Target.
+	 * Returns true and sets OutLocation if a recent result for Target can be reused, OnDone is not called then.
+	 * Otherwise the query is queued and OnDone is called from a later frame.
+	 */
+	bool RequestRandomReachablePoint(UObject* Querier, const AActor* Target, const FVector& Origin, float Radius, FVector& OutLocation, FShooterNavQueryDone OnDone);
+
+	/** Drops the queued request of Querier, its OnDone is not called */
+	void CancelRequest(UObject* Querier);
+
+	// Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	// End FTickableGameObject interface
+
+private:
+
+	struct FRequest
+	{
+		FObjectKey Querier;
+		FObjectKey Target;
+		FVector Origin;
+		float Radius;
+		FShooterNavQueryDone OnDone;
+	};
+
+	struct FCachedPoint
+	{
+		FVector Origin;
+		FVector Location;
+		float Time;
+	};
+
+	/** Adds a result to the target's recent results, dropping expired ones */
+	void AddCachedPoint(const FObjectKey& Target, const FVector& Origin, const FVector& Location);
+
+	/** Requests waiting for their query, oldest first */
+	TArray<FRequest> Queue;
+
+	/** Recent results per target */
+	TMap<FObjectKey, TArray<FCachedPoint, TInlineAllocator<4>>> CachedPoints;
+};
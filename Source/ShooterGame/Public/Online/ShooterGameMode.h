@@ -9,6 +9,8 @@
 class AShooterAIController;
 class AShooterPlayerState;
 class AShooterPickup;
+class AShooterCharacter;
+class UShooterSpawnManager;
 class FUniqueNetId;
 
 UCLASS(config=Game)
@@ -25,6 +27,12 @@ class AShooterGameMode : public AGameMode
 
 	virtual void PreInitializeComponents() override;
 
+	/** Runs the bot think pass */
+	virtual void Tick(float DeltaSeconds) override;
+
+	/** Puts back the replay checkpoint interval once recording of the match stops */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	/** Initialize the game. This is called before actors' PreInitializeComponents. */
 	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
 
@@ -37,6 +45,9 @@ class AShooterGameMode : public AGameMode
 	/** Tries to spawn the player's pawn */
 	virtual void RestartPlayer(AController* NewPlayer) override;
 
+	/** Tells the spawn manager which player start was actually spawned at */
+	virtual void RestartPlayerAtPlayerStart(AController* NewPlayer, AActor* StartSpot) override;
+
 	/** select best spawn point for player */
 	virtual AActor* ChoosePlayerStart_Implementation(AController* Player) override;
 
@@ -112,6 +123,47 @@ protected:
 	UPROPERTY()
 	TArray<AShooterAIController*> BotControllers;
 
+	/** Character in the bot think snapshot */
+	struct FBotThinkCharacter
+	{
+		AShooterCharacter* Character;
+		FVector Location;
+		int32 TeamNum;
+		bool bAlive;
+	};
+
+	/** Bot in the bot think snapshot, with its results */
+	struct FBotThink
+	{
+		AShooterAIController* Controller;
+		AShooterCharacter* Pawn;
+		FVector Location;
+		int32 TeamNum;
+		int32 Ammo;
+		int32 MaxAmmo;
+		bool bHasWeapon;
+
+		/** Results: up to ShooterGame.AI.Think.MaxEnemies enemies (distance squared, index into BotThinkCharacters) closest first, and whether to look for ammo */
+		TArray<TPair<float, int32>> Enemies;
+		bool bNeedAmmo;
+	};
+
+	/** Snapshot of all characters, read only during the parallel part of the think pass */
+	TArray<FBotThinkCharacter> BotThinkCharacters;
+
+	/** One per living bot, kept between frames so the result arrays keep their memory */
+	TArray<FBotThink> BotThinks;
+
+	/** Wall time of the last think pass, for profiling */
+	double LastBotThinkSeconds;
+
+	/** Bots in the last think pass */
+	int32 LastBotThinkBots;
+
+	/** Picks spawn points for ChoosePlayerStart */
+	UPROPERTY(Transient)
+	UShooterSpawnManager* SpawnManager;
+
 	UPROPERTY(config)
 	TSubclassOf<AShooterPlayerController> PlatformPlayerControllerClass;
 	
@@ -125,9 +177,25 @@ protected:
 	/** spawning all bots for this game */
 	void StartBots();
 
+	/**
+	 * Bot sensing for all bots at full AI LOD at once, instead of each bot searching from its behavior tree.
+	 * Snapshots the characters (location, team, alive) and bots (location, team, ammo) on the game thread, finds every bot's
+	 * closest enemies and ammo need in a ParallelFor over the read only snapshot, then writes the results back to the bots' blackboards.
+	 */
+	void UpdateBotThink();
+
 	/** initialization for bot after creation */
 	virtual void InitBot(AShooterAIController* AIC, int32 BotNum);
 
+	/** Sets the replay checkpoint interval for a match that is about to be recorded, from ShooterGame.Replay.CheckpointInterval and MaxCheckpoints */
+	void SetReplayCheckpointInterval();
+
+	/** Sets demo.CheckpointUploadDelayInSeconds back to what it was before SetReplayCheckpointInterval */
+	void RestoreReplayCheckpointInterval();
+
+	/** demo.CheckpointUploadDelayInSeconds before SetReplayCheckpointInterval changed it, empty if it didn't */
+	FString SavedReplayCheckpointInterval;
+
 	/** check who won */
 	virtual void DetermineMatchWinner();
 
@@ -156,6 +224,10 @@ public:
 	/** get the name of the bots count option used in server travel URL */
 	static FString GetBotsCountOptionName();
 
+	/** Wall time of the last bot think pass in seconds, and the number of bots it ran for */
+	double GetLastBotThinkSeconds() const { return LastBotThinkSeconds; }
+	int32 GetLastBotThinkBots() const { return LastBotThinkBots; }
+
 	UPROPERTY()
 	TArray<AShooterPickup*> LevelPickups;
 
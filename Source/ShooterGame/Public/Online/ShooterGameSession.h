@@ -18,12 +18,20 @@ struct FShooterGameSessionParams
 	TSharedPtr<const FUniqueNetId> UserId;
 	/** Current search result choice to join */
 	int32 BestSessionIdx;
+	/** Search result indices in the order matchmaking tries them, best first */
+	TArray<int32> MatchmakingCandidates;
+	/** Index in MatchmakingCandidates of the next session to try */
+	int32 NextMatchmakingCandidate;
+	/** Whether a join failure should move on to the next candidate */
+	bool bMatchmaking;
 
 	FShooterGameSessionParams()
 		: SessionName(NAME_None)
 		, bIsLAN(false)
 		, bIsPresence(false)
 		, BestSessionIdx(0)
+		, NextMatchmakingCandidate(0)
+		, bMatchmaking(false)
 	{
 	}
 };
@@ -102,16 +110,17 @@ protected:
 	 */
 	void ChooseBestSession();
 
-	/**
-	 * Entry point for matchmaking after search results are returned
-	 */
-	void StartMatchmaking();
-
 	/**
 	 * Return point after each attempt to join a search result
 	 */
 	void ContinueMatchmaking();
 
+	/** Session being joined, to remember it if the join fails */
+	FString PendingJoinSessionId;
+
+	/** Time of the last failed join, by session id, sessions are skipped by matchmaking for a while after a failure */
+	TMap<FString, double> JoinFailureTimes;
+
 	/**
 	 * Delegate triggered when no more search results are available
 	 */
@@ -209,6 +218,33 @@ public:
 	 */
 	bool JoinSession(TSharedPtr<const FUniqueNetId> UserId, FName SessionName, const FOnlineSessionSearchResult& SearchResult);
 
+	/**
+	 * Entry point for matchmaking after search results are returned.
+	 * Tries the joinable search results from the best score down until one joins, then fires OnJoinSessionComplete.
+	 */
+	void StartMatchmaking();
+
+	/**
+	 * How good a session is for matchmaking, from its ping, open slots and player count.
+	 * Full sessions and sessions from an incompatible build score below zero and are never tried.
+	 *
+	 * @param SearchResult Session to score
+	 *
+	 * @return Score, higher is better
+	 */
+	static float ScoreSearchResult(const FOnlineSessionSearchResult& SearchResult);
+
+	/**
+	 * Orders search results the way matchmaking tries them, highest ScoreSearchResult first.
+	 * Sessions that score below zero, or failed to join within ShooterGame.Matchmaking.JoinFailureTime seconds of Now, are left out.
+	 *
+	 * @param SearchResults		Sessions found
+	 * @param JoinFailureTimes	Time of the last failed join, by session id
+	 * @param Now				Current FPlatformTime::Seconds()
+	 * @param OutCandidates		Indices into SearchResults, best first
+	 */
+	static void RankSearchResults(const TArray<FOnlineSessionSearchResult>& SearchResults, const TMap<FString, double>& JoinFailureTimes, double Now, TArray<int32>& OutCandidates);
+
 	/** @return true if any online async work is in progress, false otherwise */
 	bool IsBusy() const;
 
@@ -216,7 +252,7 @@ public:
 	 * Get the search results found and the current search result being probed
 	 *
 	 * @param SearchResultIdx idx of current search result accessed
-	 * @param NumSearchResults number of total search results found in FindGame()
+	 * @param NumSearchResults number of total search results found in FindGame(), or found so far while it is in progress
 	 *
 	 * @return State of search result query
 	 */
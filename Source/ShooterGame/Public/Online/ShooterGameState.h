@@ -3,11 +3,78 @@
 #pragma once
 
 #include "ShooterOnlineGameMatches.h"
+#include "Engine/NetSerialization.h"
 #include "ShooterGameState.generated.h"
 
 /** ranked PlayerState map, created from the GameState */
 typedef TMap<int32, TWeakObjectPtr<AShooterPlayerState> > RankedPlayerMap; 
 
+/** One kill in the replicated kill feed. Players are sent as their player ids instead of actor references. */
+USTRUCT()
+struct FShooterKillFeedEntry : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	/** player id of the killer, INDEX_NONE if there was none */
+	UPROPERTY()
+	int32 KillerPlayerId;
+
+	/** player id of the victim */
+	UPROPERTY()
+	int32 VictimPlayerId;
+
+	UPROPERTY()
+	TSubclassOf<UDamageType> DamageType;
+
+	/** server world time of the kill, so players joining later don't see old kills */
+	UPROPERTY()
+	float KillTime;
+
+	FShooterKillFeedEntry()
+		: KillerPlayerId(INDEX_NONE)
+		, VictimPlayerId(INDEX_NONE)
+		, KillTime(0.f)
+	{
+	}
+
+	void PostReplicatedAdd(const struct FShooterKillFeed& InArraySerializer);
+};
+
+/**
+ * Recent kills, replicated with the game state. All kills of a frame go out in one update
+ * instead of one RPC per kill and player.
+ */
+USTRUCT()
+struct FShooterKillFeed : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FShooterKillFeedEntry> Entries;
+
+	/** game state owning the feed, not replicated */
+	class AShooterGameState* GameState;
+
+	FShooterKillFeed()
+		: GameState(nullptr)
+	{
+	}
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FShooterKillFeedEntry, FShooterKillFeed>(Entries, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FShooterKillFeed> : public TStructOpsTypeTraitsBase2<FShooterKillFeed>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
 UCLASS()
 class AShooterGameState : public AGameState
 {
@@ -34,6 +101,21 @@ public:
 	/** gets ranked PlayerState map for specific team */
 	void GetRankedMap(int32 TeamIndex, RankedPlayerMap& OutRankedMap) const;	
 
+	/** Marks the ranked maps stale, called whenever a player's score or team changes */
+	void InvalidateRankedMaps();
+
+	/** Changes every time the ranked maps may have changed, so UI can skip rebuilding when it didn't */
+	uint32 GetRankedMapVersion() const { return RankedMapVersion; }
+
+	/** adds a kill to the replicated kill feed, server only */
+	void AddKill(AShooterPlayerState* KillerPlayerState, const UDamageType* KillerDamageType, AShooterPlayerState* KilledPlayerState);
+
+	/** tells local players about a kill from the feed: updates their huds and kill stats */
+	void HandleKill(const FShooterKillFeedEntry& Entry);
+
+	virtual void AddPlayerState(APlayerState* PlayerState) override;
+	virtual void RemovePlayerState(APlayerState* PlayerState) override;
+
 	void RequestFinishAndExitToMainMenu();
 
 	virtual void HandleMatchHasStarted() override;
@@ -47,4 +129,22 @@ protected:
 	bool bEnableGameFeedback;
 
 	FShooterOnlineGameMatches GameMatches;
+
+	/** recent kills */
+	UPROPERTY(Transient, Replicated)
+	FShooterKillFeed KillFeed;
+
+	/** finds the PlayerState with PlayerId in PlayerArray */
+	AShooterPlayerState* FindPlayerStateById(int32 PlayerId) const;
+
+private:
+	/** Rebuilds the ranked maps of all teams if they are stale */
+	void UpdateRankedMaps() const;
+
+	/** Ranked maps per team, rebuilt on the first GetRankedMap after InvalidateRankedMaps */
+	mutable TMap<int32, RankedPlayerMap> RankedMaps;
+
+	mutable bool bRankedMapsDirty;
+
+	uint32 RankedMapVersion;
 };
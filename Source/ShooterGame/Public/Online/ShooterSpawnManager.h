@@ -0,0 +1,83 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ShooterSpawnManager.generated.h"
+
+class APlayerStart;
+
+/**
+ * Spawn point selection for AShooterGameMode.
+ * The player starts are gathered when the game starts and again whenever a level is streamed in or out, and the ones a player
+ * may use are cached per (team, bot or not).
+ * Allowed spawns are scored by distance to the closest living enemy (through UShooterCharacterSpatialIndex, cached per team
+ * for the frame), how recently a player spawned there, and a bit of randomness. A spawn used this frame counts as occupied, so
+ * a mass respawn doesn't stack players on the same start before the character index sees them. Only actual spawns reported
+ * through MarkSpawnUsed count, FindPlayerStart calls made at login don't.
+ */
+UCLASS()
+class UShooterSpawnManager : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Caches the world's player starts */
+	void Init(UWorld* World);
+
+	virtual void BeginDestroy() override;
+
+	/**
+	 * Best spawn for Player, or null if none is allowed.
+	 * IsAllowed and IsPreferred are the game mode's rules, IsAllowed may only depend on the player's team and whether it is a bot.
+	 */
+	APlayerStart* ChooseSpawn(AController* Player, TFunctionRef<bool(APlayerStart*)> IsAllowed, TFunctionRef<bool(APlayerStart*)> IsPreferred);
+
+	/** A player has been spawned at PlayerStart */
+	void MarkSpawnUsed(APlayerStart* PlayerStart);
+
+private:
+
+	struct FSpawnPoint
+	{
+		TWeakObjectPtr<APlayerStart> PlayerStart;
+		FVector Location;
+		float LastUseTime;
+		uint64 LastUseFrame;
+	};
+
+	struct FEnemyDistances
+	{
+		uint64 Frame = MAX_uint64;
+
+		/** Squared distance from each spawn point to the closest enemy, capped at the safe distance */
+		TArray<float> DistSq;
+	};
+
+	/** Gathers the world's player starts, keeping when the ones already known were last used */
+	void GatherSpawnPoints(UWorld* World);
+
+	/** Player starts come and go with streamed levels */
+	void OnLevelChanged(ULevel* Level, UWorld* World);
+
+	/** Team of Player, INDEX_NONE if there are no teams: everybody else is an enemy */
+	int32 GetSpawnTeam(AController* Player) const;
+
+	const TArray<float>& GetEnemyDistances(int32 Team);
+
+	float GetScore(int32 SpawnIndex, float EnemyDistSq, float Now) const;
+
+	TArray<FSpawnPoint> SpawnPoints;
+
+	/** A level was added or removed since the player starts were gathered */
+	bool bSpawnPointsDirty = false;
+
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+
+	/** Indices into SpawnPoints a player may use, per (team, is bot) */
+	TMap<TPair<int32, bool>, TArray<int32>> AllowedSpawns;
+
+	/** Per team */
+	TMap<int32, FEnemyDistances> EnemyDistances;
+};
@@ -16,10 +16,16 @@ class AShooterPickup : public AActor
 	/** check if pawn can use this pickup */
 	virtual bool CanBePickedUp(class AShooterCharacter* TestPawn) const;
 
+	/** is it ready for interactions? */
+	bool IsActive() const { return bIsActive; }
+
 protected:
 	/** initial setup */
 	virtual void BeginPlay() override;
 
+	/** unregister from the pickup index */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 private:
 	/** FX component */
 	UPROPERTY(VisibleDefaultsOnly, Category=Effects)
@@ -69,6 +75,9 @@ protected:
 	/** show and enable pickup */
 	virtual void RespawnPickup();
 
+	/** keep the server's pickup index in sync with bIsActive */
+	void UpdatePickupIndex();
+
 	/** show effects when pickup disappears */
 	virtual void OnPickedUp();
 
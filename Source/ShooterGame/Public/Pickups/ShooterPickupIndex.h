@@ -0,0 +1,98 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterPickupIndex.generated.h"
+
+class AShooterCharacter;
+class AShooterPickup;
+
+/** Filter for UShooterPickupIndex queries */
+struct FShooterPickupQuery
+{
+	/** Only pickups of this class (or a subclass) */
+	UClass* PickupClass = nullptr;
+
+	/** Ammo pickups only: only pickups for this weapon class (or a subclass), null for any */
+	UClass* WeaponClass = nullptr;
+
+	/** If set, only pickups this pawn can use right now */
+	AShooterCharacter* Pawn = nullptr;
+
+	/** Rank the closest few candidates by navigation path length instead of straight-line distance */
+	bool bUsePathCost = false;
+};
+
+/**
+ * Server side registry of the level pickups, bucketed by pickup class and weapon class.
+ * Each bucket keeps its active pickups in a uniform 2D grid, updated when a pickup is picked up or respawns,
+ * so nearest-pickup queries only look at nearby, available pickups.
+ */
+UCLASS()
+class UShooterPickupIndex : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Registers Pickup, or moves it in or out of the active set after it was picked up or respawned */
+	void UpdatePickup(AShooterPickup* Pickup);
+
+	/** Forgets Pickup */
+	void RemovePickup(AShooterPickup* Pickup);
+
+	/** Closest active pickup matching Query, or null */
+	AShooterPickup* FindNearest(const FVector& Origin, const FShooterPickupQuery& Query);
+
+private:
+
+	typedef TArray<TWeakObjectPtr<AShooterPickup>, TInlineAllocator<2>> FCellPickups;
+	typedef TArray<TPair<float, AShooterPickup*>, TInlineAllocator<16>> FCandidateArray;
+
+	struct FBucket
+	{
+		UClass* PickupClass;
+		UClass* WeaponType;
+
+		/** Active pickups only */
+		TMap<FIntPoint, FCellPickups> Cells;
+	};
+
+	struct FPathCostKey
+	{
+		FIntVector Origin;
+		FObjectKey Pickup;
+
+		bool operator==(const FPathCostKey& Other) const { return Origin == Other.Origin && Pickup == Other.Pickup; }
+		friend uint32 GetTypeHash(const FPathCostKey& Key) { return HashCombine(GetTypeHash(Key.Origin), GetTypeHash(Key.Pickup)); }
+	};
+
+	struct FPathCost
+	{
+		/** Negative if there is no path */
+		float Length;
+		float Time;
+	};
+
+	FBucket& FindOrAddBucket(AShooterPickup* Pickup);
+
+	FIntPoint GetCell(const FVector& Location) const;
+
+	/** Adds the matching pickups in Cell of every matching bucket to Candidates (distance squared, pickup) */
+	void GatherCell(const FIntPoint& Cell, const FVector& Origin, const FShooterPickupQuery& Query, FCandidateArray& Candidates) const;
+
+	/** Navigation path length from Origin to Pickup, cached per origin cell. Negative if there is no path. */
+	float GetPathCost(const FVector& Origin, AShooterPickup* Pickup);
+
+	TArray<FBucket> Buckets;
+
+	/** Cell of every registered pickup, pickups don't move */
+	TMap<TWeakObjectPtr<AShooterPickup>, FIntPoint> PickupCells;
+
+	/** Bounds of all registered cells */
+	FIntPoint MinCell = FIntPoint(MAX_int32, MAX_int32);
+	FIntPoint MaxCell = FIntPoint(MIN_int32, MIN_int32);
+
+	TMap<FPathCostKey, FPathCost> PathCosts;
+};
@@ -19,6 +19,9 @@ class AShooterPickup_Ammo : public AShooterPickup
 
 	bool IsForWeapon(UClass* WeaponClass);
 
+	/** which weapon gets ammo? */
+	TSubclassOf<AShooterWeapon> GetWeaponType() const { return WeaponType; }
+
 protected:
 
 	/** how much ammo does it give? */
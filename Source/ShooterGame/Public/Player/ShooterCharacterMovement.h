@@ -58,13 +58,23 @@ public:
 
 #pragma region NetworkPrediction
 
+public:
+	/* Number of movement corrections this client received from the server, for the performance overlay */
+	int32 GetNumClientCorrections() const { return NumClientCorrections; }
+
 protected:
+	/* Counts the correction before applying it */
+	virtual void OnClientCorrectionReceived(class FNetworkPredictionData_Client_Character& ClientData, float TimeStamp, FVector NewLocation, FVector NewVelocity, UPrimitiveComponent* NewBase, FName NewBaseBoneName, bool bHasBase, bool bBaseRelativePosition, uint8 ServerMovementMode) override;
+
 	/* Method for unpacking the flags from a SavedMove */
 	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
 
 	/* Gets the prediction data client (ShooterCharacter) */
 	virtual FNetworkPredictionData_Client* GetPredictionData_Client() const override;
 
+private:
+	int32 NumClientCorrections = 0;
+
 };
 
 class FNetworkPredictionData_Client_ShooterCharacter : public FNetworkPredictionData_Client_Character {
@@ -0,0 +1,96 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterCharacterSpatialIndex.generated.h"
+
+class AShooterCharacter;
+
+/** Filter for UShooterCharacterSpatialIndex queries */
+struct FShooterCharacterQuery
+{
+	/** Skip every character on this team (INDEX_NONE: no team is skipped) */
+	int32 ExcludeTeam = INDEX_NONE;
+
+	/** Only return characters on this team (INDEX_NONE: any team) */
+	int32 OnlyTeam = INDEX_NONE;
+
+	/** Skip dead characters */
+	bool bAliveOnly = true;
+
+	/** Measure distances in 2D, ignoring Z */
+	bool bDistance2D = false;
+
+	/** Max distance to the query origin */
+	float MaxDistance = MAX_FLT;
+
+	/** Never returned, usually the querying pawn */
+	const AActor* IgnoreActor = nullptr;
+
+	/** Optional extra test, only run on characters that passed everything above */
+	TFunction<bool(const AShooterCharacter*)> Filter;
+};
+
+/**
+ * Per world index of all AShooterCharacters, partitioned by team, each team in a uniform 2D grid.
+ * Rebuilt lazily once per frame on the first query, so bots and the game mode can ask "who is near" without iterating every character.
+ */
+UCLASS()
+class UShooterCharacterSpatialIndex : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** All matching characters within Radius of Origin, closest first */
+	void FindInRadius(const FVector& Origin, float Radius, const FShooterCharacterQuery& Query, TArray<AShooterCharacter*>& OutCharacters);
+
+	/** Up to NumCharacters matching characters closest to Origin, closest first */
+	void FindNearest(const FVector& Origin, int32 NumCharacters, const FShooterCharacterQuery& Query, TArray<AShooterCharacter*>& OutCharacters);
+
+	/** Closest matching character to Origin, or null */
+	AShooterCharacter* FindNearest(const FVector& Origin, const FShooterCharacterQuery& Query);
+
+	/** Largest capsule radius of the indexed characters, for overlap tests */
+	float GetMaxCapsuleRadius();
+
+private:
+
+	struct FEntry
+	{
+		TWeakObjectPtr<AShooterCharacter> Character;
+		FVector Location;
+		int32 TeamNum;
+		bool bAlive;
+	};
+
+	struct FTeamGrid
+	{
+		int32 TeamNum;
+		TMap<FIntPoint, TArray<int32, TInlineAllocator<4>>> Cells;
+	};
+
+	typedef TArray<TPair<float, int32>, TInlineAllocator<32>> FCandidateArray;
+
+	/** Rebuilds the index if it was not built this frame */
+	void UpdateIndex();
+
+	FIntPoint GetCell(const FVector& Location) const;
+
+	/** Adds the matching entries in Cell to Candidates (distance squared, entry index) */
+	void GatherCell(const FIntPoint& Cell, const FVector& Origin, float MaxDistSq, const FShooterCharacterQuery& Query, FCandidateArray& Candidates) const;
+
+	TArray<FEntry> Entries;
+
+	/** One grid per team. Few teams, so a linear search is fine. */
+	TArray<FTeamGrid> TeamGrids;
+
+	/** Bounds of all occupied cells */
+	FIntPoint MinCell;
+	FIntPoint MaxCell;
+
+	float CellSize = 2000.f;
+	float MaxCapsuleRadius = 0.f;
+	uint64 IndexedFrame = MAX_uint64;
+};
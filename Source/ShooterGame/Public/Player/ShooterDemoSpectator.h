@@ -25,7 +25,38 @@ public:
 
 	int32 PlaybackSpeed;
 
+	/**
+	 * True while a replay is played back at or above ShooterGame.Replay.FastForwardSpeed, or is fast forwarding to a seek target.
+	 * Cosmetic-only spawns (impacts, trails, muzzle flashes, explosions, one-shot sounds and ability effects) are skipped then,
+	 * replicated gameplay state is applied as usual.
+	 */
+	static bool ShouldSkipCosmetics(const UWorld* World);
+
+	/**
+	 * Measures seek latency: seeks the replay NumSeeks times, back and forth over its whole length, one after the other.
+	 * Writes the time of every seek to Saved/Profiling/ReplaySeek/ and logs the average, 95th percentile and max. The replay
+	 * must not be paused. Run it on replays recorded with different ShooterGame.Replay.CheckpointInterval to compare them.
+	 */
+	UFUNCTION(exec)
+	void ReplaySeekBenchmark(int32 NumSeeks = 20);
+
 private:
+	/** Applies PlaybackSpeed to the replay */
+	void SetPlaybackSpeed(int32 NewPlaybackSpeed);
+
+	/** Starts the next seek of the benchmark, or reports once they are all done */
+	void NextBenchmarkSeek();
+
+	void OnBenchmarkSeekComplete(bool bWasSuccessful, double StartTime, float TargetTime);
+
+	/** Seeks left to go in the running benchmark, 0 if none is running */
+	int32 BenchmarkSeeksLeft;
+	int32 BenchmarkNumSeeks;
+
+	/** Time of each successful seek of the running benchmark */
+	TArray<float> BenchmarkSeekMs;
+	TArray<FString> BenchmarkCsvRows;
+
 	TSharedPtr<SShooterDemoHUD> DemoHUD;
 };
 
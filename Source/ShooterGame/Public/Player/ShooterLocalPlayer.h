@@ -21,6 +21,9 @@ public:
 	/** Initializes the PersistentUser */
 	void LoadPersistentUser();
 
+	/** Saves the PersistentUser if it is loaded and has changed, and waits until it is written */
+	void FlushPersistentUser();
+
 private:
 	/** Persistent user data stored between sessions (i.e. the user's savegame) */
 	UPROPERTY()
@@ -0,0 +1,75 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Async/Future.h"
+
+/** One match in the match history log. Fixed size, written to disk as is. */
+struct FShooterMatchRecord
+{
+	enum
+	{
+		Flag_Won = 1 << 0,
+	};
+
+	/** When the match ended, UTC FDateTime ticks */
+	int64 Timestamp = 0;
+
+	int32 Kills = 0;
+	int32 Deaths = 0;
+	int32 BulletsFired = 0;
+	int32 RocketsFired = 0;
+	uint32 Flags = 0;
+
+	/** Last field, so a record cut short by a crash is recognized and skipped */
+	uint32 EndMarker = 0;
+
+	bool IsWin() const { return (Flags & Flag_Won) != 0; }
+
+	FDateTime GetTime() const { return FDateTime(Timestamp); }
+};
+
+static_assert(sizeof(FShooterMatchRecord) == 32, "FShooterMatchRecord is stored on disk, bump the match history version when it changes");
+
+/**
+ * Append-only log of every match a persistent user has played, kept next to the user's save game.
+ * A versioned header followed by fixed-size FShooterMatchRecords, oldest first. Appends happen on the thread pool, reads map
+ * the file and only copy the records asked for, so queries over the last few matches cost the same with thousands in the log.
+ */
+class FShooterMatchHistory
+{
+public:
+	explicit FShooterMatchHistory(const FString& SlotName);
+	~FShooterMatchHistory();
+
+	/** Appends a match to the log in the background */
+	void AddMatch(const FShooterMatchRecord& Record);
+
+	/** Number of matches in the log */
+	int32 GetNumMatches();
+
+	/** Reads the last Count matches, newest first */
+	void GetRecentMatches(int32 Count, TArray<FShooterMatchRecord>& OutMatches);
+
+	/**
+	 * Kill/death ratio over consecutive windows of the most recent matches, newest window first.
+	 *
+	 * @param WindowSize	Matches per window.
+	 * @param NumWindows	Max number of windows, fewer if the log is shorter.
+	 * @param OutRatios		Kills / deaths for each window, deaths counted as at least 1.
+	 */
+	void GetKillDeathTrend(int32 WindowSize, int32 NumWindows, TArray<float>& OutRatios);
+
+private:
+	/** Reads records [FirstRecord, FirstRecord + Count), skipping any that are incomplete */
+	void ReadRecords(int32 FirstRecord, int32 Count, TArray<FShooterMatchRecord>& OutRecords) const;
+
+	/** Blocks until the last append has been written */
+	void WaitForPendingAppend();
+
+	/** The log file */
+	FString Filename;
+
+	/** Append in progress, if any */
+	TFuture<void> PendingAppend;
+};
@@ -1,8 +1,11 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #pragma once
+#include "Async/Future.h"
 #include "ShooterPersistentUser.generated.h"
 
+class FShooterMatchHistory;
+
 UCLASS()
 class UShooterPersistentUser : public USaveGame
 {
@@ -12,10 +15,18 @@ public:
 	/** Loads user persistence data if it exists, creates an empty record otherwise. */
 	static UShooterPersistentUser* LoadPersistentUser(FString SlotName, const int32 UserIndex);
 
-	/** Saves data if anything has changed. */
+	/** Saves data if anything has changed. Saves requested within ShooterGame.PersistentUser.SaveDelay of each other are written once. */
 	void SaveIfDirty();
 
-	/** Records the result of a match. */
+	/** Writes a save that is still waiting out its delay now, and waits for any write in progress. */
+	void FlushSave();
+
+	virtual void BeginDestroy() override;
+
+	/** Every match this user has played, null until the user has a slot name. */
+	FShooterMatchHistory* GetMatchHistory();
+
+	/** Records the result of a match, in the lifetime totals and the match history. */
 	void AddMatchResult(int32 MatchKills, int32 MatchDeaths, int32 MatchBulletsFired, int32 MatchRocketsFired, bool bIsMatchWinner);
 
 	/** needed because we can recreate the subsystem that stores it */
@@ -115,9 +126,12 @@ protected:
 	/** Checks if the Inverted Mouse user setting is different from current */
 	bool IsInvertedYAxisDirty() const;
 
-	/** Triggers a save of this data. */
+	/** Schedules a save of this data, unless one is already scheduled. */
 	void SavePersistentUser();
 
+	/** Ticker callback for a scheduled save, serializes the data and starts writing it in the background. Logs how long both take. */
+	bool HandleScheduledSave(float DeltaTime);
+
 	/** Lifetime count of kills */
 	UPROPERTY()
 	int32 Kills;
@@ -169,6 +183,15 @@ private:
 	/** Internal.  True if data is changed but hasn't been saved. */
 	bool bIsDirty;
 
+	/** Scheduled save, if any */
+	FDelegateHandle ScheduledSaveHandle;
+
+	/** Background write of the last save, true if it succeeded */
+	TFuture<bool> PendingWrite;
+
+	/** Created on first use */
+	TSharedPtr<FShooterMatchHistory> MatchHistory;
+
 	/** The string identifier used to save/load this persistent user. */
 	FString SlotName;
 	int32 UserIndex;
@@ -22,6 +22,10 @@ public:
 	UFUNCTION(reliable, client)
 	void ClientGameStarted();
 
+	/** play explosion of a projectile that was never replicated to this connection */
+	UFUNCTION(unreliable, client)
+	void ClientPlayProjectileExplosion(TSubclassOf<class AShooterExplosionEffect> ExplosionTemplate, FVector_NetQuantize ImpactPoint, FVector_NetQuantizeNormal ImpactNormal);
+
 	/** Starts the online game using the session name in the PlayerState */
 	UFUNCTION(reliable, client)
 	void ClientStartOnlineGame();
@@ -292,6 +296,14 @@ public:
 	UFUNCTION(exec)
 	virtual void Suicide();
 
+	/** Toggles the HUD performance overlay */
+	UFUNCTION(exec)
+	void PerfOverlay();
+
+	/** Records the performance overlay stats for Seconds and writes them to Saved/Profiling/PerfCapture/ */
+	UFUNCTION(exec)
+	void PerfCapture(float Seconds = 10.f);
+
 	/** Notifies the server that the client has suicided */
 	UFUNCTION(reliable, server, WithValidation)
 	void ServerSuicide();
@@ -312,6 +324,13 @@ public:
 
 	FName	ServerSayString;
 
+	/** Server only: takes a token from the chat rate limit bucket, false if the player is over the limit */
+	bool ConsumeChatToken();
+
+	/** Chat rate limit bucket, and the platform time it was last refilled */
+	float ChatTokens;
+	double LastChatTime;
+
 	// Timer used for updating friends in the player tick.
 	float ShooterFriendUpdateTimer;
 
@@ -108,6 +108,9 @@ public:
 	void SetPendingInvite(const FShooterPendingInvite& InPendingInvite);
 
 	bool PlayDemo(ULocalPlayer* LocalPlayer, const FString& DemoName);
+
+	/** Index of the local replays, loaded the first time it's needed */
+	class UShooterReplayIndex* GetReplayIndex();
 	
 	/** Travel directly to the named session */
 	void TravelToSession(const FName& SessionName);
@@ -216,6 +219,10 @@ private:
 	UPROPERTY(config)
 	FString MainMenuMap;
 
+	/** Index of the local replays */
+	UPROPERTY()
+	class UShooterReplayIndex* ReplayIndex;
+
 
 	FName CurrentState;
 	FName PendingState;
@@ -0,0 +1,96 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GameFramework/SaveGame.h"
+#include "NetworkReplayStreaming.h"
+#include "ShooterReplayIndex.generated.h"
+
+/** What the replay list shows of one replay */
+USTRUCT()
+struct FShooterReplayIndexEntry
+{
+	GENERATED_BODY()
+
+	/** Stream name, used to play and delete the replay */
+	UPROPERTY()
+	FString Name;
+
+	UPROPERTY()
+	FString FriendlyName;
+
+	/** Map the replay was recorded on, only known for replays recorded by this game */
+	UPROPERTY()
+	FString MapName;
+
+	UPROPERTY()
+	FDateTime Timestamp;
+
+	UPROPERTY()
+	int32 LengthInMS = 0;
+
+	UPROPERTY()
+	int64 SizeInBytes = 0;
+
+	/** Replay network version, 0 if the replay is from some other version */
+	UPROPERTY()
+	uint32 NetworkVersion = 0;
+
+	UPROPERTY()
+	bool bIsLive = false;
+
+	UPROPERTY()
+	int32 NumViewers = 0;
+};
+
+/**
+ * On-disk index of the local replays, so the replay list can be shown without waiting for the replay streamer.
+ * Replays are added when their recording ends and removed when deleted from the list. The list still enumerates the
+ * streams in the background each time it opens and brings the index up to date with Reconcile.
+ */
+UCLASS()
+class UShooterReplayIndex : public USaveGame
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+	/** Loads the index if it exists and is current, creates an empty one otherwise. */
+	static UShooterReplayIndex* LoadReplayIndex();
+
+	/** Saves the index in the background if anything has changed. */
+	void SaveIfDirty();
+
+	/** All indexed replays, most recent first */
+	const TArray<FShooterReplayIndexEntry>& GetEntries() const { return Entries; }
+
+	/** Records a replay whose recording just ended, the streamer fills in the rest on the next Reconcile. */
+	void AddRecording(const FString& Name, const FString& MapName);
+
+	/** Forgets a deleted replay */
+	void RemoveReplay(const FString& Name);
+
+	/**
+	 * Updates the index from the replay streamer's streams, adding, updating and removing entries.
+	 *
+	 * @param AllStreams			Streams of all versions.
+	 * @param CurrentVersionStreams	Streams that can be played by this version.
+	 *
+	 * @return true if anything changed
+	 */
+	bool Reconcile(const TArray<FNetworkReplayStreamInfo>& AllStreams, const TArray<FNetworkReplayStreamInfo>& CurrentVersionStreams);
+
+private:
+	/** Bumped when FShooterReplayIndexEntry changes, older indices are thrown away */
+	static const int32 CurrentIndexVersion = 1;
+
+	void SortEntries();
+
+	UPROPERTY()
+	int32 IndexVersion;
+
+	UPROPERTY()
+	TArray<FShooterReplayIndexEntry> Entries;
+
+	/** True if data is changed but hasn't been saved. */
+	bool bIsDirty;
+};
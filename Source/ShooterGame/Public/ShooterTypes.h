@@ -69,6 +69,17 @@ namespace EShooterDialogType
 	};
 }
 
+/** How much work a bot does, see AShooterAIController::UpdateLOD */
+namespace EShooterBotLOD
+{
+	enum Type
+	{
+		Full,
+		Reduced,
+		Minimal,
+	};
+}
+
 #define SHOOTER_SURFACE_Default		SurfaceType_Default
 #define SHOOTER_SURFACE_Concrete	SurfaceType1
 #define SHOOTER_SURFACE_Dirt		SurfaceType2
@@ -0,0 +1,92 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+#pragma once
+
+#include "Tests/ShooterTestControllerBase.h"
+#include "ShooterTestControllerBotSoak.generated.h"
+
+/**
+ * Headless bot soak test. Run on a dedicated server, no clients or graphics needed:
+ *
+ *	ShooterServer /Game/Maps/Highrise -gauntlet=ShooterTestControllerBotSoak -nullrhi -unattended -BotSoakBots=64 -BotSoakMatches=3
+ *
+ * Fills every match with bots through AShooterGameMode::SetAllowBots/CreateBotControllers (with no cap on the count), shortens
+ * the warmup, round and post-match times, and lets the server cycle through a number of matches. Every frame it records the
+ * frame time, the time spent ticking the world up to the end of the actor tick, the number of live bots, the time and bot
+ * count of the game mode's bot think pass, garbage collection pauses and memory use, then writes a CSV report.
+ *
+ * Options: -BotSoakBots= -BotSoakMatches= -BotSoakWarmup= -BotSoakRoundTime= -BotSoakTimeBetweenMatches= (seconds)
+ *			-BotSoakTimeout= (seconds) -BotSoakCsv= (defaults to Saved/Profiling/BotSoak/)
+ */
+UCLASS()
+class UShooterTestControllerBotSoak : public UShooterTestControllerBase
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnInit() override;
+	virtual void OnPostMapChange(UWorld* World) override;
+	virtual void BeginDestroy() override;
+
+protected:
+	virtual void OnTick(float TimeDelta) override;
+
+	/** Tops the current match up to NumBots bots */
+	void AddBots(UWorld* World);
+
+	/** Applies the shortened match timers and counts finished matches */
+	void UpdateMatch(UWorld* World);
+
+	/** Records one CSV row for this frame */
+	void SampleFrame(UWorld* World, float TimeDelta);
+
+	/** Writes the report and ends the test */
+	void FinishTest(bool bSuccess);
+
+	void OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void OnPreGarbageCollect();
+	void OnPostGarbageCollect();
+
+	void RemoveDelegates();
+
+private:
+	// Options
+	int32 NumBots;
+	int32 NumMatches;
+	int32 WarmupTime;
+	int32 RoundTime;
+	int32 TimeBetweenMatches;
+	float Timeout;
+	FString CsvFilename;
+
+	TWeakObjectPtr<UWorld> SoakWorld;
+	bool bBotsAdded;
+	bool bSoakFinished;
+	FName LastMatchState;
+	int32 NumMatchesFinished;
+	double StartTime;
+
+	FDelegateHandle OnWorldTickStartHandle;
+	FDelegateHandle OnWorldPostActorTickHandle;
+	FDelegateHandle OnPreGarbageCollectHandle;
+	FDelegateHandle OnPostGarbageCollectHandle;
+
+	double WorldTickStartTime;
+	float LastTickMs;
+
+	double GCStartTime;
+	float FrameGCMs;
+	int32 NumGCs;
+	float MaxGCMs;
+
+	/** Memory is only read once per second, reading it is not free */
+	double LastMemorySampleTime;
+	uint64 UsedPhysical;
+	uint64 PeakUsedPhysical;
+
+	TArray<FString> CsvRows;
+
+	/** Per frame tick times, for the summary */
+	TArray<float> TickTimesMs;
+	float MaxFrameMs;
+};
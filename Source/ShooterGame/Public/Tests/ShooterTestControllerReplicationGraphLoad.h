@@ -0,0 +1,114 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+#pragma once
+
+#include "Tests/ShooterTestControllerBase.h"
+#include "ShooterTestControllerReplicationGraphLoad.generated.h"
+
+class AShooterProjectile;
+class APlayerController;
+class UNetConnection;
+
+/**
+ * Headless replication graph benchmark. Run on a dedicated server (-nullrhi is fine, no clients or network needed):
+ *
+ *	ShooterServer /Game/Maps/Highrise -gauntlet=ShooterTestControllerReplicationGraphLoad -nullrhi -RepGraphLoadConnections=64 -RepGraphLoadBots=32
+ *
+ * Once the match is in progress this adds simulated client connections whose view points patrol between the player starts,
+ * spawns bots and keeps a number of projectiles in flight. Every replication frame it records the time spent in
+ * ServerReplicateActors, the actors replicated per connection and the bytes written per connection, then writes a CSV report.
+ * The time spent ticking actors is recorded too, so bot costs can be compared, e.g. -RepGraphLoadBots=8/32/64 with ShooterGame.AI.LOD.Enable 0 and 1.
+ * Parallel connection preparation is compared the same way: -RepGraphLoadConnections=16/32/64/100 with -ExecCmds="ShooterRepGraph.ParallelGather 0" and 1
+ * (the PrepareMs column is the time spent in UShooterReplicationGraph::PrepareConnectionsForReplication). ReplicateMs is the number to decide on:
+ * with ParallelGather 0 the same work happens inside the gather instead, so PrepareMs alone is always 0 there.
+ *
+ * Options: -RepGraphLoadConnections= -RepGraphLoadBots= -RepGraphLoadProjectiles= -RepGraphLoadWarmup= (seconds) -RepGraphLoadDuration= (seconds)
+ *			-RepGraphLoadViewerSpeed= -RepGraphLoadProjectileClass= -RepGraphLoadCsv= (defaults to Saved/Profiling/RepGraphLoad/)
+ *
+ * The game net driver must use UShooterReplicationGraph. DefaultEngine.ini only sets it for the Steam drivers, so without Steam add
+ *	-ini:Engine:[/Script/OnlineSubsystemUtils.IpNetDriver]:ReplicationDriverClassName=/Script/ShooterGame.ShooterReplicationGraph
+ */
+UCLASS()
+class UShooterTestControllerReplicationGraphLoad : public UShooterTestControllerBase
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnInit() override;
+	virtual void OnPostMapChange(UWorld* World) override;
+
+protected:
+	virtual void OnTick(float TimeDelta) override;
+
+	/** Adds NumConnections simulated connections, each with its own player controller */
+	void CreateSimulatedConnections(UWorld* World);
+
+	/** Spawns NumBots bots through the game mode */
+	void SpawnBots(UWorld* World);
+
+	/** Moves every simulated viewer along its patrol route */
+	void UpdateViewers(float TimeDelta);
+
+	/** Tops the number of live projectiles back up to NumProjectiles */
+	void UpdateProjectiles(UWorld* World);
+
+	/** Records one CSV row for the replication frame that just ran, if it has not been recorded yet */
+	void SampleReplicationFrame(UWorld* World);
+
+	/** Writes the report and ends the test */
+	void FinishTest();
+
+	FVector GetPatrolLocation(float Distance) const;
+
+	/** Times the actor tick part of every world tick */
+	void OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+private:
+	// Options
+	int32 NumConnections;
+	int32 NumBots;
+	int32 NumProjectiles;
+	float WarmupTime;
+	float Duration;
+	float ViewerSpeed;
+	FString CsvFilename;
+
+	UPROPERTY()
+	UClass* ProjectileClass;
+
+	UPROPERTY()
+	TArray<UNetConnection*> SimulatedConnections;
+
+	UPROPERTY()
+	TArray<APlayerController*> SimulatedControllers;
+
+	/** Distance travelled along the patrol route, per simulated viewer */
+	TArray<float> ViewerDistances;
+
+	/** OutTotalBytes of each simulated connection at the last sample */
+	TArray<int32> LastOutTotalBytes;
+
+	/** Closed loop through all player starts that the viewers patrol */
+	TArray<FVector> PatrolPoints;
+	float PatrolLength;
+
+	TWeakObjectPtr<UWorld> LoadWorld;
+	double MapLoadTime;
+	bool bLoadStarted;
+	bool bLoadFinished;
+	double LoadStartTime;
+	uint32 LastSampledFrame;
+
+	TArray<FString> CsvRows;
+
+	/** Per frame ServerReplicateActors times, for the summary */
+	TArray<float> ReplicateTimesMs;
+	int64 TotalActorsReplicated;
+	int64 TotalBytesSent;
+
+	FDelegateHandle OnWorldTickStartHandle;
+	FDelegateHandle OnWorldPostActorTickHandle;
+	double WorldTickStartTime;
+	float LastActorTickMs;
+	double TotalActorTickMs;
+};
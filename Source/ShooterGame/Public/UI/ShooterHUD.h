@@ -58,6 +58,32 @@ struct FDeathMessage
 	}
 };
 
+/** HUD text that is only reformatted and measured again when the value it shows changes. */
+struct FShooterHUDText
+{
+	/** Text to draw. */
+	FText Text;
+
+	/** Unscaled size of the text in the HUD's big font. */
+	float SizeX;
+	float SizeY;
+
+	/** Value the text was built for. */
+	int64 Key;
+
+	/** Has the text been built yet? */
+	bool bValid;
+
+	/** Initialise defaults. */
+	FShooterHUDText()
+		: SizeX(0.f)
+		, SizeY(0.f)
+		, Key(0)
+		, bValid(false)
+	{
+	}
+};
+
 UCLASS()
 class AShooterHUD : public AHUD
 {
@@ -111,6 +137,16 @@ public:
 	 */
 	bool ShowScoreboard(bool bEnable, bool bFocus = false);
 
+	/** Shows or hides the performance overlay. */
+	void TogglePerfOverlay();
+
+	/**
+	 * Records the performance overlay stats of every frame for a while, then writes them to a CSV in Saved/Profiling/PerfCapture/.
+	 *
+	 * @param	Seconds	How long to record for.
+	 */
+	void StartPerfCapture(float Seconds);
+
 	/** 
 	 * Add death message.
 	 *
@@ -254,6 +290,24 @@ protected:
 	UPROPERTY()
 	FCanvasIcon PlaceIcon;
 
+	/** Slow changing texts, only rebuilt when their value changes. */
+	FShooterHUDText MatchTimerText;
+	FShooterHUDText WarmupText;
+	FShooterHUDText PlaceText;
+	FShooterHUDText KillsLabelText;
+	FShooterHUDText KillsText;
+	FShooterHUDText PrimaryClipAmmoText;
+	FShooterHUDText PrimarySpareAmmoText;
+	FShooterHUDText SecondaryAmmoText;
+	FShooterHUDText TeleportCooldownText;
+	FShooterHUDText TimeRewindCooldownText;
+
+	/** Net mode, session and version description, rebuilt once a second. */
+	FString NetModeDesc;
+
+	/** When NetModeDesc was last rebuilt. */
+	float NetModeDescTime;
+
 	/** UI scaling factor for other resolutions than Full HD. */
 	float ScaleUI;
 
@@ -326,6 +380,9 @@ protected:
 	/** Chatbox widget. */
 	TSharedPtr<class SChatWidget> ChatWidget;
 
+	/** Performance overlay, created the first time it is shown or a capture starts. */
+	TSharedPtr<class FShooterPerfOverlay> PerfOverlay;
+
 	/** Array of information strings to render (Waiting to respawn etc) */
 	TArray<FCanvasTextItem> InfoItems;
 
@@ -377,6 +434,15 @@ protected:
 	 */
 	float DrawRecentlyKilledPlayer();
 
+	/**
+	 * Rebuilds Cached from MakeString and measures it with BigFont, only if Key changed since it was last built.
+	 *
+	 * @param Cached		The text to update.
+	 * @param Key			The value(s) the text shows.
+	 * @param MakeString	Formats the text, only called when Key changed.
+	 */
+	const FShooterHUDText& UpdateText(FShooterHUDText& Cached, int64 Key, TFunctionRef<FString()> MakeString);
+
 	/** Temporary helper for drawing text-in-a-box. */
 	void DrawDebugInfoString(const FString& Text, float PosX, float PosY, bool bAlignLeft, bool bAlignTop, const FColor& TextColor);
 
@@ -8,6 +8,9 @@
 
 class UProjectileMovementComponent;
 class USphereComponent;
+class AShooterExplosionEffect;
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnShooterProjectileExploded, AShooterProjectile*, const FHitResult& /* impact */);
 
 // 
 UCLASS(Abstract, Blueprintable)
@@ -25,6 +28,18 @@ class AShooterProjectile : public AActor
 	UFUNCTION()
 	void OnImpact(const FHitResult& HitResult);
 
+	/** did this projectile already explode? */
+	bool HasExploded() const { return bExploded; }
+
+	/** get explosion effect class */
+	TSubclassOf<AShooterExplosionEffect> GetExplosionTemplate() const { return ExplosionTemplate; }
+
+	/** spawn explosion effect at impact, shared by projectiles and explosion-only notifications */
+	static void SpawnExplosionEffect(UWorld* World, TSubclassOf<AShooterExplosionEffect> Template, const FHitResult& Impact);
+
+	/** [server] Global notification when a projectile explodes. Needed for replication graph. */
+	SHOOTERGAME_API static FOnShooterProjectileExploded NotifyExploded;
+
 private:
 	/** movement component */
 	UPROPERTY(VisibleDefaultsOnly, Category=Projectile)